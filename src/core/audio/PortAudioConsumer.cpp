@@ -10,6 +10,7 @@
 #include "audio/AudioQueue.h"           // for AudioQueue
 #include "audio/DeviceInfo.h"           // for DeviceInfo
 #include "control/settings/Settings.h"  // for Settings
+#include "util/Trace.h"                 // for setThreadName
 #include "util/safe_casts.h"            // for as_unsigned
 
 #include "AudioPlayer.h"  // for AudioPlayer
@@ -98,6 +99,8 @@ auto PortAudioConsumer::startPlaying() -> bool {
 
 auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBuffer, unsigned long framesPerBuffer,
                                      const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags statusFlags) -> int {
+    xoj::util::trace::setThreadName("PortAudio playback");  // Only locks on the first callback of the thread
+
     if (statusFlags) {
         g_warning("PortAudioConsumer: PortAudio reported a stream warning: %s", std::to_string(statusFlags).c_str());
     }
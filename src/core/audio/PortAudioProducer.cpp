@@ -10,6 +10,7 @@
 #include "audio/AudioQueue.h"           // for AudioQueue
 #include "audio/DeviceInfo.h"           // for DeviceInfo
 #include "control/settings/Settings.h"  // for Settings
+#include "util/Trace.h"                 // for setThreadName
 #include "util/safe_casts.h"            // for as_unsigned
 
 
@@ -91,6 +92,8 @@ auto PortAudioProducer::startRecording() -> bool {
 
 auto PortAudioProducer::recordCallback(const void* inputBuffer, void* /*outputBuffer*/, unsigned long framesPerBuffer,
                                        const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags statusFlags) -> int {
+    xoj::util::trace::setThreadName("PortAudio recording");  // Only locks on the first callback of the thread
+
     if (statusFlags) {
         g_message("PortAudioProducer: statusFlag: %s", std::to_string(statusFlags).c_str());
     }
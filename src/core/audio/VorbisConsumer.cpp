@@ -14,6 +14,7 @@
 
 #include "audio/AudioQueue.h"           // for AudioQueue
 #include "control/settings/Settings.h"  // for Settings
+#include "util/Trace.h"                 // for setThreadName
 
 #include "SNDFileCpp.h"  // for make_snd_file, xoj
 
@@ -40,6 +41,7 @@ auto VorbisConsumer::start(fs::path const& file) -> bool {
     }
 
     this->consumerThread = std::thread([this, sfFile = std::move(sfFile), channels = channels] {
+        xoj::util::trace::setThreadName("VorbisConsumer");
         auto lock{audioQueue.acquire_lock()};
         auto buffer_size{size_t(64 * channels)};
         std::vector<float> buffer;
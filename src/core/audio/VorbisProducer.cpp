@@ -13,6 +13,7 @@
 
 #include "audio/AudioQueue.h"  // for AudioQueue
 #include "audio/SNDFileCpp.h"  // for make_snd_file, xoj
+#include "util/Trace.h"        // for setThreadName
 
 using namespace xoj;
 
@@ -38,6 +39,7 @@ auto VorbisProducer::start(fs::path const& file, unsigned int timestamp) -> bool
     this->audioQueue.setAudioAttributes(sfInfo.samplerate, static_cast<unsigned int>(sfInfo.channels));
 
     this->producerThread = std::thread([this, sfInfo, sfFile = std::move(sfFile)] {
+        xoj::util::trace::setThreadName("VorbisProducer");
         sf_count_t numFrames{1};
         size_t const bufferSize{size_t(1024U) * size_t(sfInfo.channels)};
         std::vector<float> sampleBuffer(bufferSize);
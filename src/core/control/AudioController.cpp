@@ -1,11 +1,13 @@
 #include "AudioController.h"
 
-#include <array>   // for array
-#include <cstdio>  // for snprintf
-#include <ctime>   // for tm, localtime, time
-#include <string>  // for string, allocator
+#include <array>    // for array
+#include <cstdio>   // for snprintf
+#include <ctime>    // for tm, localtime, time
+#include <string>   // for string, allocator
+#include <utility>  // for move
 
-#include <glib.h>  // for g_get_monotonic_time
+#include <gdk/gdk.h>  // for gdk_threads_add_idle
+#include <glib.h>     // for g_get_monotonic_time, g_source_remove
 
 #include "audio/AudioPlayer.h"                   // for AudioPlayer
 #include "audio/AudioRecorder.h"                 // for AudioRecorder
@@ -13,10 +15,13 @@
 #include "control/Control.h"                     // for Control
 #include "control/actions/ActionDatabase.h"      // for ActionDatabase
 #include "control/settings/Settings.h"           // for Settings
+#include "control/xojfile/AudioAttachments.h"    // for extract, isPending
 #include "gui/MainWindow.h"                      // for MainWindow
 #include "gui/toolbarMenubar/ToolMenuHandler.h"  // for ToolMenuHandler
+#include "util/Trace.h"                          // for setThreadName
 #include "util/XojMsgBox.h"                      // for XojMsgBox
-#include "util/i18n.h"                           // for _
+#include "util/glib_casts.h"                     // for wrap_for_once_v
+#include "util/i18n.h"                           // for _, _F, FS
 #include "util/safe_casts.h"                     // for as_signed
 
 using std::string;
@@ -28,7 +33,14 @@ AudioController::AudioController(Settings* settings, Control* control):
         audioRecorder(std::make_unique<AudioRecorder>(*settings)),
         audioPlayer(std::make_unique<AudioPlayer>(*control, *settings)) {}
 
-AudioController::~AudioController() = default;
+AudioController::~AudioController() {
+    if (this->extractionThread.joinable()) {
+        this->extractionThread.join();
+    }
+    if (this->extractionFinishedId) {
+        g_source_remove(this->extractionFinishedId);
+    }
+}
 
 
 auto AudioController::startRecording() -> bool {
@@ -82,6 +94,17 @@ auto AudioController::isPlaying() -> bool { return this->audioPlayer->isPlaying(
 
 auto AudioController::startPlayback(fs::path const& file, unsigned int timestamp) -> bool {
     this->audioPlayer->stop();
+    this->pendingPlayback.reset();
+
+    if (AudioAttachments::isPending(file)) {
+        this->pendingPlayback = Playback{file, timestamp};
+        if (!this->extractionThread.joinable()) {
+            extractInBackground(file);
+        }
+        // Otherwise started once the running extraction is finished
+        return true;
+    }
+
     bool status = this->audioPlayer->start(file, timestamp);
     if (status) {
         auto* actionDB = this->control.getActionDatabase();
@@ -109,7 +132,36 @@ void AudioController::continuePlayback() {
     this->audioPlayer->play();
 }
 
-void AudioController::stopPlayback() { this->audioPlayer->stop(); }
+void AudioController::stopPlayback() {
+    this->pendingPlayback.reset();
+    this->audioPlayer->stop();
+}
+
+void AudioController::extractInBackground(fs::path const& file) {
+    this->extractedFile = file;
+    this->extractionThread = std::thread([this, file] {
+        xoj::util::trace::setThreadName("AudioAttachments");
+        AudioAttachments::extract(file);
+        this->extractionFinishedId = gdk_threads_add_idle(xoj::util::wrap_for_once_v<extractionFinished>, this);
+    });
+}
+
+auto AudioController::extractionFinished(AudioController* self) -> bool {
+    // The thread is done once it added this callback
+    self->extractionThread.join();
+    self->extractionFinishedId = 0;
+
+    if (auto playback = std::move(self->pendingPlayback)) {
+        self->pendingPlayback.reset();
+        if (playback->file == self->extractedFile && AudioAttachments::isPending(playback->file)) {
+            string msg = FS(_F("Could not extract the audio attachment \"{1}\"") % playback->file.u8string());
+            XojMsgBox::showErrorToUser(self->control.getGtkWindow(), msg);
+        } else {
+            self->startPlayback(playback->file, playback->timestamp);
+        }
+    }
+    return false;  // do not call again
+}
 
 auto AudioController::getAudioFilename() const -> fs::path const& { return this->audioFilename; }
 
@@ -11,9 +11,11 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <memory>   // for make_unique, unique_ptr
-#include <vector>   // for vector
+#include <cstddef>   // for size_t
+#include <memory>    // for make_unique, unique_ptr
+#include <optional>  // for optional
+#include <thread>    // for thread
+#include <vector>    // for vector
 
 #include <portaudiocpp/PortAudioCpp.hxx>  // for AutoSystem
 
@@ -49,6 +51,13 @@ public:
     std::vector<DeviceInfo> getOutputDevices() const;
     std::vector<DeviceInfo> getInputDevices() const;
 
+private:
+    /**
+     * Extract a pending audio attachment without blocking the UI, the playback starts once it is extracted
+     */
+    void extractInBackground(fs::path const& file);
+    static bool extractionFinished(AudioController* self);
+
 private:
     Settings& settings;
     Control& control;
@@ -63,4 +72,16 @@ private:
 
     fs::path audioFilename;
     size_t timestamp = 0;
+
+    struct Playback {
+        fs::path file;
+        unsigned int timestamp;
+    };
+    /**
+     * The latest playback request, waiting for its attachment to be extracted
+     */
+    std::optional<Playback> pendingPlayback;
+    fs::path extractedFile;
+    std::thread extractionThread;
+    unsigned int extractionFinishedId = 0;
 };
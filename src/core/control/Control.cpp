@@ -1,9 +1,9 @@
 #include "Control.h"
 
-#include <algorithm>  // for max
+#include <algorithm>  // for max, find
 #include <cstdlib>    // for size_t
 #include <exception>  // for exce...
-#include <iterator>   // for end
+#include <iterator>   // for end, next
 #include <locale>
 #include <memory>    // for make...
 #include <numeric>   // for accu...
@@ -16,8 +16,10 @@
 #include "control/CompassController.h"                           // for Comp...
 #include "control/RecentManager.h"                               // for Rece...
 #include "control/ScrollHandler.h"                               // for Scro...
+#include "control/SearchIndex.h"                                 // for Sear...
 #include "control/SetsquareController.h"                         // for Sets...
 #include "control/Tool.h"                                        // for Tool
+#include "control/ThumbnailCache.h"                              // for Thum...
 #include "control/ToolHandler.h"                                 // for Tool...
 #include "control/actions/ActionDatabase.h"                      // for Acti...
 #include "control/jobs/AutosaveJob.h"                            // for Auto...
@@ -25,6 +27,7 @@
 #include "control/jobs/CustomExportJob.h"                        // for Cust...
 #include "control/jobs/PdfExportJob.h"                           // for PdfE...
 #include "control/jobs/SaveJob.h"                                // for SaveJob
+#include "control/jobs/SearchIndexJob.h"                         // for Sear...
 #include "control/jobs/Scheduler.h"                              // for JOB_...
 #include "control/jobs/XournalScheduler.h"                       // for Xour...
 #include "control/layer/LayerController.h"                       // for Laye...
@@ -36,6 +39,7 @@
 #include "control/settings/SettingsEnums.h"                      // for Button
 #include "control/settings/ViewModes.h"                          // for ViewM..
 #include "control/tools/TextEditor.h"                            // for Text...
+#include "control/xojfile/AutosaveJournal.h"                     // for Auto...
 #include "control/xojfile/LoadHandler.h"                         // for Load...
 #include "control/zoom/ZoomControl.h"                            // for Zoom...
 #include "gui/MainWindow.h"                                      // for Main...
@@ -116,6 +120,8 @@ using std::string;
 Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool disableAudio): gtkApp(gtkApp) {
     this->undoRedo = new UndoRedoHandler(this);
     this->undoRedo->addUndoRedoListener(this);
+    this->autosaveJournal = std::make_unique<AutosaveJournal>();
+    this->undoRedo->addUndoRedoListener(this->autosaveJournal.get());
     this->isBlocking = false;
 
     this->gladeSearchPath = gladeSearchPath;
@@ -136,6 +142,12 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
 
     this->scheduler = new XournalScheduler();
 
+    this->thumbnailCache = std::make_unique<ThumbnailCache>(
+            Util::getCacheSubfolder("thumbnails"),
+            static_cast<size_t>(std::max(this->settings->getThumbnailCacheSize(), 0)) * 1024 * 1024);
+
+    this->searchIndex = std::make_unique<SearchIndex>();
+
     this->doc = new Document(this);
 
     // for crashhandling
@@ -230,12 +242,14 @@ void Control::renameLastAutosaveFile() {
                             .c_str());
 
     if (!fs::exists(filename)) {
-        this->save(false);
+        // Called by the AutosaveJob, on the scheduler thread
+        Util::execInUiThread([this]() { this->save(false); });
     }
 
     std::vector<string> errors;
     try {
         Util::safeRenameFile(filename, renamed);
+        AutosaveJournal::moveJournal(filename, renamed);
     } catch (const fs::filesystem_error& e) {
         auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\": {3}");
         errors.emplace_back(FS(fmtstr % filename.u8string() % renamed.u8string() % e.what()));
@@ -256,6 +270,7 @@ void Control::setLastAutosaveFile(fs::path newAutosaveFile) { this->lastAutosave
 
 void Control::deleteLastAutosaveFile(fs::path newAutosaveFile) {
     fs::remove(this->lastAutosaveFilename);
+    AutosaveJournal::moveJournal(this->lastAutosaveFilename, {});
     this->lastAutosaveFilename = std::move(newAutosaveFile);
 }
 
@@ -1549,6 +1564,9 @@ void Control::fileLoaded(int scrollToPage) {
     win->getXournal()->forceUpdatePagenumbers();
     getCursor()->updateCursor();
     updateDeletePageButton();
+    updateSearchIndex();
+    // The whole document was replaced, bypassing the undo/redo handler
+    this->autosaveJournal->requireSnapshot();
 }
 
 class MetadataCallbackData {
@@ -1656,15 +1674,20 @@ void Control::block(const string& name) {
     getCursor()->setCursorBusy(true);
     disableSidebarTmp(true);
 
+    showStatusbar(name);
+    this->isBlocking = true;
+}
+
+void Control::showStatusbar(const string& text) {
     this->statusbar = this->win->get("statusbar");
     this->lbState = GTK_LABEL(this->win->get("lbState"));
     this->pgState = GTK_PROGRESS_BAR(this->win->get("pgState"));
 
-    gtk_label_set_text(this->lbState, name.c_str());
+    gtk_label_set_text(this->lbState, text.c_str());
+    gtk_progress_bar_set_fraction(this->pgState, 0);
     gtk_widget_show(this->statusbar);
 
     this->maxState = 100;
-    this->isBlocking = true;
 }
 
 void Control::unblock() {
@@ -1677,12 +1700,75 @@ void Control::unblock() {
     getCursor()->setCursorBusy(false);
     disableSidebarTmp(false);
 
-    gtk_widget_hide(this->statusbar);
+    if (!this->backgroundTasks.empty()) {
+        gtk_label_set_text(this->lbState, this->backgroundTasks.back().c_str());
+    } else {
+        gtk_widget_hide(this->statusbar);
+    }
 
     this->isBlocking = false;
 }
 
-void Control::setMaximumState(size_t max) { this->maxState = max; }
+void Control::beginBackgroundTask(const string& name) {
+    this->backgroundTasks.push_back(name);
+    if (!this->isBlocking && this->win) {
+        showStatusbar(name);
+    }
+}
+
+void Control::endBackgroundTask(const string& name) {
+    auto it = std::find(this->backgroundTasks.rbegin(), this->backgroundTasks.rend(), name);
+    if (it != this->backgroundTasks.rend()) {
+        this->backgroundTasks.erase(std::next(it).base());
+    }
+
+    if (this->isBlocking || !this->statusbar) {
+        return;
+    }
+    if (this->backgroundTasks.empty()) {
+        gtk_widget_hide(this->statusbar);
+    } else {
+        gtk_label_set_text(this->lbState, this->backgroundTasks.back().c_str());
+    }
+}
+
+void Control::backgroundSaveFinished(SaveJob* job) {
+    if (job != this->runningSave) {
+        // Already finished by waitForBackgroundSave()
+        return;
+    }
+    this->runningSave = nullptr;
+    endBackgroundTask(_("Saving..."));
+
+    job->finish();
+    job->unref();
+
+    if (this->saveQueued) {
+        this->saveQueued = false;
+        save(false);
+    }
+}
+
+void Control::waitForBackgroundSave() {
+    if (!this->runningSave) {
+        return;
+    }
+    SaveJob* job = this->runningSave;
+    job->waitUntilWritten();
+
+    // The save queued meanwhile is run right away, instead of in the background
+    const bool queued = this->saveQueued;
+    this->saveQueued = false;
+    backgroundSaveFinished(job);
+    if (queued) {
+        save(true);
+    }
+}
+
+void Control::setMaximumState(size_t max) {
+    // Called from the jobs' threads: maxState is only accessed on the UI thread, where the states are applied in order
+    Util::execInUiThread([this, max]() { this->maxState = max; });
+}
 
 void Control::setCurrentState(size_t state) {
     Util::execInUiThread([=]() {
@@ -1695,6 +1781,16 @@ auto Control::save(bool synchron) -> bool {
     // clear selection before saving
     clearSelectionEndText();
 
+    if (this->runningSave) {
+        if (!synchron) {
+            // The document is saved again, with the changes made meanwhile, once the running save is finished
+            this->saveQueued = true;
+            return true;
+        }
+        this->saveQueued = false;
+        waitForBackgroundSave();
+    }
+
     this->doc->lock();
     fs::path filepath = this->doc->getFilepath();
     this->doc->unlock();
@@ -1705,18 +1801,21 @@ auto Control::save(bool synchron) -> bool {
         }
     }
 
+    // Without window, SaveJob::afterRun is not called
+    synchron = synchron || !this->win;
+
     auto* job = new SaveJob(this);
-    bool result = true;
-    if (synchron) {
-        result = job->save();
-        unblock();
-        this->resetSavedStatus();
-    } else {
-        this->scheduler->addJob(job, JOB_PRIORITY_URGENT);
+    if (!job->prepare() || synchron) {
+        job->save();
+        bool result = job->finish();
+        job->unref();
+        return result;
     }
-    job->unref();
 
-    return result;
+    this->runningSave = job;
+    beginBackgroundTask(_("Saving..."));
+    job->start();
+    return true;
 }
 
 auto Control::showSaveDialog() -> bool {
@@ -1889,12 +1988,12 @@ auto Control::saveAs() -> bool {
     return save();
 }
 
-void Control::resetSavedStatus() {
+void Control::resetSavedStatus(UndoRedoHandler::StateId savedState) {
     this->doc->lock();
     auto filepath = this->doc->getFilepath();
     this->doc->unlock();
 
-    this->undoRedo->documentSaved();
+    this->undoRedo->documentSaved(savedState);
     RecentManager::addRecentFileFilename(filepath);
     this->updateWindowTitle();
 }
@@ -1926,6 +2025,7 @@ void Control::quit(bool allowCancel) {
 auto Control::close(const bool allowDestroy, const bool allowCancel) -> bool {
     clearSelectionEndText();
     metadata->documentChanged();
+    waitForBackgroundSave();
 
     bool discard = false;
     const bool fileRemoved = !doc->getFilepath().empty() && !fs::exists(this->doc->getFilepath());
@@ -2337,6 +2437,24 @@ auto Control::getToolHandler() const -> ToolHandler* { return this->toolHandler;
 
 auto Control::getScheduler() const -> XournalScheduler* { return this->scheduler; }
 
+auto Control::getThumbnailCache() const -> ThumbnailCache* { return this->thumbnailCache.get(); }
+
+auto Control::getSearchIndex() const -> SearchIndex* { return this->searchIndex.get(); }
+
+auto Control::getAutosaveJournal() const -> AutosaveJournal* { return this->autosaveJournal.get(); }
+
+void Control::updateSearchIndex() {
+    this->doc->lock();
+    bool startJob = this->searchIndex->reset(this->doc->getPdfDocument());
+    this->doc->unlock();
+
+    if (startJob) {
+        auto* job = new SearchIndexJob(this->searchIndex.get(), this->scheduler);
+        this->scheduler->addJob(job, JOB_PRIORITY_NONE);
+        job->unref();
+    }
+}
+
 auto Control::getWindow() const -> MainWindow* { return this->win; }
 
 auto Control::getGtkWindow() const -> GtkWindow* { return GTK_WINDOW(this->win->getWindow()); }
@@ -31,7 +31,7 @@
 #include "model/DocumentListener.h"         // for DocumentListener
 #include "model/GeometryTool.h"             // for GeometryTool
 #include "model/PageRef.h"                  // for PageRef
-#include "undo/UndoRedoHandler.h"           // for UndoRedoHandler (ptr only)
+#include "undo/UndoRedoHandler.h"           // for UndoRedoHandler, UndoRedoHandler::StateId
 
 #include "ClipboardHandler.h"  // for ClipboardListener
 #include "ToolHandler.h"       // for ToolListener
@@ -62,12 +62,16 @@ class SearchBar;
 class Settings;
 class TextEditor;
 class XournalScheduler;
+class ThumbnailCache;
+class SearchIndex;
+class AutosaveJournal;
 class ZoomControl;
 class ToolMenuHandler;
 class XojFont;
 class XojPdfRectangle;
 class Callback;
 class ActionDatabase;
+class SaveJob;
 
 class Control:
         public ToolListener,
@@ -97,17 +101,29 @@ public:
     void quit(bool allowCancel = true);
 
     /**
-     * Save the current document.
+     * Save the current document. Must be called on the UI thread.
      *
-     * @param synchron Whether the save should be run synchronously or asynchronously.
+     * @param synchron Whether the save should be run synchronously or asynchronously. An asynchronous save writes a
+     * snapshot of the document in the background, while the document can be edited.
      */
     bool save(bool synchron = false);
     bool saveAs();
 
     /**
-     * Marks the current document as saved if it is currently marked as unsaved.
+     * Marks the current document as saved, as it was in the given undo state (see UndoRedoHandler::getCurrentState)
      */
-    void resetSavedStatus();
+    void resetSavedStatus(UndoRedoHandler::StateId savedState);
+
+    /**
+     * Called by SaveJob::afterRun once the save running in the background has written the file
+     */
+    void backgroundSaveFinished(SaveJob* job);
+
+    /**
+     * Block the UI until the save running in the background has written the file, then finish it and run the save
+     * requested meanwhile. The main loop is not run, so that no other event is handled in the meantime.
+     */
+    void waitForBackgroundSave();
 
     /**
      * Close the current document, prompting to save unsaved changes.
@@ -258,10 +274,30 @@ public:
     void disableSidebarTmp(bool disabled);
 
     XournalScheduler* getScheduler() const;
+    ThumbnailCache* getThumbnailCache() const;
+    SearchIndex* getSearchIndex() const;
+    AutosaveJournal* getAutosaveJournal() const;
+
+    /**
+     * Start indexing the text of the PDF background in the background, if it is not indexed yet
+     */
+    void updateSearchIndex();
 
     void block(const std::string& name);
     void unblock();
 
+    /**
+     * Show the name of a task running in the background in the status bar, without blocking the UI, until
+     * endBackgroundTask() is called with the same name. Must be called on the UI thread.
+     */
+    void beginBackgroundTask(const std::string& name);
+    void endBackgroundTask(const std::string& name);
+
+private:
+    void showStatusbar(const std::string& text);
+
+public:
+
     void renameLastAutosaveFile();
     void setLastAutosaveFile(fs::path newAutosaveFile);
     void deleteLastAutosaveFile(fs::path newAutosaveFile);
@@ -312,7 +348,7 @@ public:
     void undoRedoPageChanged(PageRef page) override;
 
 public:
-    // ProgressListener interface
+    // ProgressListener interface, may be called from any thread
     void setMaximumState(size_t max) override;
     void setCurrentState(size_t state) override;
 
@@ -448,9 +484,20 @@ private:
      */
     guint autosaveTimeout = 0;
     fs::path lastAutosaveFilename;
+    std::unique_ptr<AutosaveJournal> autosaveJournal;
 
     XournalScheduler* scheduler;
 
+    /**
+     * Persistent cache of the sidebar previews
+     */
+    std::unique_ptr<ThumbnailCache> thumbnailCache;
+
+    /**
+     * Text index of the PDF background, for searching
+     */
+    std::unique_ptr<SearchIndex> searchIndex;
+
     /**
      * State / Blocking attributes
      */
@@ -460,6 +507,17 @@ private:
     size_t maxState = 0;
     bool isBlocking;
 
+    /**
+     * The tasks running in the background, the status bar shows the last one
+     */
+    std::vector<std::string> backgroundTasks;
+
+    /**
+     * The save running in the background. Only one save runs at a time, a save requested meanwhile is queued.
+     */
+    SaveJob* runningSave = nullptr;
+    bool saveQueued = false;
+
     GladeSearchpath* gladeSearchPath;
 
     MetadataManager* metadata;
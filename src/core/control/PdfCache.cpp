@@ -1,6 +1,6 @@
 #include "PdfCache.h"
 
-#include <algorithm>  // for max
+#include <algorithm>  // for max, remove_if
 #include <cmath>      // for ceil, abs
 #include <cstdio>     // for size_t
 #include <memory>     // for shared_ptr, __shared_ptr_access
@@ -12,6 +12,7 @@
 #include "control/settings/Settings.h"  // for Settings
 #include "pdf/base/XojPdfDocument.h"    // for XojPdfDocument
 #include "util/Range.h"                 // for Range
+#include "util/Trace.h"                 // for XOJ_TRACE_SCOPE
 #include "util/i18n.h"                  // for _
 #include "util/safe_casts.h"            // for as_unsigned
 #include "view/Mask.h"                  // for Mask
@@ -19,47 +20,50 @@
 class PdfCacheEntry {
 public:
     /**
-     *   Cache [img], the result of rendering [popplerPage] with
+     *   Cache [img], the result of rendering the page [pdfPageNo] with
      * the given [zoom].
      *  A change in the document's zoom causes a change in the
      * quality of the PDF backgrounds (zoomed in => need a higher
      * quality rendering).
      *
-     * @param popplerPage
-     * @param buffer is the result of rendering popplerPage
+     * @param pdfPageNo
+     * @param buffer is the result of rendering the page
      */
-    PdfCacheEntry(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer):
-            popplerPage(std::move(popplerPage)), buffer(std::forward<xoj::view::Mask>(buffer)) {}
+    PdfCacheEntry(size_t pdfPageNo, xoj::view::Mask&& buffer):
+            pdfPageNo(pdfPageNo), buffer(std::forward<xoj::view::Mask>(buffer)) {}
 
     ~PdfCacheEntry() = default;
 
-    XojPdfPageSPtr popplerPage;
+    size_t pdfPageNo;
     xoj::view::Mask buffer;
 };
 
-PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings): pdfDocument(doc) { updateSettings(settings); }
+PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings): documentPool(doc, 1) { updateSettings(settings); }
 
 PdfCache::~PdfCache() = default;
 
 void PdfCache::setRefreshThreshold(double threshold) { this->zoomRefreshThreshold = threshold; }
 
 void PdfCache::setMaxSize(size_t newSize) {
+    std::lock_guard<std::mutex> lock(this->dataMutex);
     this->maxSize = newSize;
     if (this->data.size() > this->maxSize) {
         this->data.resize(this->maxSize);
     }
+    updateMemorySize();
 }
 
 void PdfCache::updateSettings(Settings* settings) {
     if (settings) {
         setMaxSize(as_unsigned(settings->getPdfPageCacheSize()));
         setRefreshThreshold(settings->getPDFPageRerenderThreshold());
+        this->documentPool.setSize(as_unsigned(std::max(settings->getPdfDocumentPoolSize(), 1)));
     }
 }
 
 auto PdfCache::lookup(size_t pdfPageNo) const -> const PdfCacheEntry* {
     for (auto& e: this->data) {
-        if (static_cast<size_t>(e->popplerPage->getPageId()) == pdfPageNo) {
+        if (e->pdfPageNo == pdfPageNo) {
             return e.get();
         }
     }
@@ -67,37 +71,51 @@ auto PdfCache::lookup(size_t pdfPageNo) const -> const PdfCacheEntry* {
     return nullptr;
 }
 
-auto PdfCache::cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer) -> const PdfCacheEntry* {
+auto PdfCache::cache(size_t pdfPageNo, xoj::view::Mask&& buffer) -> const PdfCacheEntry* {
+    // Another thread may have rendered the same page meanwhile
+    this->data.erase(std::remove_if(this->data.begin(), this->data.end(),
+                                    [pdfPageNo](auto& e) { return e->pdfPageNo == pdfPageNo; }),
+                     this->data.end());
+
     if (this->data.size() > this->maxSize) {
         this->data.resize(this->maxSize);
     }
 
-    this->data.emplace_front(
-            std::make_unique<PdfCacheEntry>(std::move(popplerPage), std::forward<xoj::view::Mask>(buffer)));
+    this->data.emplace_front(std::make_unique<PdfCacheEntry>(pdfPageNo, std::forward<xoj::view::Mask>(buffer)));
+    updateMemorySize();
 
     return this->data.front().get();
 }
 
 void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight) {
-    std::lock_guard<std::mutex> lock(this->renderMutex);
-
-    const PdfCacheEntry* cacheResult = lookup(pdfPageNo);
-
-    bool needsRefresh = cacheResult == nullptr;
-
-    if (!needsRefresh) {
-        double averagedZoom = (zoom + cacheResult->buffer.getZoom()) / 2.0;
-        double percentZoomChange = std::abs(cacheResult->buffer.getZoom() - zoom) * 100.0 / averagedZoom;
-
-        // If we do have a cached result, is its rendering quality
-        // acceptable for our current zoom?
-        needsRefresh = (zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold);
+    XOJ_TRACE_SCOPE("PdfCache::render", "render");
+
+    {
+        std::lock_guard<std::mutex> lock(this->dataMutex);
+
+        if (const PdfCacheEntry* cacheResult = lookup(pdfPageNo)) {
+            double averagedZoom = (zoom + cacheResult->buffer.getZoom()) / 2.0;
+            double percentZoomChange = std::abs(cacheResult->buffer.getZoom() - zoom) * 100.0 / averagedZoom;
+
+            // If we do have a cached result, is its rendering quality
+            // acceptable for our current zoom?
+            if (zoom <= 1.0 || percentZoomChange <= this->zoomRefreshThreshold) {
+                this->hits++;
+                cacheResult->buffer.paintTo(cr);
+                return;
+            }
+        }
     }
 
-    if (needsRefresh) {
-        double renderZoom = std::max(zoom, 1.0);
+    this->misses++;
+    double renderZoom = std::max(zoom, 1.0);
 
-        auto popplerPage = cacheResult ? cacheResult->popplerPage : pdfDocument.getPage(pdfPageNo);
+    // Render without holding the cache: meanwhile, other threads can paint cached pages or render other pages with
+    // other instances of the document.
+    xoj::view::Mask buffer;
+    {
+        auto document = this->documentPool.acquire();
+        auto popplerPage = document->getPage(pdfPageNo);
 
         if (!popplerPage) {
             g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
@@ -105,13 +123,29 @@ void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWid
             return;
         }
 
-        xoj::view::Mask buffer(cairo_get_target(cr), Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()),
-                               renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
+        buffer = xoj::view::Mask(cairo_get_target(cr), Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()),
+                                 renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
         popplerPage->render(buffer.get());
-        cacheResult = cache(popplerPage, std::move(buffer));
     }
 
-    cacheResult->buffer.paintTo(cr);
+    std::lock_guard<std::mutex> lock(this->dataMutex);
+    cache(pdfPageNo, std::move(buffer))->buffer.paintTo(cr);
+}
+
+auto PdfCache::getStats() const -> Stats {
+    Stats stats;
+    stats.hits = this->hits;
+    stats.misses = this->misses;
+    stats.memorySize = this->memorySize;
+    return stats;
+}
+
+void PdfCache::updateMemorySize() {
+    size_t size = 0;
+    for (auto& e: this->data) {
+        size += e->buffer.getMemorySize();
+    }
+    this->memorySize = size;
 }
 
 void PdfCache::renderMissingPdfPage(cairo_t* cr, double pageWidth, double pageHeight) {
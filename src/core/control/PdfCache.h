@@ -11,14 +11,15 @@
 
 #pragma once
 
+#include <atomic>   // for atomic
 #include <cstddef>  // for size_t
 #include <deque>    // for deque
 #include <mutex>    // for mutex
 
 #include <cairo.h>  // for cairo_t, cairo_surface_t
 
-#include "pdf/base/XojPdfDocument.h"  // for XojPdfDocument
-#include "pdf/base/XojPdfPage.h"      // for XojPdfPageSPtr
+#include "pdf/base/XojPdfDocument.h"      // for XojPdfDocument
+#include "pdf/base/XojPdfDocumentPool.h"  // for XojPdfDocumentPool
 
 namespace xoj::view {
 class Mask;
@@ -39,6 +40,9 @@ private:
 public:
     /**
      * @brief Render the page with number pdfPageNo of the pdf document to the cairo context
+     * Pages missing from the cache are rendered with a private instance of the document, never with the instance of
+     * the Document. Can be called from several threads: pages are then rendered concurrently, up to the number of
+     * instances set with the pdfDocumentPoolSize setting.
      * @param cr the cairo context
      * @param pdfPageNo The page number (in the pdf document)
      * @param zoom The current zoom level
@@ -60,6 +64,19 @@ public:
 
     void updateSettings(Settings* settings);
 
+    struct Stats {
+        /// Number of render calls served from the cache / which had to render the page, since the creation
+        size_t hits = 0;
+        size_t misses = 0;
+        /// Memory used by the cached pages, in bytes
+        size_t memorySize = 0;
+    };
+
+    /**
+     * Does not wait for a running render, so it can be called from the UI thread at any time
+     */
+    Stats getStats() const;
+
     /**
      * @brief Renders an error background, for when the pdf page cannot be rendered
      */
@@ -71,17 +88,26 @@ private:
      */
     const PdfCacheEntry* lookup(size_t pdfPageNo) const;
     /**
-     * @brief Push a cache entry
+     * @brief Push a cache entry, replacing any entry of the same page
      */
-    const PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer);
+    const PdfCacheEntry* cache(size_t pdfPageNo, xoj::view::Mask&& buffer);
+
+    void updateMemorySize();
 
 private:
-    XojPdfDocument pdfDocument;
+    XojPdfDocumentPool documentPool;
 
-    std::mutex renderMutex;
+    /**
+     * @brief Protects the cache entries. Not held while rendering.
+     */
+    std::mutex dataMutex;
 
     std::deque<std::unique_ptr<PdfCacheEntry>> data;
     decltype(data)::size_type maxSize = 0;
 
     double zoomRefreshThreshold;
+
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    std::atomic<size_t> memorySize{0};
 };
@@ -1,17 +1,20 @@
 #include "SearchControl.h"
 
-#include <memory>   // for __shared_ptr_access
-#include <utility>  // for move
+#include <memory>    // for __shared_ptr_access
+#include <optional>  // for optional
+#include <utility>   // for move
 
+#include "control/SearchIndex.h"             // for SearchIndex
 #include "model/Element.h"                   // for Element, ELEMENT_TEXT
 #include "model/Layer.h"                     // for Layer
 #include "model/Text.h"                      // for Text
 #include "model/XojPage.h"                   // for XojPage
 #include "view/overlays/SearchResultView.h"  // for SEARCH_CHANGED_NOTIFICATION
 
-SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf):
+SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index):
         page(page),
         pdf(std::move(pdf)),
+        index(index),
         viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::SearchResultView>>()) {}
 
 SearchControl::~SearchControl() = default;
@@ -33,7 +36,11 @@ auto SearchControl::search(const std::string& text, size_t index, size_t* occurr
         this->currentText = text;
 
         if (this->pdf) {
-            this->results = this->pdf->findText(text);
+            std::optional<std::vector<XojPdfRectangle>> indexed;
+            if (this->index) {
+                indexed = this->index->findInPdfPage(this->page->getPdfPageNr(), text);
+            }
+            this->results = indexed ? std::move(*indexed) : this->pdf->findText(text);
         }
 
         for (Layer* l: *this->page->getLayers()) {
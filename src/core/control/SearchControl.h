@@ -26,9 +26,14 @@ class Repaintable;
 class SearchResultView;
 };  // namespace xoj::view
 
+class SearchIndex;
+
 class SearchControl: public OverlayBase {
 public:
-    SearchControl(const PageRef& page, XojPdfPageSPtr pdf);
+    /**
+     * @param index Index of the PDF text, used instead of searching the PDF page if it is already indexed. May be null.
+     */
+    SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index);
     virtual ~SearchControl();
 
     bool search(const std::string& text, size_t index, size_t* occurrences, XojPdfRectangle* UpperMostMatch);
@@ -44,6 +49,7 @@ public:
 private:
     PageRef page;
     XojPdfPageSPtr pdf;
+    SearchIndex* index;
     std::string currentText;
     XojPdfRectangle* highlightRect = nullptr;
 
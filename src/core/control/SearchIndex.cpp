@@ -0,0 +1,269 @@
+#include "SearchIndex.h"
+
+#include <algorithm>  // for sort, unique, min, max, binary_search
+#include <utility>    // for move
+
+#include <glib.h>  // for g_utf8_next_char, g_utf8_strdown, g_free
+
+#include "model/Element.h"  // for Element, ELEMENT_TEXT
+#include "model/Layer.h"    // for Layer
+#include "model/Text.h"     // for Text
+#include "model/XojPage.h"  // for XojPage
+#include "util/Util.h"      // for npos
+
+namespace {
+auto trigramAt(const std::string& s, size_t pos) -> uint32_t {
+    return static_cast<uint32_t>(static_cast<unsigned char>(s[pos])) << 16 |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 1])) << 8 |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 2]));
+}
+
+auto isValid(const XojPdfRectangle& r) -> bool { return r.x1 <= r.x2 && r.y1 <= r.y2 && r.x2 > 0; }
+};  // namespace
+
+SearchIndex::SearchIndex() = default;
+
+SearchIndex::~SearchIndex() = default;
+
+auto SearchIndex::normalize(const std::string& text, std::vector<uint32_t>* charOfByte) -> std::string {
+    std::string result;
+    result.reserve(text.size());
+    if (charOfByte) {
+        charOfByte->clear();
+        charOfByte->reserve(text.size());
+    }
+
+    const char* end = text.data() + text.size();
+    uint32_t charIndex = 0;
+    for (const char* c = text.data(); c < end; charIndex++) {
+        const char* next = std::min(g_utf8_next_char(c), end);
+        size_t before = result.size();
+
+        if (static_cast<unsigned char>(*c) < 0x80) {
+            // Fast path for ASCII, which is most of the text in most documents
+            result += static_cast<char>(g_ascii_tolower(*c));
+        } else {
+            char* lower = g_utf8_strdown(c, next - c);
+            result += lower;
+            g_free(lower);
+        }
+
+        if (charOfByte) {
+            charOfByte->insert(charOfByte->end(), result.size() - before, charIndex);
+        }
+        c = next;
+    }
+
+    return result;
+}
+
+auto SearchIndex::createEntry(XojPdfPage::TextContent content) -> std::unique_ptr<PageEntry> {
+    auto entry = std::make_unique<PageEntry>();
+    entry->text = normalize(content.text, &entry->charOfByte);
+    entry->charBounds = std::move(content.charBounds);
+    return entry;
+}
+
+auto SearchIndex::reset(const XojPdfDocument& pdf) -> bool {
+    std::lock_guard lock(this->mutex);
+
+    XojPdfDocument newPdf = pdf;
+    if (this->pdf == newPdf && this->generation > 0) {
+        return false;
+    }
+
+    this->pdf = pdf;
+    this->pdfPool = pdf.isLoaded() ? std::make_shared<XojPdfDocumentPool>(pdf, 1) : nullptr;
+    this->generation++;
+    this->pages.clear();
+    this->pages.resize(pdf.isLoaded() ? pdf.getPageCount() : 0);
+    this->indexedPages = 0;
+    this->trigrams.clear();
+    this->lastQuery.clear();
+    this->lastQueryMatches.clear();
+
+    if (this->jobRunning || this->pages.empty()) {
+        return false;
+    }
+    this->jobRunning = true;
+    return true;
+}
+
+auto SearchIndex::indexPages(std::chrono::milliseconds budget) -> bool {
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+
+    for (;;) {
+        std::shared_ptr<XojPdfDocumentPool> pdfPool;
+        size_t generation = 0;
+        size_t pageNr = 0;
+        {
+            std::lock_guard lock(this->mutex);
+            if (this->indexedPages >= this->pages.size() || std::chrono::steady_clock::now() >= deadline) {
+                this->jobRunning = this->indexedPages < this->pages.size();
+                if (!this->jobRunning) {
+                    this->pdfPool.reset();
+                }
+                return !this->jobRunning;
+            }
+            pdfPool = this->pdfPool;
+            generation = this->generation;
+            pageNr = this->indexedPages;
+        }
+
+        // Extracting the text is the expensive part, do not block searches meanwhile
+        std::unique_ptr<PageEntry> entry;
+        {
+            auto pdf = pdfPool->acquire();
+            if (XojPdfPageSPtr page = pdf->getPage(pageNr)) {
+                entry = createEntry(page->getTextContent());
+            } else {
+                entry = std::make_unique<PageEntry>();
+            }
+        }
+
+        std::vector<uint32_t> pageTrigrams;
+        if (entry->text.size() >= 3) {
+            pageTrigrams.reserve(entry->text.size() - 2);
+            for (size_t i = 0; i + 3 <= entry->text.size(); i++) {
+                pageTrigrams.push_back(trigramAt(entry->text, i));
+            }
+            std::sort(pageTrigrams.begin(), pageTrigrams.end());
+            pageTrigrams.erase(std::unique(pageTrigrams.begin(), pageTrigrams.end()), pageTrigrams.end());
+        }
+
+        std::lock_guard lock(this->mutex);
+        if (generation != this->generation) {
+            // The document was replaced meanwhile
+            continue;
+        }
+        for (uint32_t t: pageTrigrams) {
+            this->trigrams[t].push_back(static_cast<uint32_t>(pageNr));
+        }
+        this->pages[pageNr] = std::move(entry);
+        this->indexedPages++;
+    }
+}
+
+auto SearchIndex::matchingPagesUnlocked(const std::string& query) -> const std::vector<bool>& {
+    if (query == this->lastQuery && this->lastQueryIndexedPages == this->indexedPages &&
+        this->lastQueryMatches.size() == this->pages.size()) {
+        return this->lastQueryMatches;
+    }
+
+    this->lastQuery = query;
+    this->lastQueryIndexedPages = this->indexedPages;
+    this->lastQueryMatches.assign(this->pages.size(), false);
+
+    auto verify = [&](size_t pageNr) {
+        const auto& entry = this->pages[pageNr];
+        this->lastQueryMatches[pageNr] = entry && entry->text.find(query) != std::string::npos;
+    };
+
+    if (query.size() < 3) {
+        for (size_t i = 0; i < this->indexedPages; i++) {
+            verify(i);
+        }
+        return this->lastQueryMatches;
+    }
+
+    // Collect the posting lists of all trigrams of the query, and only check the pages in all of them
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t i = 0; i + 3 <= query.size(); i++) {
+        auto it = this->trigrams.find(trigramAt(query, i));
+        if (it == this->trigrams.end()) {
+            return this->lastQueryMatches;
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](auto* a, auto* b) { return a->size() < b->size(); });
+
+    for (uint32_t pageNr: *lists.front()) {
+        bool candidate = std::all_of(lists.begin() + 1, lists.end(), [pageNr](auto* list) {
+            return std::binary_search(list->begin(), list->end(), pageNr);
+        });
+        if (candidate) {
+            verify(pageNr);
+        }
+    }
+
+    return this->lastQueryMatches;
+}
+
+auto SearchIndex::findInPdfPage(size_t pdfPage, const std::string& text)
+        -> std::optional<std::vector<XojPdfRectangle>> {
+    std::string query = normalize(text);
+
+    std::lock_guard lock(this->mutex);
+    if (pdfPage >= this->pages.size() || !this->pages[pdfPage]) {
+        return std::nullopt;
+    }
+
+    std::vector<XojPdfRectangle> results;
+    if (query.empty()) {
+        return results;
+    }
+
+    const PageEntry& entry = *this->pages[pdfPage];
+    for (size_t pos = entry.text.find(query); pos != std::string::npos; pos = entry.text.find(query, pos + 1)) {
+        size_t first = entry.charOfByte[pos];
+        size_t last = std::min(static_cast<size_t>(entry.charOfByte[pos + query.size() - 1]) + 1,
+                               entry.charBounds.size());
+
+        // One rectangle per line the match spans
+        std::optional<XojPdfRectangle> current;
+        for (size_t c = first; c < last; c++) {
+            const XojPdfRectangle& r = entry.charBounds[c];
+            if (!isValid(r)) {
+                continue;
+            }
+            double centerY = (r.y1 + r.y2) / 2;
+            if (current && (centerY < current->y1 || centerY > current->y2 || r.x1 < current->x1)) {
+                results.push_back(*current);
+                current.reset();
+            }
+            if (!current) {
+                current = r;
+            } else {
+                current->x1 = std::min(current->x1, r.x1);
+                current->y1 = std::min(current->y1, r.y1);
+                current->x2 = std::max(current->x2, r.x2);
+                current->y2 = std::max(current->y2, r.y2);
+            }
+        }
+        if (current) {
+            results.push_back(*current);
+        }
+    }
+
+    return results;
+}
+
+auto SearchIndex::mayContain(const PageRef& page, const std::string& text) -> bool {
+    std::string query = normalize(text);
+    if (query.empty()) {
+        return true;
+    }
+
+    for (Layer* l: *page->getLayers()) {
+        if (!l->isVisible()) {
+            continue;
+        }
+        for (Element* e: l->getElements()) {
+            if (e->getType() == ELEMENT_TEXT &&
+                normalize(dynamic_cast<Text*>(e)->getText()).find(query) != std::string::npos) {
+                return true;
+            }
+        }
+    }
+
+    size_t pdfPage = page->getPdfPageNr();
+    if (pdfPage == npos) {
+        return false;
+    }
+
+    std::lock_guard lock(this->mutex);
+    if (pdfPage >= this->pages.size() || !this->pages[pdfPage]) {
+        return true;
+    }
+    return matchingPagesUnlocked(query)[pdfPage];
+}
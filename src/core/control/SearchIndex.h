@@ -0,0 +1,135 @@
+/*
+ * Xournal++
+ *
+ * Full-text index of the PDF background, used by the search
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <chrono>         // for milliseconds
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint32_t
+#include <memory>         // for unique_ptr, shared_ptr
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "model/PageRef.h"                // for PageRef
+#include "pdf/base/XojPdfDocument.h"      // for XojPdfDocument
+#include "pdf/base/XojPdfDocumentPool.h"  // for XojPdfDocumentPool
+#include "pdf/base/XojPdfPage.h"          // for XojPdfRectangle
+
+/**
+ * @brief Index of the text of all pages of a PDF document.
+ *
+ * The text of each PDF page is extracted once, in the background (see SearchIndexJob), and kept case folded
+ * together with the bounding boxes of its characters. A trigram inverted index over all pages allows finding
+ * the pages containing a term without scanning the whole document.
+ *
+ * The index is keyed by PDF page number and is thus not affected by inserting, moving or deleting pages of the
+ * Xournal document. Typed texts change with every edit and are therefore not indexed, they are read directly
+ * from the model.
+ *
+ * All public methods are thread safe.
+ */
+class SearchIndex {
+public:
+    SearchIndex();
+    ~SearchIndex();
+
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+public:
+    /**
+     * @brief Drop the index and start indexing the given document, unless it is already the indexed one.
+     *
+     * @return true if the caller has to schedule a SearchIndexJob, false if none is needed or one is running
+     */
+    bool reset(const XojPdfDocument& pdf);
+
+    /**
+     * @brief Index the next pages of the document, until the time budget is exhausted.
+     * Called from the scheduler thread.
+     *
+     * @return true if all pages are indexed
+     */
+    bool indexPages(std::chrono::milliseconds budget);
+
+    /**
+     * @return The bounding boxes of all occurrences of text on the given PDF page,
+     *         or std::nullopt if the page is not indexed yet
+     */
+    std::optional<std::vector<XojPdfRectangle>> findInPdfPage(size_t pdfPage, const std::string& text);
+
+    /**
+     * @return false if the page contains no occurrence of text, neither in its PDF background nor in its typed texts.
+     *         true if it contains one or if the PDF page is not indexed yet.
+     */
+    bool mayContain(const PageRef& page, const std::string& text);
+
+    /**
+     * @brief Case fold a text the way the index does.
+     *
+     * @param charOfByte If not null, receives the index of the source character of each byte of the result
+     */
+    static std::string normalize(const std::string& text, std::vector<uint32_t>* charOfByte = nullptr);
+
+private:
+    struct PageEntry {
+        std::string text;
+        std::vector<uint32_t> charOfByte;
+        std::vector<XojPdfRectangle> charBounds;
+    };
+
+    static std::unique_ptr<PageEntry> createEntry(XojPdfPage::TextContent content);
+
+    /**
+     * @return For each PDF page, whether it is indexed and contains the (normalized) query. The caller must hold
+     *         the mutex.
+     */
+    const std::vector<bool>& matchingPagesUnlocked(const std::string& query);
+
+private:
+    std::mutex mutex;
+
+    XojPdfDocument pdf;
+
+    /**
+     * The text is extracted from a private instance of the document: the loaded one is used by the UI thread. Dropped
+     * once all pages are indexed.
+     */
+    std::shared_ptr<XojPdfDocumentPool> pdfPool;
+
+    /**
+     * Incremented on each reset, to drop pages extracted from a previous document
+     */
+    size_t generation = 0;
+
+    bool jobRunning = false;
+
+    /**
+     * Entries of all PDF pages, the first indexedPages are set
+     */
+    std::vector<std::unique_ptr<PageEntry>> pages;
+    size_t indexedPages = 0;
+
+    /**
+     * The pages containing each trigram (3 bytes of normalized text), in ascending order
+     */
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+
+    /**
+     * Result of the last query, searching goes through the pages one by one with the same text
+     */
+    std::string lastQuery;
+    size_t lastQueryIndexedPages = 0;
+    std::vector<bool> lastQueryMatches;
+};
@@ -0,0 +1,244 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>     // for sort
+#include <cstdint>       // for uint32_t
+#include <system_error>  // for error_code
+#include <utility>       // for move
+#include <vector>        // for vector
+
+#include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_read_pixels, ...
+#include <glib.h>                   // for GChecksum, g_checksum_new, ...
+
+#include "model/BackgroundImage.h"                // for BackgroundImage
+#include "model/Element.h"                        // for Element
+#include "model/Layer.h"                          // for Layer
+#include "model/PageType.h"                       // for PageType
+#include "model/XojPage.h"                        // for XojPage
+#include "util/safe_casts.h"                      // for as_signed
+#include "util/serializing/BinObjectEncoding.h"   // for BinObjectEncoding
+#include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
+
+namespace {
+/**
+ * Small helper appending plain values to a byte string
+ */
+class KeyWriter {
+public:
+    explicit KeyWriter(std::string& data): data(data) {}
+
+    void addData(const void* bytes, size_t len) { data.append(static_cast<const char*>(bytes), len); }
+
+    template <typename T>
+    void add(const T& value) {
+        addData(&value, sizeof(T));
+    }
+
+    void addString(const std::string& s) {
+        add(s.length());
+        addData(s.data(), s.length());
+    }
+
+private:
+    std::string& data;
+};
+};  // namespace
+
+ThumbnailCache::ThumbnailCache(fs::path folder, size_t maxSize): folder(std::move(folder)), maxSize(maxSize) {}
+
+ThumbnailCache::~ThumbnailCache() = default;
+
+auto ThumbnailCache::collectKeySource(XojPage& page, const std::string& pdfFingerprint, const std::string& variant,
+                                      int width, int height) -> KeySource {
+    KeySource source;
+    KeyWriter writer(source.data);
+
+    writer.addString(variant);
+    writer.add(width);
+    writer.add(height);
+
+    writer.add(page.getWidth());
+    writer.add(page.getHeight());
+
+    PageType bgType = page.getBackgroundType();
+    writer.add(bgType.format);
+    writer.addString(bgType.config);
+    writer.add(static_cast<uint32_t>(page.getBackgroundColor()));
+
+    if (bgType.isPdfPage()) {
+        writer.addString(pdfFingerprint);
+        writer.add(page.getPdfPageNr());
+    } else if (bgType.isImagePage()) {
+        // The file name of an attached background image is not unique, the pixels are hashed instead. The pixbuf is
+        // never modified, a reference is enough.
+        source.backgroundImage = xoj::util::GObjectSPtr<GdkPixbuf>(page.getBackgroundImage().getPixbuf(),
+                                                                   xoj::util::ref);
+    }
+
+    for (Layer* l: *page.getLayers()) {
+        writer.add(l->isVisible());
+
+        ObjectOutputStream out(new BinObjectEncoding());
+        for (Element* e: l->getElements()) {
+            e->serialize(out);
+        }
+
+        GString* str = out.getStr();
+        writer.add(str->len);
+        writer.addData(str->str, str->len);
+        g_string_free(str, true);
+    }
+
+    return source;
+}
+
+auto ThumbnailCache::computeKey(const KeySource& source) -> std::string {
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(source.data.data()), as_signed(source.data.size()));
+
+    if (GdkPixbuf* pixbuf = source.backgroundImage.get()) {
+        int size[2] = {gdk_pixbuf_get_width(pixbuf), gdk_pixbuf_get_height(pixbuf)};
+        g_checksum_update(checksum, reinterpret_cast<const guchar*>(size), sizeof(size));
+        g_checksum_update(checksum, gdk_pixbuf_read_pixels(pixbuf), as_signed(gdk_pixbuf_get_byte_length(pixbuf)));
+    }
+
+    std::string key = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return key;
+}
+
+auto ThumbnailCache::computeKey(XojPage& page, const std::string& pdfFingerprint, const std::string& variant,
+                                int width, int height) -> std::string {
+    return computeKey(collectKeySource(page, pdfFingerprint, variant, width, height));
+}
+
+auto ThumbnailCache::getEntryPath(const std::string& key) const -> fs::path { return folder / (key + ".png"); }
+
+auto ThumbnailCache::isEnabled() const -> bool { return this->maxSize > 0; }
+
+void ThumbnailCache::setMaxSize(size_t maxSize) {
+    std::lock_guard lock(this->mutex);
+    this->maxSize = maxSize;
+    if (this->scanned) {
+        evictUnlocked();
+    }
+}
+
+auto ThumbnailCache::lookup(const std::string& key, int width, int height) -> xoj::util::CairoSurfaceSPtr {
+    if (!isEnabled()) {
+        return nullptr;
+    }
+
+    fs::path path = getEntryPath(key);
+
+    std::lock_guard lock(this->mutex);
+
+    std::error_code ec;
+    if (!fs::is_regular_file(path, ec)) {
+        return nullptr;
+    }
+
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create_from_png(path.u8string().c_str()),
+                                        xoj::util::adopt);
+    if (cairo_surface_status(surface.get()) != CAIRO_STATUS_SUCCESS ||
+        cairo_image_surface_get_width(surface.get()) != width ||
+        cairo_image_surface_get_height(surface.get()) != height) {
+        g_warning("ThumbnailCache: dropping invalid entry %s", path.u8string().c_str());
+        if (this->scanned) {
+            this->currentSize -= std::min(this->currentSize, static_cast<size_t>(fs::file_size(path, ec)));
+        }
+        fs::remove(path, ec);
+        return nullptr;
+    }
+
+    // Mark the entry as recently used, eviction removes the oldest entries first
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    return surface;
+}
+
+void ThumbnailCache::store(const std::string& key, cairo_surface_t* surface) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    fs::path path = getEntryPath(key);
+    fs::path tmpPath = fs::path{path} += ".tmp";
+
+    std::lock_guard lock(this->mutex);
+    scanUnlocked();
+
+    // Write to a temporary file first, so that a concurrent instance never reads a partial image
+    if (cairo_surface_write_to_png(surface, tmpPath.u8string().c_str()) != CAIRO_STATUS_SUCCESS) {
+        g_warning("ThumbnailCache: could not write %s", tmpPath.u8string().c_str());
+        return;
+    }
+
+    std::error_code ec;
+    auto oldSize = fs::is_regular_file(path, ec) ? static_cast<size_t>(fs::file_size(path, ec)) : 0;
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        g_warning("ThumbnailCache: could not store %s: %s", path.u8string().c_str(), ec.message().c_str());
+        fs::remove(tmpPath, ec);
+        return;
+    }
+
+    this->currentSize -= std::min(this->currentSize, oldSize);
+    this->currentSize += static_cast<size_t>(fs::file_size(path, ec));
+
+    if (this->currentSize > this->maxSize) {
+        evictUnlocked();
+    }
+}
+
+void ThumbnailCache::scanUnlocked() {
+    if (this->scanned) {
+        return;
+    }
+
+    this->scanned = true;
+    this->currentSize = 0;
+
+    std::error_code ec;
+    for (auto const& f: fs::directory_iterator(this->folder, ec)) {
+        if (f.is_regular_file(ec)) {
+            this->currentSize += static_cast<size_t>(f.file_size(ec));
+        }
+    }
+}
+
+void ThumbnailCache::evictUnlocked() {
+    struct Entry {
+        fs::path path;
+        size_t size;
+        fs::file_time_type lastUse;
+    };
+    std::vector<Entry> entries;
+
+    std::error_code ec;
+    size_t totalSize = 0;
+    for (auto const& f: fs::directory_iterator(this->folder, ec)) {
+        if (!f.is_regular_file(ec)) {
+            continue;
+        }
+        Entry entry{f.path(), static_cast<size_t>(f.file_size(ec)), f.last_write_time(ec)};
+        totalSize += entry.size;
+        entries.emplace_back(std::move(entry));
+    }
+
+    // Evict down to 3/4 of the limit, so that we do not need to scan the folder again on the next store
+    const size_t targetSize = this->maxSize / 4 * 3;
+    if (totalSize > targetSize) {
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+        for (auto& e: entries) {
+            if (totalSize <= targetSize) {
+                break;
+            }
+            if (fs::remove(e.path, ec)) {
+                totalSize -= e.size;
+            }
+        }
+    }
+
+    this->currentSize = totalSize;
+}
@@ -0,0 +1,125 @@
+/*
+ * Xournal++
+ *
+ * Persistent on-disk cache of rendered page thumbnails
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <mutex>    // for mutex
+#include <string>   // for string
+
+#include <cairo.h>                  // for cairo_surface_t
+#include <gdk-pixbuf/gdk-pixbuf.h>  // for GdkPixbuf
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+#include "util/raii/GObjectSPtr.h"    // for GObjectSPtr
+
+#include "filesystem.h"  // for path
+
+class XojPage;
+
+/**
+ * @brief Content-addressed cache of rendered thumbnails, stored as PNG files in the user cache folder.
+ *
+ * An entry is identified by a hash of everything which influences the rendering of a page (size, background,
+ * elements, PDF document and page) together with the dimensions and the kind of the thumbnail. A modified page thus
+ * automatically maps to a new entry; stale entries are evicted (least recently used first) once the cache
+ * exceeds its size limit.
+ *
+ * All public methods are thread safe.
+ */
+class ThumbnailCache {
+public:
+    /**
+     * @param folder The folder the thumbnails are stored in
+     * @param maxSize The maximal size of the cache on disk, in bytes. 0 disables the cache.
+     */
+    ThumbnailCache(fs::path folder, size_t maxSize);
+    ~ThumbnailCache();
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+public:
+    /**
+     * What the key of a thumbnail is computed from: collected with the document locked, hashed without
+     */
+    struct KeySource {
+        std::string data;
+        xoj::util::GObjectSPtr<GdkPixbuf> backgroundImage;
+    };
+
+    /**
+     * @brief Collect what the key of a thumbnail depends on. The document must be locked by the caller.
+     *
+     * @param page The page to render
+     * @param pdfFingerprint Identifies the PDF background of the document, see Document::getPdfFingerprint
+     * @param variant Identifies what part of the page is rendered and how (e.g. the layer of a layer preview)
+     * @param width/height Size of the thumbnail in pixels
+     */
+    static KeySource collectKeySource(XojPage& page, const std::string& pdfFingerprint, const std::string& variant,
+                                      int width, int height);
+
+    /**
+     * @brief Compute the key of a thumbnail. The document does not need to be locked.
+     */
+    static std::string computeKey(const KeySource& source);
+
+    /**
+     * @brief Compute the key of a thumbnail at once. The document must be locked by the caller.
+     */
+    static std::string computeKey(XojPage& page, const std::string& pdfFingerprint, const std::string& variant,
+                                  int width, int height);
+
+    /**
+     * @brief Look up a thumbnail.
+     * @return The thumbnail or nullptr if the cache does not contain an image of the requested size for this key.
+     */
+    xoj::util::CairoSurfaceSPtr lookup(const std::string& key, int width, int height);
+
+    /**
+     * @brief Write a rendered thumbnail to the cache and evict old entries if the cache grows too big.
+     */
+    void store(const std::string& key, cairo_surface_t* surface);
+
+    /**
+     * @param maxSize The maximal size of the cache on disk, in bytes. 0 disables the cache.
+     */
+    void setMaxSize(size_t maxSize);
+
+    bool isEnabled() const;
+
+private:
+    fs::path getEntryPath(const std::string& key) const;
+
+    /**
+     * Compute the current size of the cache folder, on first use. The caller must hold the mutex.
+     */
+    void scanUnlocked();
+
+    /**
+     * Remove least recently used entries until the cache fits into its limit. The caller must hold the mutex.
+     */
+    void evictUnlocked();
+
+private:
+    fs::path folder;
+
+    std::mutex mutex;
+
+    std::atomic<size_t> maxSize;
+
+    /**
+     * The size of all entries on disk, valid if scanned is true
+     */
+    size_t currentSize = 0;
+    bool scanned = false;
+};
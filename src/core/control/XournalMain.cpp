@@ -14,6 +14,7 @@
 #include <sstream>    // for stringstream
 #include <stdexcept>  // for runtime_error
 #include <string>     // for string, basic_string
+#include <utility>    // for move
 #include <vector>     // for vector
 
 #include <gio/gio.h>      // for GApplication, G_APPLICATION
@@ -21,26 +22,31 @@
 #include <glib.h>         // for GOptionEntry, gchar, G_O...
 #include <libintl.h>      // for bindtextdomain, textdomain
 
-#include "control/RecentManager.h"           // for RecentManager
-#include "control/jobs/BaseExportJob.h"      // for ExportBackgroundType
-#include "control/jobs/XournalScheduler.h"   // for XournalScheduler
-#include "control/settings/LatexSettings.h"  // for LatexSettings
-#include "control/settings/Settings.h"       // for Settings
-#include "control/settings/SettingsEnums.h"  // for ICON_THEME_COLOR, ICON_T...
-#include "control/xojfile/LoadHandler.h"     // for LoadHandler
-#include "control/xojfile/SaveHandler.h"     // for SaveHandler
-#include "gui/GladeSearchpath.h"             // for GladeSearchpath
-#include "gui/MainWindow.h"                  // for MainWindow
-#include "gui/XournalView.h"                 // for XournalView
-#include "model/Document.h"                  // for Document
-#include "undo/EmergencySaveRestore.h"       // for EmergencySaveRestore
-#include "undo/UndoRedoHandler.h"            // for UndoRedoHandler
-#include "util/PathUtil.h"                   // for getConfigFolder, openFil...
-#include "util/PlaceholderString.h"          // for PlaceholderString
-#include "util/Stacktrace.h"                 // for Stacktrace
-#include "util/Util.h"                       // for execInUiThread
-#include "util/XojMsgBox.h"                  // for XojMsgBox
-#include "util/i18n.h"                       // for _, FS, _F
+#include "control/RecentManager.h"            // for RecentManager
+#include "control/jobs/BaseExportJob.h"       // for ExportBackgroundType
+#include "control/jobs/XournalScheduler.h"    // for XournalScheduler
+#include "control/settings/LatexSettings.h"   // for LatexSettings
+#include "control/settings/Settings.h"        // for Settings
+#include "control/settings/SettingsEnums.h"   // for ICON_THEME_COLOR, ICON_T...
+#include "control/xojfile/LoadHandler.h"      // for LoadHandler
+#include "control/xojfile/SaveHandler.h"      // for SaveHandler
+#include "gui/GladeSearchpath.h"              // for GladeSearchpath
+#include "gui/MainWindow.h"                   // for MainWindow
+#include "gui/XournalView.h"                  // for XournalView
+#include "gui/inputdevices/InputContext.h"    // for InputContext
+#include "gui/inputdevices/InputRecording.h"  // for InputRecorder
+#include "gui/inputdevices/InputReplay.h"     // for InputReplay
+#include "gui/widgets/XournalWidget.h"        // for GTK_XOURNAL
+#include "model/Document.h"                   // for Document
+#include "undo/EmergencySaveRestore.h"        // for EmergencySaveRestore
+#include "undo/UndoRedoHandler.h"             // for UndoRedoHandler
+#include "util/PathUtil.h"                    // for getConfigFolder, openFil...
+#include "util/PlaceholderString.h"           // for PlaceholderString
+#include "util/Stacktrace.h"                  // for Stacktrace
+#include "util/Trace.h"                       // for start, stop, setThreadName
+#include "util/Util.h"                        // for execInUiThread
+#include "util/XojMsgBox.h"                   // for XojMsgBox
+#include "util/i18n.h"                        // for _, FS, _F
 
 #include "Control.h"       // for Control
 #include "ExportHelper.h"  // for exportImg, exportPdf
@@ -348,6 +354,9 @@ struct XournalMainPrivate {
         g_free(pdfFilename);
         g_free(imgFilename);
         g_free(docFilename);
+        g_free(recordInputFilename);
+        g_free(replayInputFilename);
+        g_free(traceFilename);
     }
 
     gchar** optFilename{};
@@ -366,9 +375,13 @@ struct XournalMainPrivate {
     gboolean progressiveMode = false;
     gboolean disableAudio = false;
     gboolean attachMode = false;
+    gchar* recordInputFilename{};
+    gchar* replayInputFilename{};
+    gchar* traceFilename{};
     std::unique_ptr<GladeSearchpath> gladePath;
     std::unique_ptr<Control> control;
     std::unique_ptr<MainWindow> win;
+    std::unique_ptr<InputReplay> inputReplay;
 };
 using XMPtr = XournalMainPrivate*;
 
@@ -481,6 +494,39 @@ void on_open_files(GApplication* application, GFile** files, gint numFiles, gcha
     gtk_window_present(GTK_WINDOW(app_data->win->getWindow()));
 }
 
+/// Delay before replaying input, so the window is mapped and the pages are laid out
+constexpr guint INPUT_REPLAY_DELAY_MS = 1000;
+
+void startInputRecordingOrReplay(GApplication* application, XMPtr app_data) {
+    InputContext* input = GTK_XOURNAL(app_data->control->getWindow()->getXournal()->getWidget())->input;
+
+    if (app_data->recordInputFilename) {
+        auto recorder = std::make_unique<InputRecorder>(Util::fromGFilename(app_data->recordInputFilename, false));
+        if (recorder->isOpen()) {
+            input->setRecorder(std::move(recorder));
+        }
+    }
+
+    if (app_data->replayInputFilename) {
+        app_data->inputReplay = InputReplay::load(Util::fromGFilename(app_data->replayInputFilename, false), input);
+        if (!app_data->inputReplay) {
+            g_application_quit(application);
+            return;
+        }
+        g_timeout_add(
+                INPUT_REPLAY_DELAY_MS,
+                +[](gpointer data) -> gboolean {
+                    auto* app_data = static_cast<XMPtr>(data);
+                    app_data->inputReplay->start([app_data]() {
+                        std::cout << app_data->inputReplay->report();
+                        g_application_quit(g_application_get_default());
+                    });
+                    return G_SOURCE_REMOVE;
+                },
+                app_data);
+    }
+}
+
 void on_startup(GApplication* application, XMPtr app_data) {
     initLocalisation();
     ensure_input_model_compatibility();
@@ -599,10 +645,27 @@ void on_startup(GApplication* application, XMPtr app_data) {
     // This fixes it, see #405
     Util::execInUiThread([=]() { app_data->control->getWindow()->getXournal()->layoutPages(); });
     gtk_application_add_window(GTK_APPLICATION(application), GTK_WINDOW(app_data->win->getWindow()));
+
+    startInputRecordingOrReplay(application, app_data);
+}
+
+/// Start tracing if requested with --trace or the XOURNALPP_TRACE environment variable
+void startTracing(XMPtr app_data) {
+    fs::path file;
+    if (app_data->traceFilename) {
+        file = Util::fromGFilename(app_data->traceFilename, false);
+    } else if (const char* env = g_getenv(xoj::util::trace::ENV_VARIABLE); env && *env) {
+        file = fs::u8path(env);
+    } else {
+        return;
+    }
+    xoj::util::trace::setThreadName("UI");
+    xoj::util::trace::start(std::move(file));
 }
 
 auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gint {
     initCAndCoutLocales();
+    startTracing(app_data);
 
     auto print_version = [&] {
         if (!std::string(GIT_COMMIT_ID).empty()) {
@@ -701,6 +764,16 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        nullptr},
                           GOptionEntry{"save", 's', 0, G_OPTION_ARG_FILENAME, &app_data.docFilename,
                                        _("Save xopp-file with the background PDF specified as FILE"), "XOPPFILE"},
+                          GOptionEntry{"record-input", 0, 0, G_OPTION_ARG_FILENAME, &app_data.recordInputFilename,
+                                       _("Record the pen, mouse and touch input of this session to FILE"), "FILE"},
+                          GOptionEntry{"replay-input", 0, 0, G_OPTION_ARG_FILENAME, &app_data.replayInputFilename,
+                                       _("Replay the input recorded in FILE, print the input latency and quit"),
+                                       "FILE"},
+                          GOptionEntry{"trace", 0, 0, G_OPTION_ARG_FILENAME, &app_data.traceFilename,
+                                       _("Write timings of rendering, loading, saving and input handling to FILE\n"
+                                         "                                 "
+                                         "Open FILE in chrome://tracing or https://ui.perfetto.dev"),
+                                       "FILE"},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
@@ -762,5 +835,6 @@ auto XournalMain::run(int argc, char** argv) -> int {
 
     auto rv = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
+    xoj::util::trace::stop();
     return rv;
 }
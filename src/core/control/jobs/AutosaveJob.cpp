@@ -2,14 +2,14 @@
 
 #include <glib.h>  // for g_message, g_warning
 
-#include "control/Control.h"              // for Control
-#include "control/jobs/Job.h"             // for JOB_TYPE_AUTOSAVE, JobType
-#include "control/xojfile/SaveHandler.h"  // for SaveHandler
-#include "model/Document.h"               // for Document
-#include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
-#include "util/PathUtil.h"                // for clearExtensions, getAutosav...
-#include "util/XojMsgBox.h"               // for XojMsgBox
-#include "util/i18n.h"                    // for FS, _F
+#include "control/Control.h"                  // for Control
+#include "control/jobs/Job.h"                 // for JOB_TYPE_AUTOSAVE, JobType
+#include "control/xojfile/AutosaveJournal.h"  // for AutosaveJournal
+#include "model/Document.h"                   // for Document
+#include "undo/UndoRedoHandler.h"             // for UndoRedoHandler
+#include "util/PathUtil.h"                    // for clearExtensions, getAutosav...
+#include "util/XojMsgBox.h"                   // for XojMsgBox
+#include "util/i18n.h"                        // for FS, _F
 
 #include "filesystem.h"  // for path, u8path
 
@@ -23,16 +23,13 @@ void AutosaveJob::afterRun() {
 }
 
 void AutosaveJob::run() {
-    SaveHandler handler;
-
     control->getUndoRedoHandler()->documentAutosaved();
 
     Document* doc = control->getDocument();
+    AutosaveJournal* journal = control->getAutosaveJournal();
 
     doc->lock();
-    handler.prepareSave(doc);
     auto filepath = doc->getFilepath();
-    doc->unlock();
 
     if (filepath.empty()) {
         filepath = Util::getAutosaveFilepath();
@@ -42,13 +39,18 @@ void AutosaveJob::run() {
     Util::clearExtensions(filepath);
     filepath += ".autosave.xopp";
 
-    control->renameLastAutosaveFile();
-
-    g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
+    bool fullSnapshot = journal->prepare(doc, filepath);
+    doc->unlock();
 
-    handler.saveTo(filepath);
+    if (fullSnapshot) {
+        control->renameLastAutosaveFile();
+        g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
+    } else {
+        g_message("%s", FS(_F("Autosaving changed pages to {1}") % AutosaveJournal::getJournalPath(filepath).string())
+                                .c_str());
+    }
 
-    this->error = handler.getErrorMessage();
+    this->error = journal->write();
     if (!this->error.empty()) {
         callAfterRun();
     } else {
@@ -13,7 +13,22 @@
 
 #include <atomic>
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType {
+    JOB_TYPE_BLOCKING,
+    JOB_TYPE_PREVIEW,
+    JOB_TYPE_RENDER,
+    JOB_TYPE_RENDER_REFINE,
+    JOB_TYPE_RENDER_SELECTION,
+    JOB_TYPE_AUTOSAVE,
+    JOB_TYPE_SAVE,
+    JOB_TYPE_SEARCH_INDEX,
+    JOB_TYPE_PLUGIN,
+
+    /**
+     * The number of job types
+     */
+    JOB_N_TYPES
+};
 
 /**
  * A manually ref-counted class representing an asynchronous job to be used with
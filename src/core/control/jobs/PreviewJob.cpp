@@ -2,12 +2,14 @@
 
 #include <memory>  // for __s...
 #include <mutex>   // for mutex
+#include <string>  // for to_string, string
 #include <vector>  // for vector
 
 #include <glib-object.h>  // for g_o...
 #include <gtk/gtk.h>      // for Gtk...
 
 #include "control/Control.h"                                      // for Con...
+#include "control/ThumbnailCache.h"                               // for Thu...
 #include "control/jobs/Job.h"                                     // for JOB...
 #include "gui/Shadow.h"                                           // for Shadow
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"         // for Sid...
@@ -17,6 +19,7 @@
 #include "model/Layer.h"                                          // for Layer
 #include "model/PageRef.h"                                        // for Pag...
 #include "model/XojPage.h"                                        // for Xoj...
+#include "util/Trace.h"                                           // for XOJ...
 #include "util/Util.h"                                            // for exe...
 #include "view/DocumentView.h"                                    // for Doc...
 #include "view/LayerView.h"                                       // for Lay...
@@ -33,11 +36,49 @@ auto PreviewJob::getSource() -> void* { return this->sidebarPreview; }
 
 auto PreviewJob::getType() -> JobType { return JOB_TYPE_PREVIEW; }
 
-void PreviewJob::initGraphics() {
+void PreviewJob::computeSize() {
     GtkAllocation alloc;
     gtk_widget_get_allocation(this->sidebarPreview->widget, &alloc);
-    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+    width = alloc.width;
+    height = alloc.height;
     zoom = this->sidebarPreview->sidebar->getZoom();
+}
+
+auto PreviewJob::collectKeySource() -> ThumbnailCache::KeySource {
+    Layer::Index layer = 0;
+    PreviewRenderType type = this->sidebarPreview->getRenderType();
+    if (type != RENDER_TYPE_PAGE_PREVIEW) {
+        layer = (dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview))->getLayer();
+    }
+    std::string variant = "sidebar/" + std::to_string(type) + "/" + std::to_string(layer) + "/" + std::to_string(zoom);
+
+    Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
+    return ThumbnailCache::collectKeySource(*this->sidebarPreview->page, doc->getPdfFingerprint(), variant, width,
+                                            height);
+}
+
+auto PreviewJob::loadFromCache() -> bool {
+    ThumbnailCache* cache = this->sidebarPreview->sidebar->getControl()->getThumbnailCache();
+    auto surface = cache->lookup(cacheKey, width, height);
+    if (!surface) {
+        return false;
+    }
+
+    crBuffer = surface.release();
+    return true;
+}
+
+void PreviewJob::storeInCache() {
+    if (cacheKey.empty()) {
+        return;
+    }
+
+    cairo_surface_flush(crBuffer);
+    this->sidebarPreview->sidebar->getControl()->getThumbnailCache()->store(cacheKey, crBuffer);
+}
+
+void PreviewJob::initGraphics() {
+    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
     cr2 = cairo_create(crBuffer);
 }
 
@@ -69,14 +110,11 @@ void PreviewJob::finishPaint() {
 
 void PreviewJob::drawPage() {
     PageRef page = this->sidebarPreview->page;
-    Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
     DocumentView view;
     view.setPdfCache(this->sidebarPreview->sidebar->getCache());
     PreviewRenderType type = this->sidebarPreview->getRenderType();
     Layer::Index layer = 0;
 
-    doc->lock();
-
     // getLayer is not defined for page preview
     if (type != RENDER_TYPE_PAGE_PREVIEW) {
         layer = (dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview))->getLayer();
@@ -121,7 +159,6 @@ void PreviewJob::drawPage() {
     }
 
     cairo_destroy(cr2);
-    doc->unlock();
 }
 
 void PreviewJob::clipToPage() {
@@ -132,13 +169,46 @@ void PreviewJob::clipToPage() {
 }
 
 void PreviewJob::run() {
+    XOJ_TRACE_SCOPE("PreviewJob::run", "render");
+
     if (this->sidebarPreview == nullptr) {
         return;
     }
 
+    computeSize();
+
+    Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
+    const bool useCache = this->sidebarPreview->sidebar->getControl()->getThumbnailCache()->isEnabled();
+
+    if (useCache) {
+        // Only collecting the key source needs the document: hashing it and reading the thumbnail do not
+        doc->lock();
+        auto source = collectKeySource();
+        doc->unlock();
+
+        this->cacheKey = ThumbnailCache::computeKey(source);
+        if (loadFromCache()) {
+            finishPaint();
+            return;
+        }
+    }
+
+    ThumbnailCache::KeySource source;
+    doc->lock();
+    if (useCache) {
+        // The cache key must be computed from the same page contents we render
+        source = collectKeySource();
+    }
     initGraphics();
     drawBorder();
     clipToPage();
     drawPage();
+    doc->unlock();
+
+    if (useCache) {
+        this->cacheKey = ThumbnailCache::computeKey(source);
+        storeInCache();
+    }
+
     finishPaint();
 }
@@ -11,8 +11,12 @@
 
 #pragma once
 
+#include <string>  // for string
+
 #include <cairo.h>  // for cairo_surface_t, cairo_t
 
+#include "control/ThumbnailCache.h"  // for ThumbnailCache
+
 #include "Job.h"  // for Job, JobType
 
 class SidebarPreviewBaseEntry;
@@ -36,6 +40,16 @@ public:
     JobType getType() override;
 
 private:
+    void computeSize();
+    /**
+     * What the key of the preview in the ThumbnailCache depends on. The document must be locked.
+     */
+    ThumbnailCache::KeySource collectKeySource();
+    /**
+     * @return true if the preview was found in the ThumbnailCache
+     */
+    bool loadFromCache();
+    void storeInCache();
     void initGraphics();
     void clipToPage();
     void drawBorder();
@@ -58,6 +72,17 @@ private:
      */
     double zoom = 0;
 
+    /**
+     * Size of the buffer, in pixels
+     */
+    int width = 0;
+    int height = 0;
+
+    /**
+     * Key of the preview in the ThumbnailCache, empty if the cache is disabled
+     */
+    std::string cacheKey;
+
     /**
      * Sidebar preview
      */
@@ -16,7 +16,9 @@
 #include "model/Document.h"             // for Document
 #include "model/XojPage.h"              // for Page
 #include "util/Assert.h"                // for xoj_assert
+#include "util/Range.h"                 // for Range
 #include "util/Rectangle.h"             // for Rectangle
+#include "util/Trace.h"                 // for XOJ_TRACE_SCOPE
 #include "util/Util.h"                  // for execInUiThread
 #include "util/raii/CairoWrappers.h"    // for CairoSurfaceSPtr, CairoSPtr
 #include "util/safe_casts.h"            // for strict_cast, as_signed, as_si...
@@ -31,11 +33,26 @@
 
 using xoj::util::Rectangle;
 
-RenderJob::RenderJob(XojPageView* view): view(view) {}
+namespace {
+/**
+ * Resolution of the first pass of a progressive rerendering, relative to the full resolution
+ */
+constexpr double LOW_RES_FACTOR = 0.25;
+
+/**
+ * Pages with fewer pixels than this are rendered at full resolution at once
+ */
+constexpr double PROGRESSIVE_MIN_PIXELS = 1024. * 1024.;
+};  // namespace
+
+RenderJob::RenderJob(XojPageView* view, bool refinement, double viewportDistance):
+        view(view), refinement(refinement), viewportDistance(viewportDistance) {}
+
+auto RenderJob::getViewportDistance() const -> double { return this->viewportDistance; }
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
+void RenderJob::rerenderRange(const Range& range) {
     /**
      * Padding seems to be necessary to prevent artefacts of most strokes.
      * These artefacts are most pronounced when using the stroke deletion
@@ -44,7 +61,7 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
      **/
     constexpr int RENDER_PADDING = 1;
 
-    Range maskRange(rect);
+    Range maskRange = range;
     maskRange.addPadding(RENDER_PADDING);
     xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(), maskRange, view->xournal->getZoom(),
                             CAIRO_CONTENT_COLOR_ALPHA);
@@ -60,7 +77,40 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
     newMask.paintTo(view->buffer.get());
 }
 
+void RenderJob::renderPage(double renderZoom, double zoom) {
+    xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(),
+                            Range(0, 0, view->page->getWidth(), view->page->getHeight()), renderZoom,
+                            CAIRO_CONTENT_COLOR_ALPHA);
+
+    renderToBuffer(newMask.get());
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        std::swap(this->view->buffer, newMask);
+        this->view->renderedZoom = zoom;
+    }
+    repaintPage();
+}
+
+void RenderJob::refine() {
+    double zoom = view->xournal->getZoom();
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        if (!view->buffer.isInitialized() || view->buffer.getZoom() == zoom) {
+            // Deleted meanwhile, or already rendered at full resolution
+            return;
+        }
+    }
+    renderPage(zoom, zoom);
+}
+
 void RenderJob::run() {
+    XOJ_TRACE_SCOPE("RenderJob::run", "render");
+
+    if (this->refinement) {
+        refine();
+        return;
+    }
+
     this->view->repaintRectMutex.lock();
 
     bool rerenderComplete = this->view->rerenderComplete;
@@ -71,20 +121,30 @@ void RenderJob::run() {
     this->view->repaintRectMutex.unlock();
 
     if (rerenderComplete) {
-        xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(),
-                                Range(0, 0, view->page->getWidth(), view->page->getHeight()), view->xournal->getZoom(),
-                                CAIRO_CONTENT_COLOR_ALPHA);
+        double zoom = view->xournal->getZoom();
+        double dpiScaling = view->xournal->getDpiScaleFactor();
+        double pixels = view->page->getWidth() * view->page->getHeight() * zoom * zoom * dpiScaling * dpiScaling;
 
-        renderToBuffer(newMask.get());
+        bool outdated = false;
         {
             std::lock_guard lock(this->view->drawingMutex);
-            std::swap(this->view->buffer, newMask);
+            outdated = !view->buffer.isInitialized() || view->buffer.getZoom() != zoom;
         }
-        repaintPage();
+
+        // The full resolution pass follows as a refinement job, once the low resolution one is painted
+        bool progressive = outdated && pixels > PROGRESSIVE_MIN_PIXELS;
+        renderPage(progressive ? zoom * LOW_RES_FACTOR : zoom, zoom);
     } else {
+        // Requests for overlapping areas accumulate while the job is queued, render each area only once
+        std::vector<Range> dirty;
+        dirty.reserve(rerenderRects.size());
         for (Rectangle<double> const& rect: rerenderRects) {
-            rerenderRectangle(rect);
-            repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
+            dirty.emplace_back(rect);
+        }
+
+        for (const Range& range: Range::coalesce(dirty)) {
+            rerenderRange(range);
+            repaintPageArea(range.minX, range.minY, range.maxX, range.maxY);
         }
     }
 }
@@ -113,4 +173,4 @@ void RenderJob::renderToBuffer(cairo_t* cr) const {
     localView.drawPage(this->view->page, cr, false);
 }
 
-auto RenderJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+auto RenderJob::getType() -> JobType { return this->refinement ? JOB_TYPE_RENDER_REFINE : JOB_TYPE_RENDER; }
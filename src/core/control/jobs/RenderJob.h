@@ -16,15 +16,22 @@
 
 #include "Job.h"  // for Job, JobType
 
+class Range;
 class XojPageView;
-namespace xoj::util {
-template <class T>
-class Rectangle;
-}  // namespace xoj::util
 
+/**
+ * Rerendering a complete page is progressive: if the page is large and its buffer does not match the current zoom,
+ * a low resolution pass is rendered first, so that zooming gets a sharp enough result at once. The full resolution
+ * pass is then scheduled as a separate refinement job (see XournalScheduler::addRefineRenderPage), which the
+ * scheduler defers while zooming and runs in order of distance to the viewport center.
+ */
 class RenderJob: public Job {
 public:
-    RenderJob(XojPageView* view);
+    /**
+     * @param refinement Whether this job renders the full resolution pass after a low resolution one
+     * @param viewportDistance Distance between the page and the viewport center, orders the refinement jobs
+     */
+    RenderJob(XojPageView* view, bool refinement = false, double viewportDistance = 0);
 
 protected:
     ~RenderJob() override = default;
@@ -36,15 +43,31 @@ public:
 
     void run() override;
 
+    double getViewportDistance() const;
+
 private:
     void repaintPage() const;
 
     void repaintPageArea(double x1, double y1, double x2, double y2) const;
 
-    void rerenderRectangle(xoj::util::Rectangle<double> const& rect);
+    void rerenderRange(const Range& range);
+
+    /**
+     * @brief Render the complete page into a new buffer and show it
+     * @param renderZoom The resolution to render at
+     * @param zoom The zoom the buffer is rendered for
+     */
+    void renderPage(double renderZoom, double zoom);
+
+    /**
+     * @brief Replace the low resolution pass by the full resolution one, if it is still needed
+     */
+    void refine();
 
     void renderToBuffer(cairo_t* cr) const;
 
 private:
     XojPageView* view;
+    bool refinement;
+    double viewportDistance;
 };
@@ -1,44 +1,77 @@
 #include "SaveJob.h"
 
-#include <memory>  // for __shared_ptr_access
+#include <memory>        // for __shared_ptr_access
+#include <mutex>         // for lock_guard, unique_lock
+#include <string>        // for string
+#include <system_error>  // for error_code
+#include <thread>        // for thread
 
 #include <cairo.h>  // for cairo_create, cairo_destroy
 #include <glib.h>   // for g_warning, g_error
 
-#include "control/Control.h"              // for Control
-#include "control/jobs/BlockingJob.h"     // for BlockingJob
-#include "control/xojfile/SaveHandler.h"  // for SaveHandler
-#include "model/Document.h"               // for Document
-#include "model/PageRef.h"                // for PageRef
-#include "model/PageType.h"               // for PageType
-#include "model/XojPage.h"                // for XojPage
-#include "pdf/base/XojPdfPage.h"          // for XojPdfPageSPtr, XojPdfPage
-#include "util/PathUtil.h"                // for clearExtensions, safeRename...
-#include "util/XojMsgBox.h"               // for XojMsgBox
-#include "util/i18n.h"                    // for FS, _, _F
-#include "view/DocumentView.h"            // for DocumentView
+#include "control/Control.h"                   // for Control
+#include "control/ThumbnailCache.h"            // for ThumbnailCache
+#include "control/jobs/Job.h"                  // for JOB_TYPE_SAVE, JobType
+#include "control/settings/Settings.h"         // for Settings
+#include "control/xojfile/AudioAttachments.h"  // for extractAll
+#include "control/xojfile/SaveHandler.h"       // for SaveHandler
+#include "model/Document.h"                    // for Document
+#include "model/PageRef.h"                     // for PageRef
+#include "model/PageType.h"                    // for PageType
+#include "model/XojPage.h"                     // for XojPage
+#include "pdf/base/XojPdfPage.h"               // for XojPdfPageSPtr, XojPdfPage
+#include "undo/UndoRedoHandler.h"              // for UndoRedoHandler
+#include "util/PathUtil.h"                     // for clearExtensions, safeRename...
+#include "util/Trace.h"                        // for XOJ_TRACE_SCOPE, setThreadName
+#include "util/Util.h"                         // for execInUiThread
+#include "util/XojMsgBox.h"                    // for XojMsgBox
+#include "util/i18n.h"                         // for FS, _, _F
+#include "view/DocumentView.h"                 // for DocumentView
 
 #include "filesystem.h"  // for path, filesystem_error, remove
 
 
-SaveJob::SaveJob(Control* control): BlockingJob(control, _("Save")) {}
+SaveJob::SaveJob(Control* control): control(control) {}
 
-SaveJob::~SaveJob() = default;
+SaveJob::~SaveJob() {
+    if (this->writer.joinable()) {
+        this->writer.join();
+    }
+}
+
+void SaveJob::start() {
+    // Released once afterRun() was called
+    ref();
+    this->writer = std::thread([this] {
+        xoj::util::trace::setThreadName("SaveJob");
+        run();
+    });
+}
 
 void SaveJob::run() {
     save();
 
-    if (this->control->getWindow()) {
-        callAfterRun();
+    {
+        std::lock_guard lock{this->writtenMutex};
+        this->written = true;
     }
+    this->writtenCondition.notify_all();
+
+    Util::execInUiThread([this] {
+        // The thread is done once it added this callback
+        this->writer.join();
+        afterRun();
+        unref();
+    });
 }
 
-void SaveJob::afterRun() {
-    if (!this->lastError.empty()) {
-        XojMsgBox::showErrorToUser(control->getGtkWindow(), this->lastError);
-    } else {
-        this->control->resetSavedStatus();
-    }
+auto SaveJob::getType() -> JobType { return JOB_TYPE_SAVE; }
+
+void SaveJob::afterRun() { this->control->backgroundSaveFinished(this); }
+
+void SaveJob::waitUntilWritten() {
+    std::unique_lock lock{this->writtenMutex};
+    this->writtenCondition.wait(lock, [this] { return this->written; });
 }
 
 void SaveJob::updatePreview(Control* control) {
@@ -64,6 +97,25 @@ void SaveJob::updatePreview(Control* control) {
         width *= zoom;
         height *= zoom;
 
+        ThumbnailCache* cache = control->getThumbnailCache();
+        std::string cacheKey;
+        if (cache->isEnabled()) {
+            auto source = ThumbnailCache::collectKeySource(*page, doc->getPdfFingerprint(), "embedded",
+                                                           ceil_cast<int>(width), ceil_cast<int>(height));
+            // Hashing the page and reading the thumbnail do not need the document: do not block the renderers
+            // meanwhile. Only the UI thread modifies the document, the page does not change in between.
+            doc->unlock();
+            cacheKey = ThumbnailCache::computeKey(source);
+            auto cached = cache->lookup(cacheKey, ceil_cast<int>(width), ceil_cast<int>(height));
+            doc->lock();
+
+            if (cached) {
+                doc->setPreview(cached.get());
+                doc->unlock();
+                return;
+            }
+        }
+
         cairo_surface_t* crBuffer =
                 cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil_cast<int>(width), ceil_cast<int>(height));
 
@@ -84,64 +136,133 @@ void SaveJob::updatePreview(Control* control) {
         view.drawPage(page, cr, true /* don't render erasable */, true /* Don't rerender the pdf background */);
         cairo_destroy(cr);
         doc->setPreview(crBuffer);
+        doc->unlock();
+
+        if (!cacheKey.empty()) {
+            cairo_surface_flush(crBuffer);
+            cache->store(cacheKey, crBuffer);
+        }
         cairo_surface_destroy(crBuffer);
     } else {
         doc->setPreview(nullptr);
+        doc->unlock();
     }
-
-    doc->unlock();
 }
 
-auto SaveJob::save() -> bool {
+auto SaveJob::prepare() -> bool {
+    this->savedState = this->control->getUndoRedoHandler()->getCurrentState();
+
     updatePreview(control);
     Document* doc = this->control->getDocument();
-    SaveHandler h;
+    this->handler.setCompressionLevel(this->control->getSettings()->getSaveCompressionLevel());
 
+    // The XML tree holds copies of the elements: the document is not read anymore after this point
     doc->lock();
-    h.prepareSave(doc);
+    this->handler.prepareSave(doc);
     fs::path filepath = doc->getFilepath();
+    this->sourcePath = filepath;
+    this->createBackup = doc->shouldCreateBackupOnSave();
+    this->attachPdf = doc->isAttachPdf();
     doc->unlock();
 
     Util::clearExtensions(filepath, ".pdf");
-    auto const target = fs::path{filepath}.concat(".xopp");
-    auto const createBackup = doc->shouldCreateBackupOnSave();
+    this->target = fs::path{filepath}.concat(".xopp");
+
+    this->file = this->target;
+    if (this->attachPdf && !this->createBackup) {
+        // The attached PDF may be mapped from the target (see LoadHandler::readZipAttachmentBytes): it must not be
+        // truncated in place, so a new file is written and renamed over it
+        this->file.replace_filename(fs::u8path("." + this->target.filename().u8string() + ".tmp"));
+    }
+
+#ifdef _WIN32
+    // An archive kept open for its pending audio attachments cannot be renamed on Windows
+    if (this->createBackup) {
+        AudioAttachments::extractAll(this->target);
+    }
+#endif
 
-    if (createBackup) {
+    if (this->createBackup) {
         try {
             // Note: The backup must be created for the target as this is the filepath
             // which will be written to. Do not use the `filepath` variable!
-            Util::safeRenameFile(target, fs::path{target} += "~");
+            Util::safeRenameFile(this->target, fs::path{this->target} += "~");
         } catch (const fs::filesystem_error& fe) {
             g_warning("Could not create backup! Failed with %s", fe.what());
             this->lastError = FS(_F("Save file error, can't backup: {1}") % std::string(fe.what()));
-            if (!control->getWindow()) {
-                g_error("%s", this->lastError.c_str());
-            }
             return false;
         }
     }
+    return true;
+}
 
-    doc->lock();
-    h.saveTo(target, this->control);
-    doc->setFilepath(target);
-    doc->unlock();
+auto SaveJob::save() -> bool {
+    XOJ_TRACE_SCOPE("SaveJob::save", "io");
+    if (!this->lastError.empty()) {
+        return false;
+    }
+
+    // The audio attachments not played yet are still in the file which is about to be replaced. Their archive is
+    // still open, even if it was renamed to the backup.
+    AudioAttachments::extractAll(this->target);
 
-    if (!h.getErrorMessage().empty()) {
-        this->lastError = FS(_F("Save file error: {1}") % h.getErrorMessage());
+    this->handler.saveTo(this->file, this->target, this->control);
+
+    if (!this->handler.getErrorMessage().empty()) {
+        this->lastError = FS(_F("Save file error: {1}") % this->handler.getErrorMessage());
+        return false;
+    }
+    return true;
+}
+
+auto SaveJob::finish() -> bool {
+    if (this->file != this->target) {
+        std::error_code ec;
+        if (this->lastError.empty()) {
+            fs::rename(this->file, this->target, ec);
+            if (ec) {
+                this->lastError = FS(_F("Save file error: {1}") % ec.message());
+            }
+        }
+        if (!this->lastError.empty()) {
+            fs::remove(this->file, ec);
+            if (ec) {
+                g_warning("Could not remove %s: %s", this->file.u8string().c_str(), ec.message().c_str());
+            }
+        }
+    }
+
+    if (!this->lastError.empty()) {
         if (!control->getWindow()) {
             g_error("%s", this->lastError.c_str());
         }
+        XojMsgBox::showErrorToUser(control->getGtkWindow(), this->lastError);
         return false;
-    } else if (createBackup) {
+    }
+
+    if (this->createBackup) {
         try {
             // If a backup was created it can be removed now since no error occured during the save
-            fs::remove(fs::path{target} += "~");
+            fs::remove(fs::path{this->target} += "~");
         } catch (const fs::filesystem_error& fe) {
             g_warning("Could not delete backup! Failed with %s", fe.what());
         }
-    } else {
+    }
+
+    Document* doc = this->control->getDocument();
+    doc->lock();
+    if (doc->getFilepath() != this->sourcePath) {
+        // "Save As" was used while the file was written in the background: the document now belongs to the new path,
+        // which the queued save writes. It is neither renamed back nor marked as saved.
+        doc->unlock();
+        return true;
+    }
+    doc->setFilepath(this->target);
+    if (!this->createBackup) {
         doc->setCreateBackupOnSave(true);
     }
+    doc->unlock();
 
+    this->control->resetSavedStatus(this->savedState);
     return true;
 }
@@ -11,14 +11,26 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <condition_variable>  // for condition_variable
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <thread>              // for thread
 
-#include "BlockingJob.h"  // for BlockingJob
+#include "control/xojfile/SaveHandler.h"  // for SaveHandler
+#include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
 
-class Control;
+#include "Job.h"         // for Job, JobType
+#include "filesystem.h"  // for path
 
+class Control;
 
-class SaveJob: public BlockingJob {
+/**
+ * The document is saved in three steps: prepare() takes a snapshot of the document, save() writes the snapshot to
+ * the file and finish() updates the document. When the job is started in the background, the document can be edited
+ * while the file is written: save() does not touch the document or any other file, the other steps run on the UI
+ * thread. The file is written on a thread of its own, so that the jobs of the scheduler do not wait for it.
+ */
+class SaveJob: public Job {
 public:
     SaveJob(Control* control);
 
@@ -27,14 +39,62 @@ protected:
 
 public:
     void run() override;
+    JobType getType() override;
+
+    /**
+     * Run save() on a new thread, then afterRun() on the UI thread
+     */
+    void start();
+
+    /**
+     * Take the snapshot of the document, extract the audio attachments of the target and back it up. Must be called on
+     * the UI thread, before save() or running the job.
+     * @return false if the document cannot be saved, the error is shown by finish()
+     */
+    bool prepare();
 
+    /**
+     * Write the snapshot to the file
+     */
     bool save();
 
+    /**
+     * Block until save() has written the file, when the job was started in the background
+     */
+    void waitUntilWritten();
+
+    /**
+     * Update the document and mark it as saved, or show the error. Must be called on the UI thread, after save().
+     * @return true if the document was saved
+     */
+    bool finish();
+
     static void updatePreview(Control* control);
 
 protected:
     void afterRun() override;
 
 private:
+    Control* control;
+
+    SaveHandler handler;
+    /**
+     * The path of the document when prepare() was called, and the file written for it
+     */
+    fs::path sourcePath;
+    fs::path target;
+    /**
+     * The file written by save(): the target, or a temporary file renamed over the target by finish()
+     */
+    fs::path file;
+    bool createBackup = false;
+    bool attachPdf = false;
+    UndoRedoHandler::StateId savedState = 0;
+
     std::string lastError;
+
+    std::thread writer;
+    std::mutex writtenMutex;
+    std::condition_variable writtenCondition;
+    bool written = false;
 };
@@ -1,10 +1,13 @@
 #include "Scheduler.h"
 
+#include <algorithm>  // for max
+#include <chrono>     // for steady_clock, duration_cast
 #include <cinttypes>  // for PRId64
 #include <cstdint>    // for uint64_t
 
-#include "control/jobs/Job.h"  // for Job, JOB_TYPE_RENDER
+#include "control/jobs/Job.h"  // for Job, JOB_TYPE_RENDER_REFINE
 #include "util/Assert.h"       // for xoj_assert
+#include "util/Trace.h"        // for XOJ_TRACE_SCOPE, setThreadName
 #include "util/glib_casts.h"   // for wrap_for_once_v
 
 #include "config-debug.h"  // for DEBUG_SHEDULER
@@ -72,43 +75,109 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
 
         job->ref();
         this->jobQueue[priority]->push_back(job);
+        this->queuedJobs.emplace(JobKey{job->getSource(), job->getType()}, job);
     }
 
     SDEBUG("add job: %" PRId64 "; type: %" PRId64, (uint64_t)job, (uint64_t)job->getType());
     this->jobQueueCond.notify_all();
 }
 
-auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
-    Job* job = nullptr;
+auto Scheduler::getNextJobUnlocked(bool onlyNotRefine, bool* hasRefineJobs) -> Job* {
+    auto take = [this](Job* job) {
+        if (this->cancelledJobs.erase(job)) {
+            job->unref();
+            return false;
+        }
+
+        auto range = this->queuedJobs.equal_range(JobKey{job->getSource(), job->getType()});
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == job) {
+                this->queuedJobs.erase(it);
+                break;
+            }
+        }
+        return true;
+    };
 
     for (size_t i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
         std::deque<Job*>& queue = *this->jobQueue[i];
 
-        if (onlyNotRender) {
-            for (auto it = queue.begin(); it != queue.end(); ++it) {
-                job = *it;
+        if (onlyNotRefine) {
+            for (auto it = queue.begin(); it != queue.end();) {
+                Job* job = *it;
 
-                if (job->getType() != JOB_TYPE_RENDER) {
-                    queue.erase(it);
-                    return job;
+                if (this->cancelledJobs.count(job) || job->getType() != JOB_TYPE_RENDER_REFINE) {
+                    it = queue.erase(it);
+                    if (take(job)) {
+                        return job;
+                    }
+                    continue;
                 }
 
-                if (hasRenderJobs != nullptr) {
-                    *hasRenderJobs = true;
+                if (hasRefineJobs != nullptr) {
+                    *hasRefineJobs = true;
                 }
+                ++it;
             }
-        } else if (!queue.empty()) {
-            job = queue.front();
-            queue.pop_front();
-            xoj_assert(job != nullptr);
+        } else {
+            while (!queue.empty()) {
+                Job* job = queue.front();
+                queue.pop_front();
+                xoj_assert(job != nullptr);
 
-            return job;
+                if (take(job)) {
+                    return job;
+                }
+            }
         }
     }
 
     return nullptr;
 }
 
+auto Scheduler::hasJobUnlocked(void* source, JobType type) const -> bool {
+    return this->queuedJobs.count(JobKey{source, type}) > 0;
+}
+
+void Scheduler::cancelJobsUnlocked(void* source, JobType type) {
+    auto range = this->queuedJobs.equal_range(JobKey{source, type});
+    for (auto it = range.first; it != range.second; ++it) {
+        it->second->deleteJob();
+        this->cancelledJobs.insert(it->second);
+    }
+    this->queuedJobs.erase(range.first, range.second);
+}
+
+void Scheduler::cancelJobUnlocked(Job* job) {
+    auto range = this->queuedJobs.equal_range(JobKey{job->getSource(), job->getType()});
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == job) {
+            this->queuedJobs.erase(it);
+            job->deleteJob();
+            this->cancelledJobs.insert(job);
+            return;
+        }
+    }
+}
+
+auto Scheduler::takeStats() -> Stats {
+    Stats stats;
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        for (size_t i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
+            for (Job* job: *this->jobQueue[i]) {
+                stats.queued[i] += this->cancelledJobs.count(job) ? 0 : 1;
+            }
+        }
+    }
+    {
+        std::lock_guard lock{this->statsMutex};
+        stats.executed = this->executedJobs;
+        this->executedJobs = {};
+    }
+    return stats;
+}
+
 /**
  * Locks the complete scheduler
  */
@@ -166,7 +235,7 @@ auto g_time_val_diff(GTimeVal* t1, GTimeVal* t2) -> glong {
 }
 
 /**
- * If the Scheduler is blocking because we are zooming and there are only render jobs
+ * If the Scheduler is blocking because we are zooming and there are only refinement jobs
  * we need to wakeup it later
  */
 auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
@@ -184,12 +253,14 @@ auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
 }
 
 auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
+    xoj::util::trace::setThreadName(scheduler->name.c_str());
+
     while (scheduler->threadRunning) {
         // lock the whole scheduler
         std::unique_lock schedulerLock{scheduler->schedulerMutex};
         SDEBUG("Job Thread: Blocked scheduler.");
 
-        bool onlyNonRenderJobs = false;
+        bool onlyNonRefineJobs = false;
         glong diff = 1000;
         if (scheduler->blockRenderZoomTime) {
             std::lock_guard lock{scheduler->blockRenderMutex};
@@ -204,8 +275,8 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
                 scheduler->blockRenderZoomTime = nullptr;
                 SDEBUG("Ended zoom re-render blocking.");
             } else {
-                onlyNonRenderJobs = true;
-                SDEBUG("Rendering blocked: Only running non-rendering jobs.");
+                onlyNonRefineJobs = true;
+                SDEBUG("Refinement blocked: Only running non-refinement jobs.");
             }
         }
 
@@ -215,10 +286,10 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
             std::unique_lock jobLock{scheduler->jobQueueMutex};
             SDEBUG("Job Thread: Locked job queue.");
 
-            bool hasOnlyRenderJobs = false;
-            job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
+            bool hasOnlyRefineJobs = false;
+            job = scheduler->getNextJobUnlocked(onlyNonRefineJobs, &hasOnlyRefineJobs);
             if (job != nullptr) {
-                hasOnlyRenderJobs = false;
+                hasOnlyRefineJobs = false;
             }
 
             SDEBUG("get job: %" PRId64, (uint64_t)job);
@@ -227,7 +298,7 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
                 // unlock the whole scheduler
                 schedulerLock.unlock();
 
-                if (hasOnlyRenderJobs) {
+                if (hasOnlyRefineJobs) {
                     if (scheduler->jobRenderThreadTimerId) {
                         g_source_remove(scheduler->jobRenderThreadTimerId);
                     }
@@ -244,8 +315,21 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
         {
             std::lock_guard lock{scheduler->jobRunningMutex};
             SDEBUG("do job: %" PRId64, (uint64_t)job);
-            job->execute();
+            JobType type = job->getType();
+            auto start = std::chrono::steady_clock::now();
+            {
+                XOJ_TRACE_SCOPE("Job::execute", "scheduler");
+                job->execute();
+            }
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                  start);
             job->unref();
+
+            std::lock_guard statsLock{scheduler->statsMutex};
+            JobDurations& d = scheduler->executedJobs[type];
+            d.count++;
+            d.total += duration;
+            d.max = std::max(d.max, duration);
         }
 
         SDEBUG("next");
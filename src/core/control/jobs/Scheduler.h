@@ -14,14 +14,19 @@
 #pragma once
 
 #include <array>               // for array
+#include <chrono>              // for microseconds
 #include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
 #include <deque>               // for deque
+#include <functional>          // for hash
 #include <mutex>               // for mutex
 #include <string>              // for string
+#include <unordered_map>       // for unordered_multimap
+#include <unordered_set>       // for unordered_set
 
 #include <glib.h>  // for GThread, GTimeVal, gpointer
 
-class Job;
+#include "Job.h"  // for Job, JobType
 
 /**
  * @file Scheduler.h
@@ -93,7 +98,8 @@ public:
     void unlock();
 
     /**
-     * Don't render the next X ms so the scrolling performance is better
+     * Don't run full resolution refinement passes the next X ms so the zooming performance is better.
+     * The cheap low resolution passes still run at once.
      */
     void blockRerenderZoom();
 
@@ -102,12 +108,47 @@ public:
      */
     void unblockRerenderZoom();
 
+    struct JobDurations {
+        size_t count = 0;
+        std::chrono::microseconds total{};
+        std::chrono::microseconds max{};
+    };
+
+    struct Stats {
+        /// Number of queued jobs of each priority
+        std::array<size_t, JOB_N_PRIORITIES> queued{};
+
+        /// Run times of the jobs of each type executed since the last call of takeStats()
+        std::array<JobDurations, JOB_N_TYPES> executed{};
+    };
+
+    /**
+     * Get the current queue sizes and the run times of the jobs executed since the last call
+     */
+    Stats takeStats();
+
 private:
     static auto jobThreadCallback(Scheduler* scheduler) -> gpointer;
-    auto getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr) -> Job*;
+    auto getNextJobUnlocked(bool onlyNotRefine = false, bool* hasRefineJobs = nullptr) -> Job*;
 
     static auto jobRenderThreadTimer(Scheduler* scheduler) -> bool;
 
+protected:
+    /**
+     * @return true if a job of this source and type is queued. The caller must hold jobQueueMutex.
+     */
+    bool hasJobUnlocked(void* source, JobType type) const;
+
+    /**
+     * Remove the queued jobs of this source and type. The caller must hold jobQueueMutex.
+     */
+    void cancelJobsUnlocked(void* source, JobType type);
+
+    /**
+     * Remove a queued job. The caller must hold jobQueueMutex.
+     */
+    void cancelJobUnlocked(Job* job);
+
 protected:
     bool threadRunning = true;
 
@@ -141,6 +182,33 @@ protected:
      */
     std::array<std::deque<Job*>*, JOB_N_PRIORITIES> jobQueue{};
 
+    struct JobKey {
+        void* source;
+        JobType type;
+
+        bool operator==(const JobKey& other) const { return source == other.source && type == other.type; }
+    };
+
+    struct JobKeyHash {
+        size_t operator()(const JobKey& key) const {
+            return std::hash<void*>()(key.source) ^ (static_cast<size_t>(key.type) * 0x9e3779b9);
+        }
+    };
+
+    /**
+     * All queued jobs by source and type, so that finding or removing the jobs of a source does not need to scan
+     * the queues.
+     */
+    std::unordered_multimap<JobKey, Job*, JobKeyHash> queuedJobs{};
+
+    /**
+     * Jobs removed from the index which are still in a queue. They are dropped once they reach the front.
+     */
+    std::unordered_set<Job*> cancelledJobs{};
+
+    std::array<JobDurations, JOB_N_TYPES> executedJobs{};
+    std::mutex statsMutex{};
+
     GTimeVal* blockRenderZoomTime = nullptr;
     std::mutex blockRenderMutex{};
 
@@ -0,0 +1,28 @@
+#include "SearchIndexJob.h"
+
+#include <chrono>  // for milliseconds
+
+#include "control/SearchIndex.h"     // for SearchIndex
+#include "control/jobs/Job.h"        // for JOB_TYPE_SEARCH_INDEX, JobType
+#include "control/jobs/Scheduler.h"  // for Scheduler, JOB_PRIORITY_NONE
+
+/**
+ * Time spent indexing before giving other jobs a chance to run
+ */
+constexpr std::chrono::milliseconds CHUNK_DURATION{50};
+
+SearchIndexJob::SearchIndexJob(SearchIndex* index, Scheduler* scheduler): index(index), scheduler(scheduler) {}
+
+SearchIndexJob::~SearchIndexJob() = default;
+
+auto SearchIndexJob::getSource() -> void* { return this->index; }
+
+auto SearchIndexJob::getType() -> JobType { return JOB_TYPE_SEARCH_INDEX; }
+
+void SearchIndexJob::run() {
+    if (!this->index->indexPages(CHUNK_DURATION)) {
+        auto* job = new SearchIndexJob(this->index, this->scheduler);
+        this->scheduler->addJob(job, JOB_PRIORITY_NONE);
+        job->unref();
+    }
+}
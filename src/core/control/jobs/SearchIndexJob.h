@@ -0,0 +1,41 @@
+/*
+ * Xournal++
+ *
+ * Builds the search index in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "Job.h"  // for Job, JobType
+
+class SearchIndex;
+class Scheduler;
+
+/**
+ * @brief Indexes a chunk of PDF pages and schedules itself again until the whole document is indexed.
+ *
+ * Working in chunks keeps the scheduler responsive, rendering jobs queued meanwhile run in between.
+ */
+class SearchIndexJob: public Job {
+public:
+    SearchIndexJob(SearchIndex* index, Scheduler* scheduler);
+
+protected:
+    ~SearchIndexJob() override;
+
+public:
+    void* getSource() override;
+
+    void run() override;
+
+    JobType getType() override;
+
+private:
+    SearchIndex* index;
+    Scheduler* scheduler;
+};
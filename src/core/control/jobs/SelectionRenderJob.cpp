@@ -0,0 +1,82 @@
+#include "SelectionRenderJob.h"
+
+#include <memory>   // for make_unique, unique_ptr
+#include <utility>  // for exchange
+#include <vector>   // for vector
+
+#include "control/jobs/Job.h"                     // for JOB_TYPE_RENDER_SELECTION, JobType
+#include "control/tools/EditSelectionContents.h"  // for EditSelectionContents
+#include "model/Element.h"                        // for Element
+#include "model/ElementContainer.h"               // for ElementContainer
+#include "view/ElementContainerView.h"            // for ElementContainerView
+#include "view/View.h"                            // for Context
+
+namespace {
+/**
+ * Private copies of the selected elements
+ */
+class ClonedElements: public ElementContainer {
+public:
+    explicit ClonedElements(const std::vector<Element*>& source) {
+        owned.reserve(source.size());
+        elements.reserve(source.size());
+        for (const Element* e: source) {
+            elements.push_back(owned.emplace_back(e->clone()).get());
+        }
+    }
+
+    const std::vector<Element*>& getElements() const override { return elements; }
+
+private:
+    std::vector<std::unique_ptr<Element>> owned;
+    std::vector<Element*> elements;
+};
+};  // namespace
+
+SelectionRenderJob::SelectionRenderJob(EditSelectionContents* contents, int width, int height,
+                                       const cairo_matrix_t& transform):
+        contents(contents),
+        elements(std::make_unique<ClonedElements>(contents->getElements())),
+        width(width),
+        height(height),
+        transform(transform) {}
+
+SelectionRenderJob::~SelectionRenderJob() {
+    if (this->buffer) {
+        cairo_surface_destroy(this->buffer);
+    }
+}
+
+void SelectionRenderJob::onDelete() { this->deleted = true; }
+
+auto SelectionRenderJob::getSource() -> void* { return this->contents; }
+
+auto SelectionRenderJob::getType() -> JobType { return JOB_TYPE_RENDER_SELECTION; }
+
+auto SelectionRenderJob::render(const ElementContainer& elements, int width, int height,
+                                const cairo_matrix_t& transform) -> cairo_surface_t* {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    cairo_set_matrix(cr, &transform);
+
+    xoj::view::ElementContainerView view(&elements);
+    view.draw(xoj::view::Context::createDefault(cr));
+
+    cairo_destroy(cr);
+    return surface;
+}
+
+void SelectionRenderJob::run() {
+    if (this->deleted) {
+        return;
+    }
+
+    this->buffer = render(*this->elements, this->width, this->height, this->transform);
+    callAfterRun();
+}
+
+void SelectionRenderJob::afterRun() {
+    if (!this->deleted) {
+        this->contents->setRenderedBuffer(std::exchange(this->buffer, nullptr));
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Xournal++
+ *
+ * A job which renders the buffer of a selection
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>  // for atomic
+#include <memory>  // for unique_ptr
+
+#include <cairo.h>  // for cairo_surface_t, cairo_matrix_t
+
+#include "Job.h"  // for Job, JobType
+
+class ElementContainer;
+class EditSelectionContents;
+
+/**
+ * @brief Renders the elements of a large selection into an image surface, off the UI thread.
+ *
+ * The elements are cloned when the job is created, so that the selection can be edited meanwhile. The result is
+ * handed over to the selection from the UI thread, unless the job was deleted in between.
+ */
+class SelectionRenderJob: public Job {
+public:
+    /**
+     * @param width The width of the buffer, in pixels
+     * @param height The height of the buffer, in pixels
+     * @param transform The transformation from selection coordinates to buffer pixels
+     */
+    SelectionRenderJob(EditSelectionContents* contents, int width, int height, const cairo_matrix_t& transform);
+
+protected:
+    void onDelete() override;
+    ~SelectionRenderJob() override;
+
+public:
+    void* getSource() override;
+
+    void run() override;
+
+    JobType getType() override;
+
+    /**
+     * @brief Render elements into a new image surface
+     * @return The surface, owned by the caller
+     */
+    static cairo_surface_t* render(const ElementContainer& elements, int width, int height,
+                                   const cairo_matrix_t& transform);
+
+protected:
+    void afterRun() override;
+
+private:
+    EditSelectionContents* contents;
+
+    /**
+     * Set from the UI thread once the result is not wanted anymore
+     */
+    std::atomic<bool> deleted{false};
+
+    std::unique_ptr<ElementContainer> elements;
+    int width;
+    int height;
+    cairo_matrix_t transform;
+
+    cairo_surface_t* buffer = nullptr;
+};
@@ -1,9 +1,9 @@
 #include "XournalScheduler.h"
 
-#include <array>   // for array
-#include <deque>   // for _Deque_iterator, deque, operator!=
-#include <mutex>   // for lock_guard
-#include <string>  // for string
+#include <algorithm>  // for find_if
+#include <deque>      // for deque
+#include <mutex>      // for lock_guard
+#include <vector>     // for vector
 
 #include "control/jobs/Scheduler.h"  // for JOB_PRIORITY_URGENT, JOB_PRIORIT...
 
@@ -21,60 +21,37 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
     // Wait for running jobs to finish: Currently running jobs may still be
     //  using `preview`, and, as such, it is not completely removed.
     bool waitForTaskCompletion = true;
-    removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH, waitForTaskCompletion);
+    removeSource(preview, JOB_TYPE_PREVIEW, waitForTaskCompletion);
 }
 
-void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
+void XournalScheduler::removePage(XojPageView* view) {
+    removeSource(view, JOB_TYPE_RENDER_REFINE, false);
+    removeSource(view, JOB_TYPE_RENDER);
+}
 
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
 
-    for (size_t priority = JOB_PRIORITY_URGENT; priority < JOB_N_PRIORITIES; priority++) {
-        std::deque<Job*>& queue = *this->jobQueue[priority];
-        auto it = queue.begin();
-
-        while (it != queue.end()) {
-            Job* job = *it;
-
-            // Only remove PREVIEW and RENDER jobs; we aren't
-            // responsible for other types of jobs.
-            JobType type = job->getType();
-            if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER) {
-                job->deleteJob();
-
-                it = queue.erase(it);
-
-                job->unref();
-                job = nullptr;
-            } else {
-                ++it;
-            }
+    std::vector<Job*> jobs;
+    for (auto const& [key, job]: this->queuedJobs) {
+        // Only remove PREVIEW and RENDER jobs; we aren't
+        // responsible for other types of jobs.
+        if (key.type == JOB_TYPE_PREVIEW || key.type == JOB_TYPE_RENDER || key.type == JOB_TYPE_RENDER_REFINE) {
+            jobs.push_back(job);
         }
     }
+
+    for (Job* job: jobs) {
+        cancelJobUnlocked(job);
+    }
 }
 
 void XournalScheduler::finishTask() { std::lock_guard lock{this->jobRunningMutex}; }
 
-void XournalScheduler::removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask) {
+void XournalScheduler::removeSource(void* source, JobType type, bool awaitFinishTask) {
     {
         std::lock_guard lock{this->jobQueueMutex};
-        std::deque<Job*>& queue = *this->jobQueue[priority];
-
-        auto it = queue.begin();
-
-        while (it != queue.end()) {
-            Job* job = *it;
-
-            if (job->getType() == type && job->getSource() == source) {
-                it = queue.erase(it);
-
-                job->deleteJob();
-                job->unref();
-                job = nullptr;
-            } else {
-                ++it;
-            }
-        }
+        cancelJobsUnlocked(source, type);
     }
 
     // wait until the last job is done
@@ -84,22 +61,13 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
     }
 }
 
-auto XournalScheduler::existsSource(void* source, JobType type, JobPriority priority) -> bool {
-    bool exists = false;
+auto XournalScheduler::existsSource(void* source, JobType type) -> bool {
     std::lock_guard lock{this->jobQueueMutex};
-
-    for (Job* job: *this->jobQueue[priority]) {
-        if (job->getType() == type && job->getSource() == source) {
-            exists = true;
-            break;
-        }
-    }
-
-    return exists;
+    return hasJobUnlocked(source, type);
 }
 
 void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview) {
-    if (existsSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH)) {
+    if (existsSource(preview, JOB_TYPE_PREVIEW)) {
         return;
     }
 
@@ -109,7 +77,7 @@ void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview) {
 }
 
 void XournalScheduler::addRerenderPage(XojPageView* view) {
-    if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT)) {
+    if (existsSource(view, JOB_TYPE_RENDER)) {
         return;
     }
 
@@ -117,3 +85,39 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::addRefineRenderPage(XojPageView* view, double viewportDistance) {
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        if (hasJobUnlocked(view, JOB_TYPE_RENDER_REFINE)) {
+            return;
+        }
+
+        auto* job = new RenderJob(view, true, viewportDistance);
+        std::deque<Job*>& queue = *this->jobQueue[JOB_PRIORITY_URGENT];
+
+        // Sort the refinements by distance, the closest pages are refined first
+        auto pos = std::find_if(queue.begin(), queue.end(), [viewportDistance](Job* j) {
+            return j->getType() == JOB_TYPE_RENDER_REFINE &&
+                   static_cast<RenderJob*>(j)->getViewportDistance() > viewportDistance;
+        });
+        queue.insert(pos, job);
+        this->queuedJobs.emplace(JobKey{view, JOB_TYPE_RENDER_REFINE}, job);
+    }
+    this->jobQueueCond.notify_all();
+}
+
+void XournalScheduler::removeRefinements() {
+    std::lock_guard lock{this->jobQueueMutex};
+
+    std::vector<Job*> jobs;
+    for (auto const& [key, job]: this->queuedJobs) {
+        if (key.type == JOB_TYPE_RENDER_REFINE) {
+            jobs.push_back(job);
+        }
+    }
+
+    for (Job* job: jobs) {
+        cancelJobUnlocked(job);
+    }
+}
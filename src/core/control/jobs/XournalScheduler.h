@@ -41,6 +41,17 @@ public:
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
     void addRerenderPage(XojPageView* view);
 
+    /**
+     * Schedule the full resolution pass of a page only rendered at low resolution so far.
+     * Refinements are run in order of their distance to the viewport center.
+     */
+    void addRefineRenderPage(XojPageView* view, double viewportDistance);
+
+    /**
+     * Drop all scheduled refinements, they are outdated once the zoom changes again
+     */
+    void removeRefinements();
+
     /**
      * Blocks until all currently running Job%s have been executed
      */
@@ -50,9 +61,9 @@ private:
     /**
      * Remove source, e.g. if a page is removed they don't need to repaint
      */
-    void removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask = true);
+    void removeSource(void* source, JobType type, bool awaitFinishTask = true);
 
-    bool existsSource(void* source, JobType type, JobPriority priority);
+    bool existsSource(void* source, JobType type);
 
 private:
 };
@@ -1,6 +1,6 @@
 #include "Settings.h"
 
-#include <algorithm>    // for max
+#include <algorithm>    // for max, clamp
 #include <cstdint>      // for uint32_t, int32_t
 #include <cstdio>       // for sscanf, size_t
 #include <cstdlib>      // for atoi
@@ -183,9 +183,14 @@ void Settings::loadDefault() {
 
     this->pageRerenderThreshold = 5.0;
     this->pdfPageCacheSize = 10;
+    this->pdfDocumentPoolSize = 1;
+    this->saveCompressionLevel = 6;
+    this->thumbnailCacheSize = 64;
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
+    this->performanceOverlay = false;
+    this->performanceLog = false;
 
     this->selectionBorderColor = Colors::red;
     this->selectionMarkerColor = Colors::xopp_cornflowerblue;
@@ -235,6 +240,7 @@ void Settings::loadDefault() {
     this->stabilizerDrag = 0.4;
     this->stabilizerMass = 5.0;
     this->stabilizerFinalizeStroke = true;
+    this->strokePredictionTime = 0;
     /**/
 
     this->useSpacesForTab = false;
@@ -510,12 +516,23 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheSize")) == 0) {
         this->pdfPageCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfDocumentPoolSize")) == 0) {
+        this->pdfDocumentPoolSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveCompressionLevel")) == 0) {
+        this->saveCompressionLevel =
+                std::clamp(static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10)), 0, 9);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("thumbnailCacheSize")) == 0) {
+        this->thumbnailCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesBefore")) == 0) {
         this->preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesAfter")) == 0) {
         this->preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eagerPageCleanup")) == 0) {
         this->eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("performanceOverlay")) == 0) {
+        this->performanceOverlay = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("performanceLog")) == 0) {
+        this->performanceLog = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionBorderColor")) == 0) {
         this->selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionMarkerColor")) == 0) {
@@ -675,6 +692,9 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->stabilizerCuspDetection = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerFinalizeStroke")) == 0) {
         this->stabilizerFinalizeStroke = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokePredictionTime")) == 0) {
+        this->strokePredictionTime =
+                static_cast<unsigned int>(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
     }
     /**/
 
@@ -1095,9 +1115,18 @@ void Settings::save() {
 
     SAVE_INT_PROP(pdfPageCacheSize);
     ATTACH_COMMENT("The count of rendered PDF pages which will be cached.");
+    SAVE_INT_PROP(pdfDocumentPoolSize);
+    ATTACH_COMMENT("How many times a PDF document may be opened, to render as many of its pages at the same time.");
+    SAVE_INT_PROP(saveCompressionLevel);
+    ATTACH_COMMENT("The compression level of saved documents, from 0 (fastest, largest files) to 9 (smallest files).");
+    SAVE_INT_PROP(thumbnailCacheSize);
+    ATTACH_COMMENT("The maximal size of the thumbnail cache on disk, in MiB. 0 disables the cache.");
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
+    SAVE_BOOL_PROP(performanceOverlay);
+    SAVE_BOOL_PROP(performanceLog);
+    ATTACH_COMMENT("Appends the performance statistics to performance.csv in the cache folder");
 
     SAVE_STRING_PROP(pageTemplate);
     ATTACH_COMMENT("Config for new pages");
@@ -1148,6 +1177,8 @@ void Settings::save() {
     SAVE_DOUBLE_PROP(stabilizerMass);
     SAVE_BOOL_PROP(stabilizerCuspDetection);
     SAVE_BOOL_PROP(stabilizerFinalizeStroke);
+    SAVE_UINT_PROP(strokePredictionTime);
+    ATTACH_COMMENT("How far ahead (in ms) the motion of the pen is drawn ahead of the stroke, 0 to disable");
     /**/
 
     SAVE_BOOL_PROP(latexSettings.autoCheckDependencies);
@@ -2066,6 +2097,36 @@ void Settings::setPdfPageCacheSize(int size) {
     save();
 }
 
+auto Settings::getPdfDocumentPoolSize() const -> int { return this->pdfDocumentPoolSize; }
+
+void Settings::setPdfDocumentPoolSize(int size) {
+    if (this->pdfDocumentPoolSize == size) {
+        return;
+    }
+    this->pdfDocumentPoolSize = size;
+    save();
+}
+
+auto Settings::getSaveCompressionLevel() const -> int { return this->saveCompressionLevel; }
+
+void Settings::setSaveCompressionLevel(int level) {
+    if (this->saveCompressionLevel == level) {
+        return;
+    }
+    this->saveCompressionLevel = level;
+    save();
+}
+
+auto Settings::getThumbnailCacheSize() const -> int { return this->thumbnailCacheSize; }
+
+void Settings::setThumbnailCacheSize(int size) {
+    if (this->thumbnailCacheSize == size) {
+        return;
+    }
+    this->thumbnailCacheSize = size;
+    save();
+}
+
 auto Settings::getPreloadPagesBefore() const -> unsigned int { return this->preloadPagesBefore; }
 
 void Settings::setPreloadPagesBefore(unsigned int n) {
@@ -2096,6 +2157,26 @@ void Settings::setEagerPageCleanup(bool b) {
     save();
 }
 
+auto Settings::isPerformanceOverlayShown() const -> bool { return this->performanceOverlay; }
+
+void Settings::setPerformanceOverlayShown(bool b) {
+    if (this->performanceOverlay == b) {
+        return;
+    }
+    this->performanceOverlay = b;
+    save();
+}
+
+auto Settings::isPerformanceLogEnabled() const -> bool { return this->performanceLog; }
+
+void Settings::setPerformanceLogEnabled(bool b) {
+    if (this->performanceLog == b) {
+        return;
+    }
+    this->performanceLog = b;
+    save();
+}
+
 auto Settings::getBorderColor() const -> Color { return this->selectionBorderColor; }
 
 void Settings::setBorderColor(Color color) {
@@ -2582,6 +2663,15 @@ void Settings::setStabilizerPreprocessor(StrokeStabilizer::Preprocessor preproce
     save();
 }
 
+auto Settings::getStrokePredictionTime() const -> unsigned int { return strokePredictionTime; }
+void Settings::setStrokePredictionTime(unsigned int ms) {
+    if (strokePredictionTime == ms) {
+        return;
+    }
+    strokePredictionTime = ms;
+    save();
+}
+
 /**
  * @brief Get Color Palette used for Tools
  *
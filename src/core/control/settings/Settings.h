@@ -393,6 +393,24 @@ public:
     int getPdfPageCacheSize() const;
     [[maybe_unused]] void setPdfPageCacheSize(int size);
 
+    /**
+     * Number of private instances of a PDF document opened for rendering its pages, see XojPdfDocumentPool
+     */
+    int getPdfDocumentPoolSize() const;
+    [[maybe_unused]] void setPdfDocumentPoolSize(int size);
+
+    /**
+     * The gzip compression level of saved documents, from 0 (fastest) to 9 (smallest)
+     */
+    int getSaveCompressionLevel() const;
+    [[maybe_unused]] void setSaveCompressionLevel(int level);
+
+    /**
+     * Maximal size of the on-disk thumbnail cache, in MiB (0 disables the cache)
+     */
+    int getThumbnailCacheSize() const;
+    [[maybe_unused]] void setThumbnailCacheSize(int size);
+
     unsigned int getPreloadPagesBefore() const;
     void setPreloadPagesBefore(unsigned int n);
 
@@ -402,6 +420,12 @@ public:
     bool isEagerPageCleanup() const;
     void setEagerPageCleanup(bool b);
 
+    bool isPerformanceOverlayShown() const;
+    void setPerformanceOverlayShown(bool b);
+
+    bool isPerformanceLogEnabled() const;
+    void setPerformanceLogEnabled(bool b);
+
     std::string const& getPageTemplate() const;
     void setPageTemplate(const std::string& pageTemplate);
 
@@ -569,6 +593,12 @@ public:
     void setStabilizerAveragingMethod(StrokeStabilizer::AveragingMethod averagingMethod);
     void setStabilizerPreprocessor(StrokeStabilizer::Preprocessor preprocessor);
 
+    /**
+     * @return How far ahead (in ms) the pen's motion is predicted and drawn ahead of the live stroke. 0 if disabled.
+     */
+    unsigned int getStrokePredictionTime() const;
+    void setStrokePredictionTime(unsigned int ms);
+
     const Palette& getColorPalette();
 
     void setNumberOfSpacesForTab(unsigned int numberSpaces);
@@ -959,6 +989,22 @@ private:
      */
     int pdfPageCacheSize{};
 
+    /**
+     *  The maximal number of private instances of a PDF document used for rendering its pages. Pages are rendered
+     *  by the single scheduler thread: more than one instance only helps when pages are rendered from other threads.
+     */
+    int pdfDocumentPoolSize{};
+
+    /**
+     *  The gzip compression level of saved documents
+     */
+    int saveCompressionLevel{};
+
+    /**
+     *  The maximal size of the thumbnail cache on disk, in MiB
+     */
+    int thumbnailCacheSize{};
+
     /**
      *  Percentage by which the page's zoom must change
      * for PDF pages to re-render while zooming.
@@ -1137,6 +1183,16 @@ private:
      */
     bool eagerPageCleanup{};
 
+    /**
+     * Whether to show frame times, job queues and cache statistics on top of the pages
+     */
+    bool performanceOverlay{};
+
+    /**
+     * Whether to append the performance statistics to a CSV file in the cache folder
+     */
+    bool performanceLog{};
+
     /**
      * Stabilizer related settings
      */
@@ -1151,6 +1207,11 @@ private:
     StrokeStabilizer::AveragingMethod stabilizerAveragingMethod{};
     StrokeStabilizer::Preprocessor stabilizerPreprocessor{};
 
+    /**
+     * How far ahead (in ms) the pen's motion is predicted and drawn ahead of the live stroke. 0 disables it.
+     */
+    unsigned int strokePredictionTime{};
+
     /**
      * @brief Color Palette for tool colors
      *
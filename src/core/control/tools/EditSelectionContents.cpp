@@ -9,6 +9,8 @@
 #include <glib.h>  // for g_idle_add, g_sourc...
 
 #include "control/Control.h"                      // for Control
+#include "control/jobs/SelectionRenderJob.h"      // for SelectionRenderJob
+#include "control/jobs/XournalScheduler.h"        // for XournalScheduler
 #include "control/settings/Settings.h"            // for Settings
 #include "control/tools/CursorSelectionType.h"    // for CURSOR_SELECTION_TO...
 #include "gui/PageView.h"                         // for XojPageView
@@ -35,14 +37,17 @@
 #include "util/safe_casts.h"                      // for as_signed
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
-#include "view/ElementContainerView.h"            // for ElementContainerView
-#include "view/View.h"                            // for Context
 
 class XojFont;
 
 using std::vector;
 using xoj::util::Rectangle;
 
+/**
+ * Selections with more points than this are rendered in the background
+ */
+constexpr size_t ASYNC_RENDER_MIN_POINTS = 20000;
+
 EditSelectionContents::EditSelectionContents(Rectangle<double> bounds, Rectangle<double> snappedBounds,
                                              const PageRef& sourcePage, Layer* sourceLayer, XojPageView* sourceView):
         originalBounds(bounds),
@@ -62,6 +67,7 @@ EditSelectionContents::~EditSelectionContents() {
         this->rescaleId = 0;
     }
 
+    cancelRendering();
     deleteViewBuffer();
 }
 
@@ -146,7 +152,7 @@ auto EditSelectionContents::setSize(ToolSize size, const double* thicknessPen, c
     }
 
     if (found) {
-        this->deleteViewBuffer();
+        this->invalidateViewBuffer();
         this->sourceView->getXournal()->repaintSelection();
 
         return undo;
@@ -191,7 +197,7 @@ auto EditSelectionContents::setFill(int alphaPen, int alphaHighligther) -> UndoA
     }
 
     if (found) {
-        this->deleteViewBuffer();
+        this->invalidateViewBuffer();
         this->sourceView->getXournal()->repaintSelection();
 
         return undo;
@@ -243,7 +249,7 @@ auto EditSelectionContents::setFont(const XojFont& font) -> UndoActionPtr {
     }
 
     if (!std::isnan(x1)) {
-        this->deleteViewBuffer();
+        this->invalidateViewBuffer();
         this->sourceView->getXournal()->repaintSelection();
         return undo;
     }
@@ -272,7 +278,7 @@ auto EditSelectionContents::setLineStyle(LineStyle style) -> UndoActionPtr {
     }
 
     if (found) {
-        this->deleteViewBuffer();
+        this->invalidateViewBuffer();
         this->sourceView->getXournal()->repaintSelection();
 
         return undo;
@@ -301,7 +307,7 @@ auto EditSelectionContents::setColor(Color color) -> UndoActionPtr {
     }
 
     if (found) {
-        this->deleteViewBuffer();
+        this->invalidateViewBuffer();
         this->sourceView->getXournal()->repaintSelection();
 
         return undo;
@@ -334,8 +340,8 @@ void EditSelectionContents::fillUndoItem(DeleteUndoAction* undo) {
  * Callback to redrawing the buffer asynchron
  */
 auto EditSelectionContents::repaintSelection(EditSelectionContents* selection) -> bool {
-    // delete the selection buffer, force a redraw
-    selection->deleteViewBuffer();
+    // keep showing the stretched buffer until it is rendered again
+    selection->bufferOutdated = true;
     selection->sourceView->getXournal()->repaintSelection();
     selection->rescaleId = 0;
 
@@ -353,6 +359,67 @@ void EditSelectionContents::deleteViewBuffer() {
     }
 }
 
+void EditSelectionContents::invalidateViewBuffer() {
+    // A running job renders the previous state of the elements
+    cancelRendering();
+    this->bufferOutdated = true;
+}
+
+void EditSelectionContents::cancelRendering() {
+    if (this->renderJob) {
+        this->renderJob->deleteJob();
+        this->renderJob->unref();
+        this->renderJob = nullptr;
+    }
+}
+
+void EditSelectionContents::renderViewBuffer(double width, double height, double zoom) {
+    double fx = width / this->originalBounds.width;
+    double fy = height / this->originalBounds.height;
+
+    int dx = static_cast<int>(this->relativeX * zoom);
+    int dy = static_cast<int>(this->relativeY * zoom);
+
+    cairo_matrix_t transform;
+    cairo_matrix_init_translate(&transform, fx < 0 ? -width * zoom : 0, fy < 0 ? -height * zoom : 0);
+    cairo_matrix_scale(&transform, fx, fy);
+    cairo_matrix_translate(&transform, -dx, -dy);
+    cairo_matrix_scale(&transform, zoom, zoom);
+
+    int bufferWidth = static_cast<int>(std::abs(width) * zoom);
+    int bufferHeight = static_cast<int>(std::abs(height) * zoom);
+
+    size_t points = 0;
+    for (Element* e: this->selected) {
+        points += e->getType() == ELEMENT_STROKE ? dynamic_cast<Stroke*>(e)->getPointCount() : 1;
+    }
+
+    this->bufferOutdated = false;
+    cancelRendering();
+
+    if (points < ASYNC_RENDER_MIN_POINTS) {
+        deleteViewBuffer();
+        this->crBuffer = SelectionRenderJob::render(*this, bufferWidth, bufferHeight, transform);
+        return;
+    }
+
+    // Rendering a page full of handwriting takes a while, do not block the UI meanwhile
+    this->renderJob = new SelectionRenderJob(this, bufferWidth, bufferHeight, transform);
+    this->sourceView->getXournal()->getControl()->getScheduler()->addJob(this->renderJob, JOB_PRIORITY_URGENT);
+}
+
+void EditSelectionContents::setRenderedBuffer(cairo_surface_t* buffer) {
+    xoj_assert(this->renderJob);
+
+    deleteViewBuffer();
+    this->crBuffer = buffer;
+
+    this->renderJob->unref();
+    this->renderJob = nullptr;
+
+    this->sourceView->getXournal()->repaintSelection();
+}
+
 /**
  * The contents of the selection
  */
@@ -493,9 +560,6 @@ void EditSelectionContents::updateContent(Rectangle<double> bounds, Rectangle<do
  */
 void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotation, double width, double height,
                                   double zoom) {
-    double fx = width / this->originalBounds.width;
-    double fy = height / this->originalBounds.height;
-
     if (this->relativeX == -9999999999) {
         this->relativeX = x;
         this->relativeY = y;
@@ -505,23 +569,19 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
         this->rotation = rotation;
     }
 
-    if (this->crBuffer == nullptr) {
-        this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::abs(width) * zoom),
-                                                    static_cast<int>(std::abs(height) * zoom));
-        cairo_t* cr2 = cairo_create(this->crBuffer);
-
-        int dx = static_cast<int>(this->relativeX * zoom);
-        int dy = static_cast<int>(this->relativeY * zoom);
-
-        cairo_translate(cr2, fx < 0 ? -width * zoom : 0, fy < 0 ? -height * zoom : 0);
-        cairo_scale(cr2, fx, fy);
-        cairo_translate(cr2, -dx, -dy);
-        cairo_scale(cr2, zoom, zoom);
-
-        xoj::view::ElementContainerView view(this);
-        view.draw(xoj::view::Context::createDefault(cr2));
+    if ((this->crBuffer == nullptr || this->bufferOutdated) && this->renderJob == nullptr) {
+        renderViewBuffer(width, height, zoom);
+    }
 
-        cairo_destroy(cr2);
+    if (this->crBuffer == nullptr) {
+        // The first buffer is still being rendered, only show where the selection is
+        cairo_save(cr);
+        cairo_rectangle(cr, std::min(x, x + width) * zoom, std::min(y, y + height) * zoom, std::abs(width) * zoom,
+                        std::abs(height) * zoom);
+        cairo_set_source_rgba(cr, 0.5, 0.5, 0.5, 0.2);
+        cairo_fill(cr);
+        cairo_restore(cr);
+        return;
     }
 
     cairo_save(cr);
@@ -535,8 +595,8 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
     double sx = static_cast<double>(wTarget) / wImg;
     double sy = static_cast<double>(hTarget) / hImg;
 
-    if (wTarget != wImg || hTarget != hImg || std::abs(rotation) > std::numeric_limits<double>::epsilon()) {
-        if (!this->rescaleId) {
+    if (wTarget != wImg || hTarget != hImg) {
+        if (!this->rescaleId && !this->renderJob) {
             this->rescaleId = g_idle_add(xoj::util::wrap_v<repaintSelection>, this);
         }
         cairo_scale(cr, sx, sy);
@@ -35,6 +35,7 @@ class DeleteUndoAction;
 class LineStyle;
 class ObjectInputStream;
 class ObjectOutputStream;
+class SelectionRenderJob;
 class XojFont;
 
 class EditSelectionContents: public ElementContainer, public Serializable {
@@ -115,6 +116,11 @@ public:
      */
     void paint(cairo_t* cr, double x, double y, double rotation, double width, double height, double zoom);
 
+    /**
+     * Takes over the buffer rendered by the SelectionRenderJob. Called from the UI thread.
+     */
+    void setRenderedBuffer(cairo_surface_t* buffer);
+
     /**
      * Finish the editing
      */
@@ -133,6 +139,22 @@ private:
      */
     void deleteViewBuffer();
 
+    /**
+     * Mark our internal View buffer as outdated after the elements changed.
+     * It is still shown until the new one is rendered.
+     */
+    void invalidateViewBuffer();
+
+    /**
+     * Render the buffer, in the background if the selection is large
+     */
+    void renderViewBuffer(double width, double height, double zoom);
+
+    /**
+     * Drop the result of the SelectionRenderJob in progress, if any
+     */
+    void cancelRendering();
+
     /**
      * Callback to redrawing the buffer asynchrony
      */
@@ -215,6 +237,16 @@ private:
      */
     cairo_surface_t* crBuffer = nullptr;
 
+    /**
+     * The elements changed or were resized since crBuffer was rendered
+     */
+    bool bufferOutdated = false;
+
+    /**
+     * The job rendering the next buffer of a large selection
+     */
+    SelectionRenderJob* renderJob = nullptr;
+
     /**
      * The source id for the rescaling task
      */
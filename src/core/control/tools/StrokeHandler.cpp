@@ -43,7 +43,11 @@ StrokeHandler::StrokeHandler(Control* control, const PageRef& page):
         InputHandler(control, page),
         snappingHandler(control->getSettings()),
         stabilizer(StrokeStabilizer::get(control->getSettings())),
-        viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::StrokeToolView>>()) {}
+        viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::StrokeToolView>>()) {
+    if (unsigned int horizon = control->getSettings()->getStrokePredictionTime(); horizon > 0) {
+        predictor.emplace(horizon);
+    }
+}
 
 StrokeHandler::~StrokeHandler() = default;
 
@@ -63,6 +67,11 @@ auto StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos, double zoo
     }
 
     stabilizer->processEvent(pos);
+
+    if (predictor && stroke->getToolType() != StrokeTool::HIGHLIGHTER) {
+        predictor->addEvent(pos.x, pos.y, pos.timestamp);
+        dispatchPrediction(zoom);
+    }
     return true;
 }
 
@@ -120,6 +129,22 @@ void StrokeHandler::drawSegmentTo(const Point& point) {
     return;
 }
 
+void StrokeHandler::dispatchPrediction(double zoom) {
+    std::vector<Point> pts;
+    const utl::Point<double> displacement = predictor->predictDisplacement(predictor->getHorizon());
+    if (displacement != utl::Point<double>(0.0, 0.0)) {
+        // The prediction continues the stroke where it currently ends, with its current width
+        const Point last = stroke->getPointVector().back();
+        pts.reserve(PREDICTION_STEPS + 1);
+        pts.push_back(last);
+        for (int i = 1; i <= PREDICTION_STEPS; i++) {
+            const auto d = predictor->predictDisplacement(predictor->getHorizon() * i / PREDICTION_STEPS) / zoom;
+            pts.emplace_back(last.x + d.x, last.y + d.y, last.z);
+        }
+    }
+    this->viewPool->dispatch(xoj::view::StrokeToolView::PREDICTION_REQUEST, pts);
+}
+
 void StrokeHandler::onSequenceCancelEvent() {
     if (this->stroke) {
         this->viewPool->dispatchAndClear(xoj::view::StrokeToolView::CANCELLATION_REQUEST,
@@ -268,6 +293,11 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos, double zoom
     stroke->addPoint(Point(this->buttonDownPoint.x, this->buttonDownPoint.y, width));
 
     stabilizer->initialize(this, zoom, pos);
+
+    if (predictor) {
+        predictor->reset();
+        predictor->addEvent(pos.x, pos.y, pos.timestamp);
+    }
 }
 
 void StrokeHandler::onButtonDoublePressEvent(const PositionInputData&, double) {
@@ -11,7 +11,8 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
+#include <memory>    // for unique_ptr
+#include <optional>  // for optional
 
 #include <gdk/gdk.h>  // for GdkEventKey
 
@@ -20,6 +21,7 @@
 
 #include "InputHandler.h"            // for InputHandler
 #include "SnapToGridInputHandler.h"  // for SnapToGridInputHandler
+#include "StrokePredictor.h"         // for StrokePredictor
 
 class Control;
 class Layer;
@@ -84,6 +86,11 @@ protected:
 
     void strokeRecognizerDetected(Stroke* recognized, Layer* layer);
 
+    /**
+     * @brief Send the views the predicted continuation of the stroke (or none if the motion is unknown)
+     */
+    void dispatchPrediction(double zoom);
+
 protected:
     Point buttonDownPoint;  // used for tapSelect and filtering - never snapped to grid.
     SnapToGridInputHandler snappingHandler;
@@ -94,6 +101,11 @@ private:
      */
     std::unique_ptr<StrokeStabilizer::Base> stabilizer;
 
+    /**
+     * @brief Predicts the motion of the pen, if predicted ink is enabled
+     */
+    std::optional<StrokePredictor> predictor;
+
     std::shared_ptr<xoj::util::DispatchPool<xoj::view::StrokeToolView>> viewPool;
 
     bool hasPressure;
@@ -101,4 +113,9 @@ private:
     friend class StrokeStabilizer::Active;
 
     static constexpr double MAX_WIDTH_VARIATION = 0.3;
+
+    /**
+     * @brief Number of segments of the predicted ink
+     */
+    static constexpr int PREDICTION_STEPS = 3;
 };
@@ -0,0 +1,54 @@
+#include "StrokePredictor.h"
+
+#include <algorithm>  // for clamp
+
+StrokePredictor::StrokePredictor(double horizon): horizon(horizon) {}
+
+void StrokePredictor::reset() { events.clear(); }
+
+void StrokePredictor::addEvent(double x, double y, guint32 timestamp) {
+    if (!events.empty() && timestamp < events.back().timestamp) {
+        // The device's clock is not monotonous: do not mix the events of both time bases
+        events.clear();
+    } else if (!events.empty() && timestamp == events.back().timestamp) {
+        // Several events in the same ms: keep the most recent position only
+        events.back().pos = utl::Point<double>(x, y);
+        return;
+    }
+    events.push_back({utl::Point<double>(x, y), timestamp});
+    while (timestamp - events.front().timestamp > WINDOW) {
+        events.pop_front();
+    }
+}
+
+auto StrokePredictor::predictDisplacement(double ms) const -> utl::Point<double> {
+    if (events.size() < 3) {
+        return {0.0, 0.0};
+    }
+
+    // Average velocities over the first and the second half of the window
+    const TimedPosition& first = events.front();
+    const TimedPosition& mid = events[events.size() / 2];
+    const TimedPosition& last = events.back();
+    const double dt1 = mid.timestamp - first.timestamp;
+    const double dt2 = last.timestamp - mid.timestamp;
+    const utl::Point<double> v1 = (mid.pos - first.pos) / dt1;
+    const utl::Point<double> v2 = (last.pos - mid.pos) / dt2;
+
+    // v2 is the velocity at the middle of the second half. Extrapolate it to the last event.
+    const utl::Point<double> acceleration = (v2 - v1) / (0.5 * (dt1 + dt2));
+    const utl::Point<double> velocity = v2 + acceleration * (0.5 * dt2);
+
+    const double t = std::clamp(ms, 0.0, horizon);
+    utl::Point<double> displacement = velocity * t + acceleration * (0.5 * t * t);
+
+    // Do not let a noisy acceleration throw the prediction far away from the pen
+    const double maxDistance = 2.0 * velocity.distance({0.0, 0.0}) * t;
+    const double distance = displacement.distance({0.0, 0.0});
+    if (distance > maxDistance) {
+        displacement *= maxDistance / distance;
+    }
+    return displacement;
+}
+
+auto StrokePredictor::getHorizon() const -> double { return horizon; }
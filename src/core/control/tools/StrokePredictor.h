@@ -0,0 +1,67 @@
+/*
+ * Xournal++
+ *
+ * Extrapolates the motion of the pen, to draw the stroke a little ahead of the last input event
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+#pragma once
+
+#include <deque>  // for deque
+
+#include <glib.h>  // for guint32
+
+#include "util/Point.h"  // for Point
+
+/**
+ * @brief Predicts where the pen will be in a few milliseconds, from the velocity and acceleration of its last events.
+ *
+ * The prediction is only ever drawn as a preview: it is never added to the stroke.
+ */
+class StrokePredictor {
+public:
+    /**
+     * @param horizon How far ahead the motion is predicted, in ms
+     */
+    explicit StrokePredictor(double horizon);
+
+    /**
+     * @brief Forget the events of the previous stroke
+     */
+    void reset();
+
+    /**
+     * @brief Add the position of an input event. The coordinates can be in any unit, the prediction uses the same.
+     */
+    void addEvent(double x, double y, guint32 timestamp);
+
+    /**
+     * @brief The expected displacement of the pen since the last event
+     * @param ms Time after the last event, in ms (at most the horizon)
+     * @return (0, 0) if there are not enough recent events to estimate the motion
+     */
+    auto predictDisplacement(double ms) const -> utl::Point<double>;
+
+    auto getHorizon() const -> double;
+
+private:
+    struct TimedPosition {
+        utl::Point<double> pos;
+        guint32 timestamp;
+    };
+
+    /**
+     * @brief Events of the last WINDOW ms
+     */
+    std::deque<TimedPosition> events;
+
+    double horizon;
+
+    /**
+     * @brief Events older than this (in ms) are not relevant for the current motion
+     */
+    static constexpr guint32 WINDOW = 40;
+};
@@ -0,0 +1,161 @@
+#include "AudioAttachments.h"
+
+#include <fstream>       // for ofstream
+#include <map>           // for map
+#include <memory>        // for shared_ptr, weak_ptr, make_shared
+#include <mutex>         // for mutex, lock_guard
+#include <system_error>  // for error_code
+#include <utility>       // for move
+#include <vector>        // for vector
+
+#include <glib.h>     // for g_warning
+#include <zip.h>      // for zip_open, zip_fopen, zip_fread...
+#include <zipconf.h>  // for zip_int64_t
+
+namespace AudioAttachments {
+
+namespace {
+/**
+ * An archive with pending attachments stays open: on POSIX systems, its content can still be read after the file was
+ * renamed, moved or deleted. It is closed once all its attachments are extracted.
+ */
+struct Archive {
+    explicit Archive(fs::path path): path(std::move(path)) {
+        int zipError = 0;
+        this->zip = zip_open(this->path.u8string().c_str(), ZIP_RDONLY, &zipError);
+    }
+    ~Archive() {
+        if (this->zip) {
+            zip_discard(this->zip);
+        }
+    }
+
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+
+    const fs::path path;
+    zip_t* zip = nullptr;
+
+    /**
+     * libzip archives cannot be read from several threads. Only held while extracting, not with the global mutex.
+     */
+    std::mutex mutex;
+};
+
+struct Source {
+    std::shared_ptr<Archive> archive;
+    std::string entry;
+};
+
+std::mutex mutex;
+std::map<fs::path, Source> pending;
+std::map<fs::path, std::weak_ptr<Archive>> archives;
+
+/**
+ * The archive may be loaded and saved with different (relative, absolute) paths
+ */
+auto normalize(const fs::path& archive) -> fs::path {
+    std::error_code ec;
+    auto path = fs::weakly_canonical(archive, ec);
+    return ec ? archive : path;
+}
+
+/**
+ * The archive mutex must be held by the caller
+ */
+auto extractTo(const fs::path& tempFile, const Source& source) -> bool {
+    Archive& archive = *source.archive;
+    if (!archive.zip) {
+        g_warning("Could not open %s to extract the audio attachment %s", archive.path.u8string().c_str(),
+                  source.entry.c_str());
+        return false;
+    }
+
+    zip_file_t* file = zip_fopen(archive.zip, source.entry.c_str(), 0);
+    if (!file) {
+        g_warning("Could not open the audio attachment %s: %s", source.entry.c_str(),
+                  zip_error_strerror(zip_get_error(archive.zip)));
+        return false;
+    }
+
+    std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+    std::vector<char> buffer(1 << 16);
+    zip_int64_t read = 0;
+    while (out && (read = zip_fread(file, buffer.data(), buffer.size())) > 0) {
+        out.write(buffer.data(), static_cast<std::streamsize>(read));
+    }
+    zip_fclose(file);
+    out.close();
+
+    if (read < 0 || !out) {
+        g_warning("Could not extract the audio attachment %s to %s", source.entry.c_str(),
+                  tempFile.u8string().c_str());
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+void add(const fs::path& tempFile, const fs::path& archive, const std::string& entry) {
+    const fs::path normalized = normalize(archive);
+    std::lock_guard lock{mutex};
+    auto& weak = archives[normalized];
+    auto shared = weak.lock();
+    if (!shared) {
+        shared = std::make_shared<Archive>(normalized);
+        weak = shared;
+    }
+    pending[tempFile] = {std::move(shared), entry};
+}
+
+auto extract(const fs::path& tempFile) -> bool {
+    Source source;
+    {
+        std::lock_guard lock{mutex};
+        auto it = pending.find(tempFile);
+        if (it == pending.end()) {
+            return true;
+        }
+        source = it->second;
+    }
+
+    // Only this archive is blocked during the extraction, so that a file is not extracted twice at the same time
+    std::lock_guard archiveLock{source.archive->mutex};
+    {
+        std::lock_guard lock{mutex};
+        if (pending.find(tempFile) == pending.end()) {
+            // Extracted by another thread in the meantime
+            return true;
+        }
+    }
+    if (!extractTo(tempFile, source)) {
+        return false;
+    }
+
+    std::lock_guard lock{mutex};
+    pending.erase(tempFile);
+    return true;
+}
+
+void extractAll(const fs::path& archive) {
+    const fs::path normalized = normalize(archive);
+    std::vector<fs::path> files;
+    {
+        std::lock_guard lock{mutex};
+        for (auto const& [tempFile, source]: pending) {
+            if (source.archive->path == normalized) {
+                files.push_back(tempFile);
+            }
+        }
+    }
+    for (auto const& tempFile: files) {
+        extract(tempFile);
+    }
+}
+
+auto isPending(const fs::path& tempFile) -> bool {
+    std::lock_guard lock{mutex};
+    return pending.find(tempFile) != pending.end();
+}
+
+}  // namespace AudioAttachments
@@ -0,0 +1,53 @@
+/*
+ * Xournal++
+ *
+ * Audio attachments of .xopp files, extracted when they are first played
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>  // for string
+
+#include "filesystem.h"  // for path
+
+/**
+ * Audio attachments can be hours long: extracting them all while loading a document would be slow and use as much disk
+ * space again. Instead, the loader creates an empty temporary file for each attachment, which the audio elements refer
+ * to, and registers where its content is. The content is only copied out of the archive when the file is played, before
+ * the archive is overwritten, or when a document referring to the file is saved elsewhere.
+ *
+ * The archive is kept open while some of its attachments are pending, so that they survive it being renamed or deleted.
+ *
+ * All functions are thread safe.
+ */
+namespace AudioAttachments {
+
+/**
+ * @param tempFile The (empty) file the elements refer to
+ * @param archive The .xopp file
+ * @param entry The name of the attachment in the archive
+ */
+void add(const fs::path& tempFile, const fs::path& archive, const std::string& entry);
+
+/**
+ * Fill tempFile with its content, if it is a pending attachment
+ * @return false if the attachment could not be extracted
+ */
+bool extract(const fs::path& tempFile);
+
+/**
+ * Extract all the pending attachments of an archive. To be called before the archive is overwritten.
+ */
+void extractAll(const fs::path& archive);
+
+/**
+ * @return true if tempFile is an attachment which has not been extracted yet
+ */
+bool isPending(const fs::path& tempFile);
+
+}  // namespace AudioAttachments
@@ -0,0 +1,314 @@
+#include "AutosaveJournal.h"
+
+#include <fstream>       // for ifstream, ofstream
+#include <map>           // for map
+#include <system_error>  // for error_code
+#include <utility>       // for move
+
+#include <glib.h>  // for g_warning, g_ascii_strtoull, GChecksum
+
+#include "control/xojfile/LoadHandler.h"  // for LoadHandler
+#include "control/xojfile/SaveHandler.h"  // for SaveHandler
+#include "model/Document.h"               // for Document
+#include "model/XojPage.h"                // for XojPage
+#include "util/Assert.h"                  // for xoj_assert
+#include "util/PlaceholderString.h"       // for PlaceholderString
+#include "util/i18n.h"                    // for FS, _F
+#include "util/serdesstream.h"            // for serdes_stream
+
+namespace {
+constexpr auto MANIFEST_HEADER = "xournalpp-autosave-journal 2";
+constexpr auto MANIFEST_FILE = "manifest";
+
+/**
+ * Number of journal entries after which the next autosave writes a full snapshot again
+ */
+constexpr size_t MAX_JOURNAL_ENTRIES = 16;
+
+auto parseIndex(const std::string& s, size_t& index) -> bool {
+    gchar* end = nullptr;
+    index = static_cast<size_t>(g_ascii_strtoull(s.c_str(), &end, 10));
+    return !s.empty() && end == s.c_str() + s.length();
+}
+
+/**
+ * The size and SHA-256 of the snapshot, empty if it cannot be read. The modification time is not used, as the
+ * snapshot may be copied to the autosave folder along with its journal.
+ */
+auto computeSnapshotId(const fs::path& snapshotPath) -> std::string {
+    std::ifstream in(snapshotPath, std::ios::binary);
+    if (!in) {
+        return "";
+    }
+
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    char buffer[1 << 16];
+    std::streamsize size = 0;
+    while (in.read(buffer, static_cast<std::streamsize>(sizeof(buffer))) || in.gcount() > 0) {
+        g_checksum_update(checksum, reinterpret_cast<const guchar*>(buffer), static_cast<gssize>(in.gcount()));
+        size += in.gcount();
+    }
+    std::string id = std::to_string(size) + "-" + g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return id;
+}
+};  // namespace
+
+AutosaveJournal::AutosaveJournal() = default;
+
+AutosaveJournal::~AutosaveJournal() = default;
+
+auto AutosaveJournal::getJournalPath(const fs::path& snapshotPath) -> fs::path {
+    return fs::path{snapshotPath} += ".journal";
+}
+
+void AutosaveJournal::moveJournal(const fs::path& from, const fs::path& to) {
+    auto fromJournal = getJournalPath(from);
+    std::error_code ec;
+    if (!fs::exists(fromJournal, ec)) {
+        return;
+    }
+
+    if (!to.empty()) {
+        auto toJournal = getJournalPath(to);
+        fs::remove_all(toJournal, ec);
+        fs::rename(fromJournal, toJournal, ec);
+        if (ec) {
+            // The autosave folder may be on another file system
+            ec.clear();
+            fs::copy(fromJournal, toJournal, fs::copy_options::recursive, ec);
+            if (ec) {
+                g_warning("Could not move autosave journal %s: %s", fromJournal.u8string().c_str(),
+                          ec.message().c_str());
+            }
+        }
+    }
+    fs::remove_all(fromJournal, ec);
+}
+
+void AutosaveJournal::requireSnapshot() {
+    std::lock_guard lock(this->dirtyMutex);
+    this->snapshotRequired = true;
+}
+
+void AutosaveJournal::undoRedoChanged() {}
+
+void AutosaveJournal::undoRedoPageChanged(PageRef page) {
+    std::lock_guard lock(this->dirtyMutex);
+    this->dirtyPages.insert(page.get());
+}
+
+void AutosaveJournal::undoRedoDocumentChanged() { requireSnapshot(); }
+
+auto AutosaveJournal::prepare(Document* doc, const fs::path& snapshotPath) -> bool {
+    std::unordered_set<const XojPage*> dirty;
+    bool snapshotRequired = false;
+    {
+        std::lock_guard lock(this->dirtyMutex);
+        dirty = this->dirtyPages;
+        snapshotRequired = this->snapshotRequired;
+        this->snapshotRequired = false;
+    }
+
+    const size_t pageCount = doc->getPageCount();
+    std::error_code ec;
+    // The journal only holds pages: anything else that changed needs a full snapshot
+    bool full = snapshotRequired || pageCount == 0 || snapshotPath != this->snapshotPath ||
+                doc->getPdfFilepath() != this->pdfPath || doc->isAttachPdf() != this->attachPdf ||
+                this->entries >= MAX_JOURNAL_ENTRIES || !fs::exists(snapshotPath, ec);
+
+    this->pendingPages.clear();
+    this->pendingPages.reserve(pageCount);
+    std::vector<PageRef> changed;
+
+    if (!full) {
+        const std::string entryName = std::to_string(this->entries);
+        for (size_t i = 0; i < pageCount; i++) {
+            PageRef page = doc->getPage(i);
+            auto it = this->sources.find(page.get());
+            if (it == this->sources.end() || it->second.page.lock() != page || dirty.count(page.get())) {
+                this->pendingPages.push_back({page, entryName + ":" + std::to_string(changed.size())});
+                changed.push_back(page);
+            } else {
+                this->pendingPages.push_back({page, it->second.token});
+            }
+        }
+
+        // Rewriting most of the pages anyway, start over with a compact snapshot
+        full = changed.size() * 2 > pageCount;
+    }
+
+    this->handler = std::make_unique<SaveHandler>();
+    if (full) {
+        this->pendingPages.clear();
+        for (size_t i = 0; i < pageCount; i++) {
+            this->pendingPages.push_back({doc->getPage(i), "b" + std::to_string(i)});
+        }
+        this->handler->prepareSave(doc);
+        this->pendingPath = snapshotPath;
+    } else {
+        this->handler->prepareSave(doc, changed);
+        this->pendingPath = getJournalPath(snapshotPath) / (std::to_string(this->entries) + ".xopp");
+    }
+
+    this->pendingFull = full;
+    if (full || snapshotPath != this->snapshotPath) {
+        this->snapshotPath = snapshotPath;
+        this->snapshotId.clear();
+    }
+    this->pdfPath = doc->getPdfFilepath();
+    this->attachPdf = doc->isAttachPdf();
+
+    // Pages changed from now on are part of the next autosave
+    {
+        std::lock_guard lock(this->dirtyMutex);
+        for (auto* p: dirty) {
+            this->dirtyPages.erase(p);
+        }
+    }
+
+    return full;
+}
+
+auto AutosaveJournal::write() -> std::string {
+    xoj_assert(this->handler);
+
+    std::error_code ec;
+    auto journal = getJournalPath(this->snapshotPath);
+    std::string error;
+
+    if (this->pendingFull) {
+        fs::remove_all(journal, ec);
+        this->handler->saveTo(this->pendingPath);
+        error = this->handler->getErrorMessage();
+        if (error.empty()) {
+            this->snapshotId = computeSnapshotId(this->pendingPath);
+            this->entries = 0;
+        }
+    } else {
+        fs::create_directories(journal, ec);
+        this->handler->saveTo(this->pendingPath);
+        error = this->handler->getErrorMessage();
+
+        if (error.empty()) {
+            // Replace the manifest atomically, a crash never leaves a partial one behind
+            auto tmpPath = journal / (std::string(MANIFEST_FILE) + ".tmp");
+            {
+                auto out = serdes_stream<std::ofstream>(tmpPath);
+                out << MANIFEST_HEADER << "\n" << this->snapshotId << "\n";
+                for (auto const& p: this->pendingPages) {
+                    out << p.token << "\n";
+                }
+                if (!out) {
+                    error = FS(_F("Could not write autosave journal \"{1}\"") % tmpPath.u8string());
+                }
+            }
+            if (error.empty()) {
+                fs::rename(tmpPath, journal / MANIFEST_FILE, ec);
+                if (ec) {
+                    error = FS(_F("Could not write autosave journal \"{1}\": {2}") % journal.u8string() %
+                               ec.message());
+                }
+            }
+        }
+
+        if (error.empty()) {
+            this->entries++;
+        }
+    }
+
+    this->handler.reset();
+
+    if (!error.empty()) {
+        // Nothing is known about the state on disk, start over with a snapshot next time
+        this->snapshotPath.clear();
+        this->sources.clear();
+        return error;
+    }
+
+    this->sources.clear();
+    for (auto& p: this->pendingPages) {
+        if (auto page = p.page.lock()) {
+            this->sources.emplace(page.get(), std::move(p));
+        }
+    }
+    this->pendingPages.clear();
+
+    return error;
+}
+
+auto AutosaveJournal::apply(Document& doc, const fs::path& snapshotPath) -> bool {
+    auto journal = getJournalPath(snapshotPath);
+    auto manifestPath = journal / MANIFEST_FILE;
+
+    std::error_code ec;
+    if (!fs::exists(manifestPath, ec)) {
+        return true;
+    }
+
+    auto in = serdes_stream<std::ifstream>(manifestPath);
+    std::string header;
+    std::string snapshotId;
+    if (!std::getline(in, header) || header != MANIFEST_HEADER || !std::getline(in, snapshotId) ||
+        snapshotId.empty() || snapshotId != computeSnapshotId(snapshotPath)) {
+        // Written for another snapshot, or by another version: the snapshot is the latest known state
+        in.close();
+        auto stale = fs::path{journal} += ".stale";
+        fs::remove_all(stale, ec);
+        fs::rename(journal, stale, ec);
+        g_warning("The autosave journal %s does not belong to %s, ignoring it (moved to %s)",
+                  journal.u8string().c_str(), snapshotPath.u8string().c_str(), stale.u8string().c_str());
+        return true;
+    }
+
+    struct Entry {
+        std::unique_ptr<LoadHandler> loader;
+        Document* doc = nullptr;
+    };
+
+    std::vector<PageRef> pages;
+    std::map<std::string, Entry> entries;
+    std::string token;
+    while (in >> token) {
+        size_t index = 0;
+        Document* source = &doc;
+        std::string indexStr = token.substr(1);
+
+        if (token[0] != 'b') {
+            auto colon = token.find(':');
+            if (colon == std::string::npos) {
+                g_warning("Invalid autosave journal entry \"%s\"", token.c_str());
+                return false;
+            }
+            std::string entry = token.substr(0, colon);
+            indexStr = token.substr(colon + 1);
+
+            auto& e = entries[entry];
+            if (!e.loader) {
+                e.loader = std::make_unique<LoadHandler>();
+                // The pages of the journal share the PDF background of the snapshot
+                e.loader->setLoadPdfBackground(false);
+                e.doc = e.loader->loadDocument(journal / (entry + ".xopp"));
+                if (!e.doc) {
+                    g_warning("Could not load autosave journal entry %s: %s", entry.c_str(),
+                              e.loader->getLastError().c_str());
+                    return false;
+                }
+            }
+            source = e.doc;
+        }
+
+        if (!parseIndex(indexStr, index) || index >= source->getPageCount()) {
+            g_warning("Invalid autosave journal entry \"%s\"", token.c_str());
+            return false;
+        }
+        pages.push_back(source->getPage(index));
+    }
+
+    while (doc.getPageCount() > 0) {
+        doc.deletePage(doc.getPageCount() - 1);
+    }
+    doc.addPages(pages.begin(), pages.end());
+
+    return true;
+}
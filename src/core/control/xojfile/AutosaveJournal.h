@@ -0,0 +1,119 @@
+/*
+ * Xournal++
+ *
+ * Incremental autosave: a full snapshot plus a journal of changed pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <memory>         // for unique_ptr, weak_ptr
+#include <mutex>          // for mutex
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <unordered_set>  // for unordered_set
+#include <vector>         // for vector
+
+#include "model/PageRef.h"         // for PageRef
+#include "undo/UndoRedoHandler.h"  // for UndoRedoListener
+
+#include "filesystem.h"  // for path
+
+class Document;
+class SaveHandler;
+class XojPage;
+
+/**
+ * @brief Writes autosaves incrementally.
+ *
+ * The first autosave of a document writes a full snapshot (a regular .xopp file). The following autosaves only
+ * write the pages changed since then (as tracked through the undo/redo handler) into a small .xopp file in the
+ * journal folder "<snapshot>.journal", together with a manifest listing where each page of the document is stored.
+ * Once the journal grows too large, the next autosave writes a full snapshot again and drops the journal.
+ *
+ * LoadHandler applies the journal when loading a snapshot, so that opening or restoring an autosave file yields
+ * the latest autosaved state.
+ */
+class AutosaveJournal: public UndoRedoListener {
+public:
+    AutosaveJournal();
+    ~AutosaveJournal() override;
+
+    AutosaveJournal(const AutosaveJournal&) = delete;
+    AutosaveJournal& operator=(const AutosaveJournal&) = delete;
+
+public:
+    /**
+     * @brief Serialize the pages to autosave. The document must be locked by the caller.
+     *
+     * @param snapshotPath The path of the full snapshot
+     * @return true if a full snapshot will be written, false if only a journal entry will be appended
+     */
+    bool prepare(Document* doc, const fs::path& snapshotPath);
+
+    /**
+     * @brief Write what was prepared to disk. The document does not need to be locked.
+     * @return An error message, empty on success
+     */
+    std::string write();
+
+    /**
+     * @brief Apply the journal of a snapshot to the document loaded from the snapshot, if there is one. A journal
+     * written for another snapshot is moved aside and ignored.
+     * @return false if the journal belongs to the snapshot but could not be applied
+     */
+    static bool apply(Document& doc, const fs::path& snapshotPath);
+
+    static fs::path getJournalPath(const fs::path& snapshotPath);
+
+    /**
+     * Move the journal along with its snapshot, or delete it if to is empty
+     */
+    static void moveJournal(const fs::path& from, const fs::path& to);
+
+    /**
+     * Write a full snapshot on the next autosave, for changes that cannot be attributed to pages
+     */
+    void requireSnapshot();
+
+    // UndoRedoListener
+    void undoRedoChanged() override;
+    void undoRedoPageChanged(PageRef page) override;
+    void undoRedoDocumentChanged() override;
+
+private:
+    struct Source {
+        std::weak_ptr<XojPage> page;
+        /// "b<index>" for a page of the snapshot, "<entry>:<index>" for a page of a journal entry
+        std::string token;
+    };
+
+    std::unique_ptr<SaveHandler> handler;
+
+    /**
+     * State of the prepared autosave, taken over by write() on success
+     */
+    bool pendingFull = false;
+    fs::path pendingPath;
+    std::vector<Source> pendingPages;
+
+    /**
+     * Where each page of the document is stored on disk
+     */
+    std::unordered_map<const XojPage*, Source> sources;
+    fs::path snapshotPath;
+    fs::path pdfPath;
+    bool attachPdf = false;
+    /// Identifies the contents of the snapshot the journal belongs to, stored in the manifest
+    std::string snapshotId;
+    size_t entries = 0;
+
+    std::mutex dirtyMutex;
+    std::unordered_set<const XojPage*> dirtyPages;
+    bool snapshotRequired = false;
+};
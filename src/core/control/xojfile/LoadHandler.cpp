@@ -2,6 +2,7 @@
 
 #include <algorithm>    // for copy
 #include <cmath>        // for isnan
+#include <cstdint>      // for uint32_t
 #include <cstdlib>      // for atoi, size_t
 #include <cstring>      // for strcmp, strlen
 #include <iterator>     // for back_inserter
@@ -14,6 +15,8 @@
 #include <glib-object.h>  // for g_object_unref
 
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
+#include "control/xojfile/AudioAttachments.h"  // for add
+#include "control/xojfile/AutosaveJournal.h"   // for AutosaveJournal
 #include "model/BackgroundImage.h"             // for BackgroundImage
 #include "model/Font.h"                        // for XojFont
 #include "model/Image.h"                       // for Image
@@ -29,7 +32,9 @@
 #include "util/GzUtil.h"                       // for GzUtil
 #include "util/LoopUtil.h"
 #include "util/PlaceholderString.h"  // for PlaceholderString
+#include "util/Trace.h"              // for XOJ_TRACE_SCOPE
 #include "util/i18n.h"               // for _F, FC, FS, _
+#include "util/raii/GBytesSPtr.h"
 #include "util/raii/GObjectSPtr.h"
 #include "util/safe_casts.h"  // for as_signed, as_unsigned
 
@@ -50,6 +55,71 @@ using std::string;
 namespace {
 constexpr size_t MAX_VERSION_LENGTH = 50;
 constexpr size_t MAX_MIMETYPE_LENGTH = 25;
+
+#ifndef _WIN32
+auto readLE16(const guint8* p) -> uint32_t { return uint32_t(p[0]) | uint32_t(p[1]) << 8; }
+auto readLE32(const guint8* p) -> uint32_t { return readLE16(p) | readLE16(p + 2) << 16; }
+
+/**
+ * Find the offset of the data of an uncompressed entry in the bytes of a zip archive, by reading the central directory
+ * and the local header of the entry. Zip64 archives are not handled.
+ */
+auto findStoredZipEntry(const guint8* zip, gsize size, const string& name, zip_uint64_t length)
+        -> std::optional<gsize> {
+    constexpr gsize EOCD_SIZE = 22;
+    constexpr gsize CD_ENTRY_SIZE = 46;
+    constexpr gsize LOCAL_HEADER_SIZE = 30;
+    if (size < EOCD_SIZE) {
+        return std::nullopt;
+    }
+
+    // The end of central directory record is followed by a comment of at most 64 KiB
+    std::optional<gsize> eocd;
+    for (gsize pos = size - EOCD_SIZE;; pos--) {
+        if (readLE32(zip + pos) == 0x06054b50) {
+            eocd = pos;
+            break;
+        }
+        if (pos == 0 || size - EOCD_SIZE - pos >= 0xFFFF) {
+            return std::nullopt;
+        }
+    }
+
+    const gsize cdSize = readLE32(zip + *eocd + 12);
+    const gsize cdOffset = readLE32(zip + *eocd + 16);
+    if (cdOffset + cdSize > *eocd) {
+        return std::nullopt;
+    }
+
+    for (gsize pos = cdOffset; pos + CD_ENTRY_SIZE <= cdOffset + cdSize;) {
+        const guint8* entry = zip + pos;
+        if (readLE32(entry) != 0x02014b50) {
+            return std::nullopt;
+        }
+        const gsize nameLength = readLE16(entry + 28);
+        const gsize next = pos + CD_ENTRY_SIZE + nameLength + readLE16(entry + 30) + readLE16(entry + 32);
+        if (pos + CD_ENTRY_SIZE + nameLength > cdOffset + cdSize) {
+            return std::nullopt;
+        }
+
+        if (name.compare(0, string::npos, reinterpret_cast<const char*>(entry + CD_ENTRY_SIZE), nameLength) == 0) {
+            const gsize localOffset = readLE32(entry + 42);
+            if (readLE16(entry + 10) != 0 || readLE32(entry + 20) != length ||
+                localOffset + LOCAL_HEADER_SIZE > size || readLE32(zip + localOffset) != 0x04034b50) {
+                return std::nullopt;
+            }
+            const guint8* local = zip + localOffset;
+            const gsize dataOffset = localOffset + LOCAL_HEADER_SIZE + readLE16(local + 26) + readLE16(local + 28);
+            if (dataOffset + length > size) {
+                return std::nullopt;
+            }
+            return dataOffset;
+        }
+        pos = next;
+    }
+    return std::nullopt;
+}
+#endif
 }  // namespace
 
 LoadHandler::LoadHandler():
@@ -118,6 +188,8 @@ auto LoadHandler::getMissingPdfFilename() const -> string { return this->pdfMiss
 
 void LoadHandler::removePdfBackground() { this->removePdfBackgroundFlag = true; }
 
+void LoadHandler::setLoadPdfBackground(bool load) { this->loadPdfBackground = load; }
+
 void LoadHandler::setPdfReplacement(fs::path filepath, bool attachToDocument) {
     this->pdfReplacementFilepath = std::move(filepath);
     this->pdfReplacementAttach = attachToDocument;
@@ -444,7 +516,7 @@ void LoadHandler::parseBgPdf() {
 
     this->page->setBackgroundPdfPageNr(as_unsigned(pageno) - 1);
 
-    if (!this->pdfFilenameParsed) {
+    if (!this->pdfFilenameParsed && this->loadPdfBackground) {
 
         if (this->pdfReplacementFilepath.empty()) {
             const char* domain = LoadHandlerHelper::getAttrib("domain", false, this);
@@ -468,12 +540,12 @@ void LoadHandler::parseBgPdf() {
                 if (this->isGzFile) {
                     pdfFilename = (fs::path{xournalFilepath} += ".") += pdfFilename;
                 } else {
-                    auto readResult = readZipAttachment(pdfFilename);
-                    if (!readResult) {
+                    auto pdfBytes = readZipAttachmentBytes(pdfFilename);
+                    if (!pdfBytes) {
                         return;
                     }
-                    std::string& pdfBytes = readResult.value();
-                    doc.readPdf(pdfFilename, false, attachToDocument, pdfBytes.data(), pdfBytes.size());
+                    doc.readPdf(pdfFilename, false, attachToDocument, pdfBytes.get(),
+                                getZipAttachmentFingerprint(pdfFilename));
 
                     if (!doc.getLastErrorMsg().empty()) {
                         error("%s", FC(_F("Error reading PDF: {1}") % doc.getLastErrorMsg()));
@@ -788,20 +860,11 @@ void LoadHandler::parseLayer() {
 /**
  * Create a temporary file for the attached audio file.
  * The OS should take care of removing the file.
+ * The attachment is only extracted to it when it is played (see AudioAttachments).
  */
 void LoadHandler::parseAudio() {
     const char* filename = LoadHandlerHelper::getAttrib("fn", false, this);
 
-    GFileIOStream* fileStream = nullptr;
-    xoj::util::GObjectSPtr<GFile> tmpFile(g_file_new_tmp("xournal_audio_XXXXXX.tmp", &fileStream, nullptr),
-                                          xoj::util::adopt);
-    if (!tmpFile) {
-        g_warning("Unable to create temporary file for audio attachment.");
-        return;
-    }
-
-    GOutputStream* outputStream = g_io_stream_get_output_stream(G_IO_STREAM(fileStream));
-
     zip_stat_t attachmentFileStat;
     int statStatus = zip_stat(this->zipFp, filename, 0, &attachmentFileStat);
     if (statStatus != 0) {
@@ -810,48 +873,18 @@ void LoadHandler::parseAudio() {
         return;
     }
 
-    gsize length = 0;
-    if (attachmentFileStat.valid & ZIP_STAT_SIZE) {
-        length = attachmentFileStat.size;
-    } else {
-        error("%s", FC(_F("Could not open attachment: {1}. Error message: No valid file size provided") % filename));
-        return;
-    }
-
-    zip_file_t* attachmentFile = zip_fopen(this->zipFp, filename, 0);
-
-    if (!attachmentFile) {
-        error("%s", FC(_F("Could not open attachment: {1}. Error message: {2}") % filename %
-                       zip_error_strerror(zip_get_error(this->zipFp))));
+    GFileIOStream* fileStream = nullptr;
+    xoj::util::GObjectSPtr<GFile> tmpFile(g_file_new_tmp("xournal_audio_XXXXXX.tmp", &fileStream, nullptr),
+                                          xoj::util::adopt);
+    if (!tmpFile) {
+        g_warning("Unable to create temporary file for audio attachment.");
         return;
     }
+    g_object_unref(fileStream);
 
-    gpointer data = g_malloc(1024);
-    zip_uint64_t readBytes = 0;
-    while (readBytes < length) {
-        zip_int64_t read = zip_fread(attachmentFile, data, 1024);
-        if (read == -1) {
-            g_free(data);
-            zip_fclose(attachmentFile);
-            error("%s", FC(_F("Could not open attachment: {1}. Error message: Could not read file") % filename));
-            return;
-        }
-
-        gboolean writeSuccessful =
-                g_output_stream_write_all(outputStream, data, static_cast<gsize>(read), nullptr, nullptr, nullptr);
-        if (!writeSuccessful) {
-            g_free(data);
-            zip_fclose(attachmentFile);
-            error("%s", FC(_F("Could not open attachment: {1}. Error message: Could not write file") % filename));
-            return;
-        }
-
-        readBytes += static_cast<zip_uint64_t>(read);
-    }
-    g_free(data);
-    zip_fclose(attachmentFile);
-
-    g_hash_table_insert(this->audioFiles, g_strdup(filename), g_file_get_path(tmpFile.get()));
+    char* tmpPath = g_file_get_path(tmpFile.get());
+    AudioAttachments::add(fs::path(tmpPath), this->xournalFilepath, filename);
+    g_hash_table_insert(this->audioFiles, g_strdup(filename), tmpPath);
 }
 
 void LoadHandler::parserStartElement(GMarkupParseContext* context, const gchar* elementName,
@@ -1098,6 +1131,8 @@ void LoadHandler::readTexImage(const gchar* base64string, gsize base64stringLen)
  * Document should not be freed, it will be freed with LoadHandler!
  */
 auto LoadHandler::loadDocument(fs::path const& filepath) -> Document* {
+    XOJ_TRACE_SCOPE("LoadHandler::loadDocument", "io");
+
     initAttributes();
     doc.clearDocument();
 
@@ -1128,6 +1163,16 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> Document* {
 
     closeFile();
 
+    // An incremental autosave keeps the pages changed since its last full snapshot in a journal
+    if (!AutosaveJournal::apply(this->doc, filepath)) {
+        // Do not present the snapshot as if it was the latest autosaved state
+        this->lastError = FS(_F("The autosave journal \"{1}\" could not be applied, the pages changed since the last "
+                                "full autosave are missing. Move the journal away to open the older snapshot.") %
+                             AutosaveJournal::getJournalPath(filepath).u8string());
+        this->doc.clearDocument();
+        return nullptr;
+    }
+
     return &this->doc;
 }
 
@@ -1173,6 +1218,53 @@ auto LoadHandler::readZipAttachment(fs::path const& filename) -> std::optional<s
     return {std::move(data)};
 }
 
+auto LoadHandler::readZipAttachmentBytes(fs::path const& filename) -> xoj::util::GBytesSPtr {
+#ifndef _WIN32
+    // On Windows, a mapped file can neither be deleted nor replaced until it is unmapped: the PDF is read into memory
+    const string name = filename.u8string();
+    zip_stat_t stat;
+    if (zip_stat(this->zipFp, name.c_str(), 0, &stat) == 0 && (stat.valid & ZIP_STAT_SIZE) &&
+        (stat.valid & ZIP_STAT_COMP_METHOD) && stat.comp_method == ZIP_CM_STORE &&
+        (stat.valid & ZIP_STAT_ENCRYPTION_METHOD) && stat.encryption_method == ZIP_EM_NONE) {
+        // The archive is mapped read-only: SaveJob never truncates it in place, it renames a new file over it
+        GMappedFile* mapped = g_mapped_file_new(this->xournalFilepath.u8string().c_str(), false, nullptr);
+        if (mapped) {
+            xoj::util::GBytesSPtr archive(g_mapped_file_get_bytes(mapped), xoj::util::adopt);
+            g_mapped_file_unref(mapped);
+
+            gsize size = 0;
+            const auto* zip = static_cast<const guint8*>(g_bytes_get_data(archive.get(), &size));
+            if (auto offset = zip ? findStoredZipEntry(zip, size, name, stat.size) : std::nullopt) {
+                return xoj::util::GBytesSPtr(g_bytes_new_from_bytes(archive.get(), *offset, stat.size),
+                                             xoj::util::adopt);
+            }
+        }
+    }
+#endif
+
+    auto readResult = readZipAttachment(filename);
+    if (!readResult) {
+        return nullptr;
+    }
+    // Hand the buffer over to the GBytes instead of copying it
+    auto* data = new string(std::move(*readResult));
+    return xoj::util::GBytesSPtr(
+            g_bytes_new_with_free_func(data->data(), data->size(), [](gpointer s) { delete static_cast<string*>(s); },
+                                       data),
+            xoj::util::adopt);
+}
+
+auto LoadHandler::getZipAttachmentFingerprint(fs::path const& filename) -> std::string {
+    zip_stat_t stat;
+    if (zip_stat(this->zipFp, filename.u8string().c_str(), 0, &stat) != 0 || !(stat.valid & ZIP_STAT_CRC) ||
+        !(stat.valid & ZIP_STAT_SIZE)) {
+        return "";
+    }
+    char crc[9];
+    g_snprintf(crc, sizeof(crc), "%08x", stat.crc);
+    return string("zip/") + crc + "/" + std::to_string(stat.size);
+}
+
 auto LoadHandler::getTempFileForPath(fs::path const& filename) -> fs::path {
     gpointer tmpFilename = g_hash_table_lookup(this->audioFiles, filename.u8string().c_str());
     if (tmpFilename) {
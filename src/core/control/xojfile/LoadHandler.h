@@ -25,6 +25,7 @@
 #include "model/DocumentHandler.h"  // for DocumentHandler
 #include "model/PageRef.h"          // for PageRef
 #include "util/Color.h"             // for Color
+#include "util/raii/GBytesSPtr.h"   // for GBytesSPtr
 
 #include "LoadHandlerHelper.h"
 #include "filesystem.h"  // for path
@@ -64,6 +65,11 @@ public:
     void removePdfBackground();
     void setPdfReplacement(fs::path filepath, bool attachToDocument);
 
+    /**
+     * Only read the page numbers of PDF backgrounds, without loading the PDF file itself
+     */
+    void setLoadPdfBackground(bool load);
+
     /** @return The version of the loaded file */
     int getFileVersion() const;
 
@@ -117,6 +123,18 @@ private:
      */
     std::optional<std::string> readZipAttachment(fs::path const& filename);
 
+    /**
+     * Returns the contents of the zip attachment with the given file name. If it is stored uncompressed, the
+     * archive is mapped in memory and the contents are not copied. Returns nullptr if there is no such file.
+     */
+    xoj::util::GBytesSPtr readZipAttachmentBytes(fs::path const& filename);
+
+    /**
+     * Identifies the contents of the zip attachment with the given file name by the CRC32 and size stored in the
+     * archive, without reading it. Returns an empty string if they are not available.
+     */
+    std::string getZipAttachmentFingerprint(fs::path const& filename);
+
     fs::path getTempFileForPath(fs::path const& filename);
 
 private:
@@ -125,6 +143,7 @@ private:
     bool attachedPdfMissing;
 
     bool removePdfBackgroundFlag;
+    bool loadPdfBackground = true;
     fs::path pdfReplacementFilepath;
     bool pdfReplacementAttach;
 
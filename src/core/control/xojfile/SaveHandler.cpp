@@ -4,12 +4,14 @@
 #include <cstdint>     // for uint32_t
 #include <cstdio>      // for sprintf, size_t
 #include <filesystem>  // for exists
+#include <thread>      // for thread
 
-#include <cairo.h>                  // for cairo_surface_t
+#include <cairo.h>                  // for cairo_surface_t, cairo_surface_write_to_png_stream
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_save
 #include <glib.h>                   // for g_free, g_strdup_printf
 
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
+#include "control/xojfile/AudioAttachments.h"  // for extract, extractAll, isPending
 #include "control/xml/XmlAudioNode.h"          // for XmlAudioNode
 #include "control/xml/XmlImageNode.h"          // for XmlImageNode
 #include "control/xml/XmlNode.h"               // for XmlNode
@@ -35,6 +37,8 @@
 #include "util/OutputStream.h"                 // for GzOutputStream, Output...
 #include "util/PathUtil.h"                     // for clearExtensions
 #include "util/PlaceholderString.h"            // for PlaceholderString
+#include "util/Trace.h"                        // for XOJ_TRACE_SCOPE
+#include "util/XojPreviewExtractor.h"          // for XojPreviewExtractor
 #include "util/i18n.h"                         // for FS, _F
 
 #include "config.h"  // for FILE_FORMAT_VERSION
@@ -45,6 +49,17 @@ SaveHandler::SaveHandler() {
 }
 
 void SaveHandler::prepareSave(Document* doc) {
+    std::vector<PageRef> pages;
+    pages.reserve(doc->getPageCount());
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        pages.emplace_back(doc->getPage(i));
+    }
+    prepareSave(doc, pages);
+}
+
+void SaveHandler::prepareSave(Document* doc, const std::vector<PageRef>& pages) {
+    XOJ_TRACE_SCOPE("SaveHandler::prepareSave", "io");
+
     if (this->root) {
         // cleanup old data
         backgroundImages.clear();
@@ -57,21 +72,28 @@ void SaveHandler::prepareSave(Document* doc) {
 
     writeHeader();
 
+    this->previewPng.clear();
     cairo_surface_t* preview = doc->getPreview();
     if (preview) {
         auto* image = new XmlImageNode("preview");
         image->setImage(preview);
         this->root->addChild(image);
+
+        cairo_surface_write_to_png_stream(
+                preview,
+                [](void* closure, const unsigned char* data, unsigned int length) {
+                    static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                    return CAIRO_STATUS_SUCCESS;
+                },
+                &this->previewPng);
     }
 
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
+    for (auto const& p: pages) {
         p->getBackgroundImage().clearSaveState();
     }
 
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        visitPage(root.get(), p, doc, static_cast<int>(i));
+    for (size_t i = 0; i < pages.size(); i++) {
+        visitPage(root.get(), pages[i], doc, static_cast<int>(i));
     }
 }
 
@@ -92,6 +114,10 @@ void SaveHandler::writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAu
     /** set stroke timestamp value to the XmlPointNode */
     xmlAudioNode->setAttrib("ts", audioElement->getTimestamp());
     xmlAudioNode->setAttrib("fn", audioElement->getAudioFilename().u8string());
+
+    if (AudioAttachments::isPending(audioElement->getAudioFilename())) {
+        this->pendingAudioFiles.push_back(audioElement->getAudioFilename());
+    }
 }
 
 void SaveHandler::visitStroke(XmlPointNode* stroke, Stroke* s) {
@@ -313,15 +339,26 @@ void SaveHandler::writeBackgroundName(XmlNode* background, PageRef p) {
     }
 }
 
-void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
-    GzOutputStream out(filepath);
+void SaveHandler::setCompressionLevel(int level) { this->compressionLevel = level; }
+
+void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) { saveTo(filepath, filepath, listener); }
+
+void SaveHandler::saveTo(const fs::path& file, const fs::path& target, ProgressListener* listener) {
+    AudioAttachments::extractAll(target);
+    // The saved file refers to the temporary files of the attachments, which must not stay empty
+    for (auto const& file: this->pendingAudioFiles) {
+        AudioAttachments::extract(file);
+    }
+
+    GzOutputStream out(file, this->compressionLevel, std::thread::hardware_concurrency(),
+                       XojPreviewExtractor::makeGzipExtraField(this->previewPng));
 
     if (!out.getLastError().empty()) {
         this->errorMessage = out.getLastError();
         return;
     }
 
-    saveTo(&out, filepath, listener);
+    saveTo(&out, target, listener);
 
     out.close();
 
@@ -331,6 +368,8 @@ void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
 }
 
 void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
+    XOJ_TRACE_SCOPE("SaveHandler::saveTo", "io");
+
     // XMLNode should be locale-safe ( store doubles using Locale 'C' format
 
     out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
@@ -37,7 +37,21 @@ public:
 
 public:
     void prepareSave(Document* doc);
+
+    /**
+     * Only save the given pages of the document, e.g. for an autosave journal entry
+     */
+    void prepareSave(Document* doc, const std::vector<PageRef>& pages);
+    /**
+     * @param level The gzip compression level, from 0 (fastest) to 9 (smallest), or -1 for zlib's default
+     */
+    void setCompressionLevel(int level);
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
+    /**
+     * Write the document to file as if it was saved to target: the files stored next to the document (the attached
+     * background images, the audio attachments) are named after target, which file is renamed over afterwards
+     */
+    void saveTo(const fs::path& file, const fs::path& target, ProgressListener* listener);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
     std::string getErrorMessage();
 
@@ -64,6 +78,17 @@ protected:
     int attachBgId;
 
     std::string errorMessage;
+    int compressionLevel = -1;
+
+    /**
+     * The preview as PNG, also written into the gzip header for XojPreviewExtractor
+     */
+    std::string previewPng;
 
     std::vector<BackgroundImage> backgroundImages{};
+
+    /**
+     * Audio attachments not extracted yet, see AudioAttachments
+     */
+    std::vector<fs::path> pendingAudioFiles{};
 };
@@ -2,6 +2,7 @@
 
 #include <algorithm>  // for max, find_if
 #include <cinttypes>  // for int64_t
+#include <cmath>      // for hypot
 #include <cstdint>    // for int64_t
 #include <cstdlib>    // for size_t
 #include <iomanip>    // for operator<<, quoted
@@ -44,10 +45,12 @@
 #include "control/tools/TextEditor.h"               // for TextEditor, TextE...
 #include "control/tools/VerticalToolHandler.h"      // for VerticalToolHandler
 #include "gui/FloatingToolbox.h"                    // for FloatingToolbox
+#include "gui/Layout.h"                             // for Layout
 #include "gui/MainWindow.h"                         // for MainWindow
 #include "gui/PdfFloatingToolbox.h"                 // for PdfFloatingToolbox
 #include "gui/SearchBar.h"                          // for SearchBar
 #include "gui/inputdevices/PositionInputData.h"     // for PositionInputData
+#include "gui/widgets/XournalWidget.h"              // for gtk_xournal_get_layout
 #include "model/Document.h"                         // for Document
 #include "model/Element.h"                          // for Element, ELEMENT_...
 #include "model/Layer.h"                            // for Layer, Layer::Index
@@ -124,8 +127,12 @@ void XojPageView::setIsVisible(bool visible) { this->visible = visible; }
 void XojPageView::deleteViewBuffer() {
     std::lock_guard lock(this->drawingMutex);
     this->buffer.reset();
+    this->renderedZoom = 0;
+    this->recycledMask = xoj::view::RecycledMask();
 }
 
+auto XojPageView::getRecycledMask() -> xoj::view::RecycledMask* { return &this->recycledMask; }
+
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
     if (!local) {
         bool leftOk = this->getX() <= x;
@@ -156,7 +163,7 @@ auto XojPageView::searchTextOnPage(const std::string& text, size_t index, size_t
             pdf = doc->getPdfPage(pNr);
             doc->unlock();
         }
-        this->search = std::make_unique<SearchControl>(page, pdf);
+        this->search = std::make_unique<SearchControl>(page, pdf, xournal->getControl()->getSearchIndex());
         this->overlayViews.emplace_back(std::make_unique<xoj::view::SearchResultView>(
                 this->search.get(), this, settings->getSelectionColor(), settings->getActiveSelectionColor()));
     }
@@ -790,6 +797,15 @@ void XojPageView::rerenderPage() {
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
+auto XojPageView::getViewportDistance() const -> double {
+    Layout* layout = gtk_xournal_get_layout(this->xournal->getWidget());
+    auto visible = layout->getVisibleRect();
+    double zoom = this->xournal->getZoom();
+    double dx = this->getX() + this->page->getWidth() * zoom / 2 - (visible.x + visible.width / 2);
+    double dy = this->getY() + this->page->getHeight() * zoom / 2 - (visible.y + visible.height / 2);
+    return std::hypot(dx, dy);
+}
+
 void XojPageView::repaintPage() const { xournal->getRepaintHandler()->repaintPage(this); }
 
 void XojPageView::repaintArea(double x1, double y1, double x2, double y2) const {
@@ -844,24 +860,21 @@ void XojPageView::rerenderRect(double x, double y, double width, double height)
         return;
     }
 
-    auto rect = Rectangle<double>{x, y, width, height};
-
-    this->repaintRectMutex.lock();
-
-    for (auto&& r: this->rerenderRects) {
-        // its faster to redraw only one rect than repaint twice the same area
-        // so loop through the rectangles to be redrawn, if new rectangle
-        // intersects any of them, replace it by the union with the new one
-        if (r.intersects(rect)) {
-            r.unite(rect);
-            this->repaintRectMutex.unlock();
-            return;
+    {
+        // Overlapping rectangles are merged by the RenderJob, see Range::coalesce
+        std::lock_guard lock(this->repaintRectMutex);
+        if (this->rerenderRects.size() < MAX_RERENDER_RECTS) {
+            this->rerenderRects.emplace_back(x, y, width, height);
+        } else {
+            // The job is far behind: render the whole changed area at once rather than merging ever more rectangles
+            xoj::util::Rectangle<double> bounds(x, y, width, height);
+            for (auto const& rect: this->rerenderRects) {
+                bounds.unite(rect);
+            }
+            this->rerenderRects.assign(1, bounds);
         }
     }
 
-    this->rerenderRects.push_back(rect);
-    this->repaintRectMutex.unlock();
-
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
@@ -1035,11 +1048,17 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
             return true;
         }
 
-        if (this->buffer.getZoom() != zoom) {
+        if (this->buffer.getZoom() == zoom) {
+            this->buffer.paintTo(cr);
+        } else if (this->renderedZoom != zoom) {
+            // Stretch the outdated buffer until the first pass for the new zoom is done
             rerenderPage();
-            cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
+            this->buffer.paintTo(cr, CAIRO_FILTER_FAST);
+        } else {
+            // Low resolution pass of a progressive rerendering
+            this->xournal->getControl()->getScheduler()->addRefineRenderPage(this, getViewportDistance());
+            this->buffer.paintTo(cr, CAIRO_FILTER_BILINEAR);
         }
-        this->buffer.paintTo(cr);
     }  // Restore the state of cr and then release the mutex
        // restoring the state of cr ensures this->buffer.surface is not longer referenced as the source in cr.
 
@@ -1064,6 +1083,11 @@ auto XojPageView::isSelected() const -> bool { return selected; }
 
 auto XojPageView::hasBuffer() const -> bool { return this->buffer.isInitialized(); }
 
+auto XojPageView::getBufferMemorySize() -> size_t {
+    std::lock_guard lock(this->drawingMutex);
+    return this->buffer.getMemorySize();
+}
+
 auto XojPageView::getSelectionColor() -> GdkRGBA { return Util::rgb_to_GdkRGBA(settings->getSelectionColor()); }
 
 auto XojPageView::getTextEditor() -> TextEditor* { return textEditor.get(); }
@@ -26,7 +26,7 @@
 #include "model/PageRef.h"            // for PageRef
 #include "util/Rectangle.h"           // for Rectangle
 #include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
-#include "view/Mask.h"                // for Mask
+#include "view/Mask.h"                // for Mask, RecycledMask
 #include "view/Repaintable.h"         // for Repaintable
 
 #include "Layout.h"            // for Layout
@@ -74,6 +74,7 @@ public:
      *      Used to avoid blinking when a tool finished editing an element
      */
     void drawAndDeleteToolView(xoj::view::ToolView* v, const Range& rg) override;
+    xoj::view::RecycledMask* getRecycledMask() override;
     /**
      * @brief Simply deletes an overlay and any trace of it on the display (provided the overlay is contained in the
      * given range)
@@ -134,6 +135,11 @@ public:
     GdkRGBA getSelectionColor() override;
     bool hasBuffer() const;
 
+    /**
+     * @return The approximate memory used by the rendered page, in bytes
+     */
+    size_t getBufferMemorySize();
+
     TextEditor* getTextEditor();
 
     /**
@@ -244,6 +250,11 @@ private:
 
     void deleteView(xoj::view::OverlayView* v);
 
+    /**
+     * @return The distance between the center of the page and the center of the viewport, in pixels
+     */
+    double getViewportDistance() const;
+
 private:
     PageRef page;
     XournalView* xournal = nullptr;
@@ -279,6 +290,17 @@ private:
     xoj::view::Mask buffer;
     std::mutex drawingMutex;
 
+    /**
+     * The mask of the last stroke drawn on this page, released with the buffer
+     */
+    xoj::view::RecycledMask recycledMask;
+
+    /**
+     * The zoom the buffer was rendered for. Differs from buffer.getZoom() while the buffer only holds the low
+     * resolution pass of a progressive rerendering (see RenderJob).
+     */
+    double renderedZoom = 0;
+
     bool inEraser = false;
 
     /**
@@ -292,7 +314,11 @@ private:
     std::unique_ptr<SearchControl> search;
 
     std::mutex repaintRectMutex;
+    /**
+     * Areas to rerender by the queued RenderJob. Past MAX_RERENDER_RECTS, they are replaced by their bounding box.
+     */
     std::vector<xoj::util::Rectangle<double>> rerenderRects;
+    static constexpr size_t MAX_RERENDER_RECTS = 256;
     bool rerenderComplete = false;
 
     int dispX{};  // position on display - set in Layout::layoutPages
@@ -0,0 +1,260 @@
+#include "PerformanceOverlay.h"
+
+#include <algorithm>  // for max
+#include <cstdio>     // for snprintf
+#include <utility>    // for move
+
+#include <gtk/gtk.h>  // for gtk_widget_queue_draw_area
+
+#include "control/Control.h"                // for Control
+#include "control/PdfCache.h"               // for PdfCache
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "control/settings/Settings.h"      // for Settings
+#include "gui/scroll/ScrollHandling.h"      // for ScrollHandling
+#include "util/PathUtil.h"                  // for getCacheFile
+#include "util/glib_casts.h"                // for wrap_v
+#include "util/safe_casts.h"                // for ceil_cast
+#include "util/serdesstream.h"              // for serdes_stream
+
+#include "filesystem.h"  // for exists, file_size
+
+#include "PageView.h"     // for XojPageView
+#include "XournalView.h"  // for XournalView
+
+using std::chrono::microseconds;
+
+namespace {
+constexpr double FONT_SIZE = 12;
+constexpr double LINE_HEIGHT = 16;
+constexpr double PADDING = 8;
+
+/// Size of the area repainted before the overlay was painted once
+constexpr int INITIAL_WIDTH = 600;
+constexpr int INITIAL_HEIGHT = 120;
+
+auto toMs(microseconds us) -> double { return static_cast<double>(us.count()) / 1000.0; }
+
+auto toMiB(size_t bytes) -> double { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+void summarize(const Scheduler::JobDurations& d, size_t& count, microseconds& average, microseconds& max) {
+    count = d.count;
+    average = d.count ? d.total / static_cast<int64_t>(d.count) : microseconds{};
+    max = d.max;
+}
+}  // namespace
+
+PerformanceOverlay::PerformanceOverlay(XournalView* view): view(view) {}
+
+PerformanceOverlay::~PerformanceOverlay() {
+    if (this->timeout) {
+        g_source_remove(this->timeout);
+        this->timeout = 0;
+    }
+}
+
+void PerformanceOverlay::updateSettings(Settings* settings) {
+    bool wasShown = this->shown;
+    this->shown = settings->isPerformanceOverlayShown();
+
+    if (settings->isPerformanceLogEnabled() && !this->log.is_open()) {
+        auto file = Util::getCacheFile("performance.csv");
+        bool isNew = !fs::exists(file) || fs::file_size(file) == 0;
+        this->log = serdes_stream<std::ofstream>(file, std::ios::app);
+        if (!this->log) {
+            g_warning("Could not open the performance log %s", file.u8string().c_str());
+        } else if (isNew) {
+            this->log << "unix_time_ms,frames,frame_avg_ms,frame_max_ms,queue_urgent,queue_high,queue_low,queue_none,"
+                         "render_jobs,render_avg_ms,render_max_ms,preview_jobs,preview_avg_ms,preview_max_ms,"
+                         "pdf_cache_hits,pdf_cache_misses,page_buffer_bytes,pdf_cache_bytes\n";
+        }
+    } else if (!settings->isPerformanceLogEnabled() && this->log.is_open()) {
+        this->log.close();
+    }
+
+    bool active = this->shown || this->log.is_open();
+    if (active && !this->timeout) {
+        this->frameTimes.clear();
+        // Drop the job durations collected while the statistics were not shown
+        this->view->getControl()->getScheduler()->takeStats();
+        this->timeout = g_timeout_add(SAMPLE_INTERVAL_MS, xoj::util::wrap_v<sampleTimer>, this);
+    } else if (!active && this->timeout) {
+        g_source_remove(this->timeout);
+        this->timeout = 0;
+    }
+
+    if (wasShown != this->shown) {
+        queueRepaint();
+    }
+}
+
+void PerformanceOverlay::frameDrawn(microseconds duration) {
+    if (isActive()) {
+        this->frameTimes.push_back(duration);
+    }
+}
+
+auto PerformanceOverlay::sampleTimer(PerformanceOverlay* self) -> bool {
+    self->takeSample();
+    if (self->log.is_open()) {
+        self->writeCsv();
+    }
+    if (self->shown) {
+        self->queueRepaint();
+    }
+    return true;
+}
+
+void PerformanceOverlay::takeSample() {
+    Sample s;
+
+    s.frames = this->frameTimes.size();
+    for (auto t: this->frameTimes) {
+        s.frameAverage += t;
+        s.frameMax = std::max(s.frameMax, t);
+    }
+    if (s.frames) {
+        s.frameAverage /= static_cast<int64_t>(s.frames);
+    }
+    this->frameTimes.clear();
+
+    Scheduler::Stats stats = this->view->getControl()->getScheduler()->takeStats();
+    s.queued = stats.queued;
+    Scheduler::JobDurations render = stats.executed[JOB_TYPE_RENDER];
+    render.count += stats.executed[JOB_TYPE_RENDER_REFINE].count;
+    render.total += stats.executed[JOB_TYPE_RENDER_REFINE].total;
+    render.max = std::max(render.max, stats.executed[JOB_TYPE_RENDER_REFINE].max);
+    summarize(render, s.renderJobs, s.renderAverage, s.renderMax);
+    summarize(stats.executed[JOB_TYPE_PREVIEW], s.previewJobs, s.previewAverage, s.previewMax);
+
+    if (PdfCache* cache = this->view->getCache()) {
+        PdfCache::Stats pdf = cache->getStats();
+        // The counters of the cache start at 0 again when another document is opened
+        if (pdf.hits < this->totalPdfHits || pdf.misses < this->totalPdfMisses) {
+            this->totalPdfHits = 0;
+            this->totalPdfMisses = 0;
+        }
+        s.pdfHits = pdf.hits - this->totalPdfHits;
+        s.pdfMisses = pdf.misses - this->totalPdfMisses;
+        this->totalPdfHits = pdf.hits;
+        this->totalPdfMisses = pdf.misses;
+        s.pdfCacheBytes = pdf.memorySize;
+    }
+
+    for (auto&& pv: this->view->getViewPages()) {
+        s.pageBufferBytes += pv->getBufferMemorySize();
+    }
+
+    this->sample = std::move(s);
+}
+
+void PerformanceOverlay::writeCsv() {
+    const Sample& s = this->sample;
+    this->log << g_get_real_time() / 1000 << "," << s.frames << "," << toMs(s.frameAverage) << ","
+              << toMs(s.frameMax);
+    for (size_t q: s.queued) {
+        this->log << "," << q;
+    }
+    this->log << "," << s.renderJobs << "," << toMs(s.renderAverage) << "," << toMs(s.renderMax) << ","
+              << s.previewJobs << "," << toMs(s.previewAverage) << "," << toMs(s.previewMax) << "," << s.pdfHits
+              << "," << s.pdfMisses << "," << s.pageBufferBytes << "," << s.pdfCacheBytes << "\n";
+    this->log.flush();
+}
+
+auto PerformanceOverlay::formatSample() const -> std::vector<std::string> {
+    const Sample& s = this->sample;
+    const double seconds = SAMPLE_INTERVAL_MS / 1000.0;
+    std::vector<std::string> lines;
+    char buffer[256];
+
+    snprintf(buffer, sizeof(buffer), "Frames   %5.1f fps  avg %6.2f ms  max %6.2f ms",
+             static_cast<double>(s.frames) / seconds, toMs(s.frameAverage), toMs(s.frameMax));
+    lines.emplace_back(buffer);
+
+    snprintf(buffer, sizeof(buffer), "Queued   urgent %zu  high %zu  low %zu  none %zu", s.queued[JOB_PRIORITY_URGENT],
+             s.queued[JOB_PRIORITY_HIGH], s.queued[JOB_PRIORITY_LOW], s.queued[JOB_PRIORITY_NONE]);
+    lines.emplace_back(buffer);
+
+    snprintf(buffer, sizeof(buffer), "Render   %5zu jobs  avg %6.2f ms  max %6.2f ms", s.renderJobs,
+             toMs(s.renderAverage), toMs(s.renderMax));
+    lines.emplace_back(buffer);
+
+    snprintf(buffer, sizeof(buffer), "Preview  %5zu jobs  avg %6.2f ms  max %6.2f ms", s.previewJobs,
+             toMs(s.previewAverage), toMs(s.previewMax));
+    lines.emplace_back(buffer);
+
+    size_t lookups = s.pdfHits + s.pdfMisses;
+    if (lookups) {
+        snprintf(buffer, sizeof(buffer), "PDF      %5.1f %% cache hits (%zu of %zu)",
+                 100.0 * static_cast<double>(s.pdfHits) / static_cast<double>(lookups), s.pdfHits, lookups);
+    } else {
+        snprintf(buffer, sizeof(buffer), "PDF      no cache lookups");
+    }
+    lines.emplace_back(buffer);
+
+    snprintf(buffer, sizeof(buffer), "Memory   pages %.1f MiB  PDF cache %.1f MiB", toMiB(s.pageBufferBytes),
+             toMiB(s.pdfCacheBytes));
+    lines.emplace_back(buffer);
+
+    return lines;
+}
+
+void PerformanceOverlay::paint(cairo_t* cr, int x, int y) {
+    if (!this->shown) {
+        return;
+    }
+
+    auto lines = formatSample();
+
+    cairo_save(cr);
+    cairo_select_font_face(cr, "Monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, FONT_SIZE);
+
+    double width = 0;
+    for (auto& line: lines) {
+        cairo_text_extents_t extents = {0};
+        cairo_text_extents(cr, line.c_str(), &extents);
+        width = std::max(width, extents.x_advance);
+    }
+    const double height = static_cast<double>(lines.size()) * LINE_HEIGHT + 2 * PADDING;
+    width += 2 * PADDING;
+
+    this->paintedArea = {x, y, ceil_cast<int>(width), ceil_cast<int>(height)};
+
+    cairo_rectangle(cr, x, y, width, height);
+    cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
+    cairo_fill(cr);
+
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    double baseline = y + PADDING + FONT_SIZE;
+    for (auto& line: lines) {
+        cairo_move_to(cr, x + PADDING, baseline);
+        cairo_show_text(cr, line.c_str());
+        baseline += LINE_HEIGHT;
+    }
+    cairo_restore(cr);
+}
+
+void PerformanceOverlay::queueRepaint() {
+    GtkWidget* widget = this->view->getWidget();
+    if (!widget) {
+        return;
+    }
+
+    // Erase the overlay at its last position, the visible area may have been scrolled since
+    GdkRectangle& area = this->paintedArea;
+    if (area.width > 0) {
+        gtk_widget_queue_draw_area(widget, area.x, area.y, area.width, area.height);
+    }
+
+    if (!this->shown) {
+        area = {};
+        return;
+    }
+
+    ScrollHandling* scrollHandling = this->view->getScrollHandling();
+    int x = static_cast<int>(gtk_adjustment_get_value(scrollHandling->getHorizontal()));
+    int y = static_cast<int>(gtk_adjustment_get_value(scrollHandling->getVertical()));
+    int width = area.width > 0 ? area.width : INITIAL_WIDTH;
+    int height = area.height > 0 ? area.height : INITIAL_HEIGHT;
+    gtk_widget_queue_draw_area(widget, x, y, width, height);
+}
@@ -0,0 +1,115 @@
+/*
+ * Xournal++
+ *
+ * Shows frame times, job queues and cache statistics on top of the pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>    // for array
+#include <chrono>   // for microseconds
+#include <cstddef>  // for size_t
+#include <fstream>  // for ofstream
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <cairo.h>    // for cairo_t
+#include <gdk/gdk.h>  // for GdkRectangle
+#include <glib.h>     // for guint
+
+#include "control/jobs/Scheduler.h"  // for JOB_N_PRIORITIES
+
+class Settings;
+class XournalView;
+
+/**
+ * @brief Collects runtime statistics of the rendering pipeline, shows them on top of the pages and/or appends them
+ * to a CSV file. Both are enabled in the settings.
+ *
+ * Every SAMPLE_INTERVAL_MS, a sample is taken of:
+ *   - the number and duration of the frames drawn by the Xournal widget
+ *   - the number of queued jobs of each JobPriority
+ *   - the number and duration of the render and preview jobs executed
+ *   - the hits and misses of the PdfCache
+ *   - the memory used by the page buffers and the PdfCache
+ */
+class PerformanceOverlay {
+public:
+    explicit PerformanceOverlay(XournalView* view);
+    ~PerformanceOverlay();
+
+    PerformanceOverlay(const PerformanceOverlay&) = delete;
+    PerformanceOverlay& operator=(const PerformanceOverlay&) = delete;
+
+public:
+    static constexpr guint SAMPLE_INTERVAL_MS = 500;
+
+    /**
+     * Show / hide the overlay and open / close the CSV file according to the settings
+     */
+    void updateSettings(Settings* settings);
+
+    /**
+     * @return true if the statistics are collected, i.e. the overlay is shown or logged
+     */
+    inline bool isActive() const { return timeout != 0; }
+
+    /**
+     * A frame was drawn by the Xournal widget
+     */
+    void frameDrawn(std::chrono::microseconds duration);
+
+    /**
+     * Paint the overlay, if it is shown. Called at the end of each frame.
+     * @param x, y The top left corner of the visible area, in widget coordinates
+     */
+    void paint(cairo_t* cr, int x, int y);
+
+private:
+    struct Sample {
+        size_t frames = 0;
+        std::chrono::microseconds frameAverage{};
+        std::chrono::microseconds frameMax{};
+
+        std::array<size_t, JOB_N_PRIORITIES> queued{};
+
+        size_t renderJobs = 0;
+        std::chrono::microseconds renderAverage{};
+        std::chrono::microseconds renderMax{};
+        size_t previewJobs = 0;
+        std::chrono::microseconds previewAverage{};
+        std::chrono::microseconds previewMax{};
+
+        size_t pdfHits = 0;
+        size_t pdfMisses = 0;
+
+        size_t pageBufferBytes = 0;
+        size_t pdfCacheBytes = 0;
+    };
+
+    static bool sampleTimer(PerformanceOverlay* self);
+    void takeSample();
+    void writeCsv();
+    std::vector<std::string> formatSample() const;
+    void queueRepaint();
+
+private:
+    XournalView* view;
+
+    bool shown = false;
+    std::ofstream log;
+    guint timeout = 0;
+
+    std::vector<std::chrono::microseconds> frameTimes;
+    size_t totalPdfHits = 0;
+    size_t totalPdfMisses = 0;
+    Sample sample;
+
+    /// Area of the widget covered by the last painted overlay
+    GdkRectangle paintedArea{};
+};
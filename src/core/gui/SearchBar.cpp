@@ -9,6 +9,7 @@
 
 #include "control/Control.h"           // for Control
 #include "control/ScrollHandler.h"     // for ScrollHandler
+#include "control/SearchIndex.h"       // for SearchIndex
 #include "control/zoom/ZoomControl.h"  // for ZoomControl
 #include "gui/MainWindow.h"            // for MainWindow
 #include "model/Document.h"            // for Document
@@ -66,6 +67,11 @@ auto SearchBar::searchTextonCurrentPage(const char* text, size_t index, size_t*
     return control->searchTextOnPage(text, p, index, occurrences, matchRect);
 }
 
+auto SearchBar::pageMayContain(const char* text, size_t p) -> bool {
+    PageRef pageRef = control->getDocument()->getPage(p);
+    return !pageRef || control->getSearchIndex()->mayContain(pageRef, text);
+}
+
 void SearchBar::search(const char* text) {
     MainWindow* win = control->getWindow();
     GtkWidget* lbSearchState = win->get("lbSearchState");
@@ -121,7 +127,12 @@ void SearchBar::search(Fun next) {
     // Search backwards through the pages, wrapping around if needed.
     for (;;) {
         next(text);
-        const bool found = control->searchTextOnPage(text, page, indexInPage, &occurrences, &matchRect);
+        bool found = false;
+        if (pageMayContain(text, page)) {
+            found = control->searchTextOnPage(text, page, indexInPage, &occurrences, &matchRect);
+        } else {
+            occurrences = 0;
+        }
 
         if (found) {
             control->getScrollHandler()->scrollToPage(page, matchRect);
@@ -144,7 +155,9 @@ void SearchBar::searchNext() {
     search([&](const char* text) {
         indexInPage++;
         if (indexInPage > occurrences) {
-            control->searchTextOnPage(text, page, 1, &occurrences, nullptr);  // clear the active marker
+            if (occurrences > 0) {
+                control->searchTextOnPage(text, page, 1, &occurrences, nullptr);  // clear the active marker
+            }
             page++;
             if (page >= pageCount) {
                 page = 0;
@@ -159,12 +172,17 @@ void SearchBar::searchPrevious() {
     search([&](const char* text) {
         indexInPage--;
         if (indexInPage == 0 || indexInPage >= occurrences) {
-            control->searchTextOnPage(text, page, 1, &occurrences, nullptr);  // clear the active marker
+            if (occurrences > 0) {
+                control->searchTextOnPage(text, page, 1, &occurrences, nullptr);  // clear the active marker
+            }
             page--;
             if (page > pageCount) {
                 page = pageCount - 1;
             }
-            control->searchTextOnPage(text, page, 1, &occurrences, nullptr);
+            occurrences = 0;
+            if (pageMayContain(text, page)) {
+                control->searchTextOnPage(text, page, 1, &occurrences, nullptr);
+            }
             indexInPage = occurrences;
         }
     });
@@ -175,6 +193,8 @@ void SearchBar::showSearchBar(bool show) {
     GtkWidget* searchBar = win->get("searchBar");
 
     if (show) {
+        // Usually indexed since the file was loaded, but the PDF background may have been replaced since
+        control->updateSearchIndex();
         GtkWidget* searchTextField = win->get("searchTextField");
         gtk_widget_show_all(searchBar);
         gtk_widget_grab_focus(searchTextField);
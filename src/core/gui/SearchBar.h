@@ -56,6 +56,11 @@ private:
     void search(const char* text);
     bool searchTextonCurrentPage(const char* text, size_t index, size_t* occurrences, XojPdfRectangle* matchRect);
 
+    /**
+     * @return false if the page is known to contain no match (from the search index), so that it can be skipped
+     */
+    bool pageMayContain(const char* text, size_t p);
+
 private:
     Control* control;
     GtkCssProvider* cssTextFild;
@@ -41,10 +41,11 @@
 #include "util/glib_casts.h"                     // for wrap_v
 #include "util/safe_casts.h"                     // for round_cast
 
-#include "Layout.h"           // for Layout
-#include "PageView.h"         // for XojPageView
-#include "RepaintHandler.h"   // for RepaintHandler
-#include "XournalppCursor.h"  // for XournalppCursor
+#include "Layout.h"              // for Layout
+#include "PageView.h"            // for XojPageView
+#include "PerformanceOverlay.h"  // for PerformanceOverlay
+#include "RepaintHandler.h"      // for RepaintHandler
+#include "XournalppCursor.h"     // for XournalppCursor
 
 using xoj::util::Rectangle;
 
@@ -82,6 +83,8 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
 
     this->repaintHandler = std::make_unique<RepaintHandler>(this);
     this->handRecognition = std::make_unique<HandRecognition>(this->widget, inputContext, control->getSettings());
+    this->performanceOverlay = std::make_unique<PerformanceOverlay>(this);
+    this->performanceOverlay->updateSettings(control->getSettings());
 
     control->getZoomControl()->addZoomListener(this);
 
@@ -95,6 +98,7 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
 
 XournalView::~XournalView() {
     g_source_remove(this->cleanupTimeout);
+    this->performanceOverlay.reset();
 
     gtk_widget_destroy(this->widget);
     this->widget = nullptr;
@@ -349,6 +353,7 @@ void XournalView::onSettingsChanged() {
     if (this->cache) {
         this->cache->updateSettings(control->getSettings());
     }
+    this->performanceOverlay->updateSettings(control->getSettings());
 }
 
 // send the focus back to the appropriate widget
@@ -537,6 +542,8 @@ auto XournalView::getHandRecognition() const -> HandRecognition* { return handRe
  */
 auto XournalView::getScrollHandling() const -> ScrollHandling* { return scrollHandling; }
 
+auto XournalView::getPerformanceOverlay() const -> PerformanceOverlay* { return performanceOverlay.get(); }
+
 auto XournalView::getWidget() const -> GtkWidget* { return widget; }
 
 void XournalView::ensureRectIsVisible(int x, int y, int width, int height) {
@@ -579,6 +586,8 @@ void XournalView::zoomChanged() {
     // and if user clicked the selection again, the floating toolbox shows again
     control->getWindow()->getPdfToolbox()->hide();
 
+    // Full resolution passes for the previous zoom are outdated
+    this->control->getScheduler()->removeRefinements();
     this->control->getScheduler()->blockRerenderZoom();
 }
 
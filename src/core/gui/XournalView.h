@@ -39,6 +39,7 @@ class RepaintHandler;
 class ScrollHandling;
 class TextEditor;
 class HandRecognition;
+class PerformanceOverlay;
 namespace xoj::util {
 template <class T>
 class Rectangle;
@@ -128,6 +129,11 @@ public:
      */
     ScrollHandling* getScrollHandling() const;
 
+    /**
+     * @return Statistics shown on top of the pages, if enabled in the settings
+     */
+    PerformanceOverlay* getPerformanceOverlay() const;
+
 public:
     // ZoomListener interface
     void zoomChanged() override;
@@ -190,5 +196,10 @@ private:
      */
     std::unique_ptr<HandRecognition> handRecognition;
 
+    /**
+     * Frame times, job queues and cache statistics
+     */
+    std::unique_ptr<PerformanceOverlay> performanceOverlay;
+
     friend class Layout;
 };
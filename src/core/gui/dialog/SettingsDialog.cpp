@@ -389,6 +389,8 @@ void SettingsDialog::load() {
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(sbStabilizerMass), settings->getStabilizerMass());
     GtkWidget* sbStabilizerSigma = builder.get("sbStabilizerSigma");
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(sbStabilizerSigma), settings->getStabilizerSigma());
+    GtkWidget* sbStrokePredictionTime = builder.get("sbStrokePredictionTime");
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(sbStrokePredictionTime), settings->getStrokePredictionTime());
 
     GtkComboBox* cbStabilizerAveragingMethods = GTK_COMBO_BOX(builder.get("cbStabilizerAveragingMethods"));
     gtk_combo_box_set_active(cbStabilizerAveragingMethods, static_cast<int>(settings->getStabilizerAveragingMethod()));
@@ -576,6 +578,8 @@ void SettingsDialog::load() {
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("preloadPagesAfter")),
                               static_cast<double>(settings->getPreloadPagesAfter()));
     loadCheckbox("cbEagerPageCleanup", settings->isEagerPageCleanup());
+    loadCheckbox("cbPerformanceOverlay", settings->isPerformanceOverlayShown());
+    loadCheckbox("cbPerformanceLog", settings->isPerformanceLogEnabled());
 
     disableWithCheckbox("cbUnlimitedScrolling", "cbAddVerticalSpace");
     disableWithCheckbox("cbUnlimitedScrolling", "cbAddHorizontalSpace");
@@ -731,6 +735,8 @@ void SettingsDialog::save() {
     settings->setStabilizerSigma(gtk_spin_button_get_value(GTK_SPIN_BUTTON(builder.get("sbStabilizerSigma"))));
     settings->setStabilizerCuspDetection(getCheckbox("cbStabilizerEnableCuspDetection"));
     settings->setStabilizerFinalizeStroke(getCheckbox("cbStabilizerEnableFinalizeStroke"));
+    settings->setStrokePredictionTime(static_cast<unsigned int>(
+            gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(builder.get("sbStrokePredictionTime")))));
 
     settings->setSidebarNumberingStyle(static_cast<SidebarNumberingStyle>(
             gtk_combo_box_get_active(GTK_COMBO_BOX(builder.get("cbSidebarPageNumberStyle")))));
@@ -837,6 +843,8 @@ void SettingsDialog::save() {
     settings->setPreloadPagesAfter(preloadPagesAfter);
     settings->setPreloadPagesBefore(preloadPagesBefore);
     settings->setEagerPageCleanup(getCheckbox("cbEagerPageCleanup"));
+    settings->setPerformanceOverlayShown(getCheckbox("cbPerformanceOverlay"));
+    settings->setPerformanceLogEnabled(getCheckbox("cbPerformanceLog"));
 
     settings->setDefaultSaveName(gtk_entry_get_text(GTK_ENTRY(builder.get("txtDefaultSaveName"))));
     settings->setDefaultPdfExportName(gtk_entry_get_text(GTK_ENTRY(builder.get("txtDefaultPdfName"))));
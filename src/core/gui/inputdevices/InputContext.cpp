@@ -5,6 +5,7 @@
 #include "InputContext.h"
 
 #include <cstddef>  // for NULL
+#include <utility>  // for move
 #include <vector>   // for vector
 
 #include <glib-object.h>  // for g_signal_hand...
@@ -21,10 +22,12 @@
 #include "gui/inputdevices/TouchDrawingInputHandler.h"  // for TouchDrawingI...
 #include "gui/inputdevices/TouchInputHandler.h"         // for TouchInputHan...
 #include "util/Assert.h"                                // for xoj_assert
+#include "util/Trace.h"                                 // for XOJ_TRACE_SCOPE
 #include "util/glib_casts.h"                            // for wrap_for_g_callback
 
-#include "InputEvents.h"   // for InputEvent
-#include "config-debug.h"  // for DEBUG_INPUT
+#include "InputEvents.h"     // for InputEvent
+#include "InputRecording.h"  // for InputRecorder
+#include "config-debug.h"    // for DEBUG_INPUT
 
 class ScrollHandling;
 class ToolHandler;
@@ -113,6 +116,16 @@ auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
         this->getSettings()->transactionEnd();
     }
 
+    if (this->recorder) {
+        this->recorder->record(event);
+    }
+
+    return handle(event);
+}
+
+auto InputContext::handle(InputEvent const& event) -> bool {
+    XOJ_TRACE_SCOPE("InputContext::handle", "input");
+
     // We do not handle scroll events manually but let GTK do it for us
     if (event.type == SCROLL_EVENT) {
         // Hand over to standard GTK Scroll / Zoom handling
@@ -188,6 +201,8 @@ void InputContext::setGeometryToolInputHandler(std::unique_ptr<GeometryToolInput
 
 void InputContext::resetGeometryToolInputHandler() { this->geometryToolInputHandler.reset(); }
 
+void InputContext::setRecorder(std::unique_ptr<InputRecorder> recorder) { this->recorder = std::move(recorder); }
+
 auto InputContext::getModifierState() -> GdkModifierType { return this->modifierState; }
 
 /**
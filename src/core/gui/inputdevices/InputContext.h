@@ -23,6 +23,7 @@
 #include "gui/widgets/XournalWidget.h"  // for GtkXournal
 
 class GeometryToolInputHandler;
+class InputRecorder;
 class KeyboardInputHandler;
 class MouseInputHandler;
 class ScrollHandling;
@@ -32,6 +33,7 @@ class ToolHandler;
 class TouchDrawingInputHandler;
 class TouchInputHandler;
 class XournalView;
+struct InputEvent;
 
 class InputContext {
 
@@ -43,6 +45,7 @@ private:
     KeyboardInputHandler* keyboardHandler;
     TouchInputHandler* touchHandler;
     std::unique_ptr<GeometryToolInputHandler> geometryToolInputHandler;
+    std::unique_ptr<InputRecorder> recorder;
 
     GtkWidget* widget = nullptr;
     XournalView* view;
@@ -86,6 +89,14 @@ private:
     void printDebug(GdkEvent* event);
 
 public:
+    /**
+     * Dispatch an already translated event to the input handlers.
+     * Used by the input replay, which does not go through GTK.
+     * @param event The event to handle
+     * @return Whether the event was handled
+     */
+    bool handle(InputEvent const& event);
+
     /**
      * Connect the input handling to the window to receive events
      */
@@ -99,6 +110,11 @@ public:
     void setGeometryToolInputHandler(std::unique_ptr<GeometryToolInputHandler> handler);
     void resetGeometryToolInputHandler();
 
+    /**
+     * Record all following input events, replaces the current recorder. nullptr stops recording.
+     */
+    void setRecorder(std::unique_ptr<InputRecorder> recorder);
+
     GdkModifierType getModifierState();
     void focusWidget();
     void blockDevice(DeviceType deviceType);
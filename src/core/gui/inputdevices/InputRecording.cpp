@@ -0,0 +1,74 @@
+#include "InputRecording.h"
+
+#include <limits>   // for numeric_limits
+#include <sstream>  // for istringstream, ostringstream
+
+#include <glib.h>  // for g_warning
+
+#include "util/serdesstream.h"  // for serdes_stream
+
+auto InputRecording::format(const RecordedEvent& event) -> std::string {
+    auto out = serdes_stream<std::ostringstream>();
+    out.precision(std::numeric_limits<double>::max_digits10);
+    out << event.time << " " << event.type << " " << event.deviceClass << " " << event.x << " " << event.y << " "
+        << event.absoluteX << " " << event.absoluteY << " " << event.pressure << " " << event.button << " "
+        << event.state << " " << event.sequence << " " << event.timestamp << " " << event.deviceName;
+    return out.str();
+}
+
+auto InputRecording::parse(const std::string& line, RecordedEvent& event) -> bool {
+    auto in = serdes_stream<std::istringstream>(line);
+    int type = 0;
+    int deviceClass = 0;
+    in >> event.time >> type >> deviceClass >> event.x >> event.y >> event.absoluteX >> event.absoluteY >>
+            event.pressure >> event.button >> event.state >> event.sequence >> event.timestamp;
+    if (!in || type < UNKNOWN || type > KEY_RELEASE_EVENT || deviceClass < INPUT_DEVICE_MOUSE ||
+        deviceClass > INPUT_DEVICE_IGNORE) {
+        return false;
+    }
+    event.type = static_cast<InputEventType>(type);
+    event.deviceClass = static_cast<InputDeviceClass>(deviceClass);
+
+    // The device name is the rest of the line, it may contain spaces
+    in >> std::ws;
+    std::getline(in, event.deviceName);
+    return true;
+}
+
+InputRecorder::InputRecorder(const fs::path& file):
+        out(serdes_stream<std::ofstream>(file)), start(std::chrono::steady_clock::now()) {
+    if (!out) {
+        g_warning("Could not open the input recording %s", file.u8string().c_str());
+        return;
+    }
+    out << InputRecording::HEADER << "\n";
+}
+
+auto InputRecorder::isOpen() const -> bool { return out.is_open(); }
+
+void InputRecorder::record(const InputEvent& event) {
+    // Typed text is never written to a recording
+    if (event.type == UNKNOWN || event.type == KEY_PRESS_EVENT || event.type == KEY_RELEASE_EVENT) {
+        return;
+    }
+
+    RecordedEvent r;
+    r.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    r.type = event.type;
+    r.deviceClass = event.deviceClass;
+    r.x = event.relativeX;
+    r.y = event.relativeY;
+    r.absoluteX = event.absoluteX;
+    r.absoluteY = event.absoluteY;
+    r.pressure = event.pressure;
+    r.button = event.button;
+    r.state = event.state;
+    if (event.sequence) {
+        r.sequence = sequences.emplace(event.sequence, sequences.size() + 1).first->second;
+    }
+    r.timestamp = event.timestamp;
+    r.deviceName = event.deviceName ? event.deviceName : "";
+
+    // Flushed per event, the recording should survive a crash
+    out << InputRecording::format(r) << std::endl;
+}
@@ -0,0 +1,92 @@
+/*
+ * Xournal++
+ *
+ * Records input events to a file, to replay them later
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <chrono>         // for steady_clock
+#include <cstdint>        // for int64_t, uint64_t
+#include <fstream>        // for ofstream
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+
+#include <gdk/gdk.h>  // for GdkEventSequence
+#include <glib.h>     // for guint, guint32
+
+#include "InputEvents.h"  // for InputEventType, InputDeviceClass
+#include "filesystem.h"   // for path
+
+struct InputEvent;
+
+/**
+ * An input event as stored in a recording
+ */
+struct RecordedEvent {
+    /// Time since the start of the recording, in microseconds
+    int64_t time = 0;
+
+    InputEventType type = UNKNOWN;
+    InputDeviceClass deviceClass = INPUT_DEVICE_IGNORE;
+
+    /// Coordinates relative to the Xournal widget
+    double x = 0;
+    double y = 0;
+    double absoluteX = 0;
+    double absoluteY = 0;
+    double pressure = Point::NO_PRESSURE;
+
+    guint button = 0;
+    guint state = 0;
+    /// Touch sequence, numbered from 1 in the order of appearance. 0 for events without sequence.
+    uint64_t sequence = 0;
+    guint32 timestamp = 0;
+
+    std::string deviceName;
+};
+
+namespace InputRecording {
+constexpr auto HEADER = "xournalpp-input-recording 1";
+
+/**
+ * @return The event as one line of a recording, without line break
+ */
+std::string format(const RecordedEvent& event);
+
+/**
+ * @brief Parse a line of a recording
+ * @return false if the line is not a valid event
+ */
+bool parse(const std::string& line, RecordedEvent& event);
+};  // namespace InputRecording
+
+/**
+ * @brief Writes all pointer, pen and touch events received by the InputContext to a file.
+ *
+ * The coordinates are stored relative to the Xournal widget, so a recording only reproduces the same strokes if it is
+ * replayed with the same document, window size, zoom and scroll position.
+ */
+class InputRecorder {
+public:
+    explicit InputRecorder(const fs::path& file);
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+public:
+    /// @return false if the file could not be opened
+    bool isOpen() const;
+
+    void record(const InputEvent& event);
+
+private:
+    std::ofstream out;
+    std::chrono::steady_clock::time_point start;
+    std::unordered_map<GdkEventSequence*, uint64_t> sequences;
+};
@@ -0,0 +1,208 @@
+#include "InputReplay.h"
+
+#include <algorithm>  // for sort, max, min
+#include <cstdint>    // for uintptr_t
+#include <cstdio>     // for snprintf
+#include <fstream>    // for ifstream
+#include <utility>    // for move, make_pair
+
+#include <gdk/gdk.h>  // for gdk_event_new, GdkDevice, gdk_seat_get_slaves
+#include <glib.h>     // for g_timeout_add, g_idle_add, g_list_free
+
+#include "util/glib_casts.h"    // for wrap_for_once_v
+#include "util/safe_casts.h"    // for as_unsigned
+#include "util/serdesstream.h"  // for serdes_stream
+
+#include "InputContext.h"  // for InputContext
+#include "InputEvents.h"   // for InputEvent, InputEvents
+
+namespace {
+auto toGdkEventType(InputEventType type, InputDeviceClass deviceClass) -> GdkEventType {
+    bool touch = deviceClass == INPUT_DEVICE_TOUCHSCREEN;
+    switch (type) {
+        case BUTTON_PRESS_EVENT:
+            return touch ? GDK_TOUCH_BEGIN : GDK_BUTTON_PRESS;
+        case BUTTON_2_PRESS_EVENT:
+            return GDK_DOUBLE_BUTTON_PRESS;
+        case BUTTON_3_PRESS_EVENT:
+            return GDK_TRIPLE_BUTTON_PRESS;
+        case BUTTON_RELEASE_EVENT:
+            return touch ? GDK_TOUCH_END : GDK_BUTTON_RELEASE;
+        case MOTION_EVENT:
+            return touch ? GDK_TOUCH_UPDATE : GDK_MOTION_NOTIFY;
+        case ENTER_EVENT:
+            return GDK_ENTER_NOTIFY;
+        case LEAVE_EVENT:
+            return GDK_LEAVE_NOTIFY;
+        case PROXIMITY_IN_EVENT:
+            return GDK_PROXIMITY_IN;
+        case PROXIMITY_OUT_EVENT:
+            return GDK_PROXIMITY_OUT;
+        case SCROLL_EVENT:
+            return GDK_SCROLL;
+        case GRAB_BROKEN_EVENT:
+            return GDK_GRAB_BROKEN;
+        default:
+            return GDK_NOTHING;
+    }
+}
+
+/**
+ * Nearest-rank percentile of sorted values
+ */
+auto percentile(const std::vector<int64_t>& sorted, int p) -> int64_t {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = (sorted.size() * static_cast<size_t>(p) + 99) / 100;
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+};  // namespace
+
+InputReplay::InputReplay(std::vector<RecordedEvent> events, InputContext* context):
+        events(std::move(events)), context(context) {}
+
+auto InputReplay::load(const fs::path& file, InputContext* context) -> std::unique_ptr<InputReplay> {
+    auto in = serdes_stream<std::ifstream>(file);
+    std::string line;
+    if (!std::getline(in, line) || line != InputRecording::HEADER) {
+        g_warning("%s is not an input recording", file.u8string().c_str());
+        return nullptr;
+    }
+
+    std::vector<RecordedEvent> events;
+    for (size_t lineNr = 2; std::getline(in, line); lineNr++) {
+        if (line.empty()) {
+            continue;
+        }
+        RecordedEvent event;
+        if (!InputRecording::parse(line, event)) {
+            g_warning("Invalid event in the input recording %s, line %zu", file.u8string().c_str(), lineNr);
+            return nullptr;
+        }
+        events.push_back(std::move(event));
+    }
+
+    return std::unique_ptr<InputReplay>(new InputReplay(std::move(events), context));
+}
+
+void InputReplay::start(std::function<void()> finished) {
+    this->finished = std::move(finished);
+    this->next = 0;
+    this->handleTimes.clear();
+    this->latencies.clear();
+    this->handleTimes.reserve(events.size());
+    this->latencies.reserve(events.size());
+    this->start = std::chrono::steady_clock::now();
+    scheduleNext();
+}
+
+void InputReplay::scheduleNext() {
+    if (next >= events.size()) {
+        g_idle_add(xoj::util::wrap_for_once_v<step>, this);
+        return;
+    }
+
+    auto due = start + std::chrono::microseconds(events[next].time);
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(due - std::chrono::steady_clock::now());
+    if (delay.count() > 0) {
+        g_timeout_add(as_unsigned(delay.count()), xoj::util::wrap_for_once_v<step>, this);
+    } else {
+        g_idle_add(xoj::util::wrap_for_once_v<step>, this);
+    }
+}
+
+void InputReplay::step(InputReplay* self) {
+    if (self->next >= self->events.size()) {
+        if (self->finished) {
+            self->finished();
+        }
+        return;
+    }
+
+    const RecordedEvent& r = self->events[self->next++];
+
+    // The handlers only check that there is a source event, its content is not used for pointer events
+    GdkEvent* gdkEvent = gdk_event_new(toGdkEventType(r.type, r.deviceClass));
+    GdkDevice* device = self->getDevice(r);
+    gdk_event_set_device(gdkEvent, device);
+    gdk_event_set_source_device(gdkEvent, device);
+
+    InputEvent event;
+    event.sourceEvent = gdkEvent;
+    gdk_event_free(gdkEvent);
+    event.type = r.type;
+    event.deviceClass = r.deviceClass;
+    event.deviceName = r.deviceName.c_str();
+    event.absoluteX = r.absoluteX;
+    event.absoluteY = r.absoluteY;
+    event.relativeX = r.x;
+    event.relativeY = r.y;
+    event.button = r.button;
+    event.state = static_cast<GdkModifierType>(r.state);
+    event.pressure = r.pressure;
+    // Only compared to each other, never dereferenced
+    event.sequence = reinterpret_cast<GdkEventSequence*>(static_cast<uintptr_t>(r.sequence));
+    event.timestamp = r.timestamp;
+    event.deviceId = DeviceId(device);
+
+    auto due = self->start + std::chrono::microseconds(r.time);
+    auto before = std::chrono::steady_clock::now();
+    self->context->handle(event);
+    auto after = std::chrono::steady_clock::now();
+
+    using std::chrono::duration_cast, std::chrono::microseconds;
+    self->handleTimes.push_back(duration_cast<microseconds>(after - before).count());
+    self->latencies.push_back(duration_cast<microseconds>(after - std::min(due, before)).count());
+
+    self->scheduleNext();
+}
+
+auto InputReplay::getDevice(const RecordedEvent& r) -> GdkDevice* {
+    auto key = std::make_pair(r.deviceClass, r.deviceName);
+    if (auto it = devices.find(key); it != devices.end()) {
+        return it->second;
+    }
+
+    GdkSeat* seat = gdk_display_get_default_seat(gdk_display_get_default());
+    GList* slaves = gdk_seat_get_slaves(seat, GDK_SEAT_CAPABILITY_ALL_POINTING);
+    GdkDevice* byName = nullptr;
+    GdkDevice* byClass = nullptr;
+    for (GList* l = slaves; l != nullptr; l = l->next) {
+        auto* dev = static_cast<GdkDevice*>(l->data);
+        if (!byName && r.deviceName == gdk_device_get_name(dev)) {
+            byName = dev;
+        }
+        if (!byClass && InputEvents::translateDeviceType(dev, context->getSettings()) == r.deviceClass) {
+            byClass = dev;
+        }
+    }
+    g_list_free(slaves);
+
+    GdkDevice* device = byName ? byName : byClass;
+    if (!device) {
+        device = gdk_seat_get_pointer(seat);
+        g_warning("No device like \"%s\" found, its events are replayed with \"%s\"", r.deviceName.c_str(),
+                  gdk_device_get_name(device));
+    }
+    devices.emplace(std::move(key), device);
+    return device;
+}
+
+auto InputReplay::report() const -> std::string {
+    auto line = [](const char* name, std::vector<int64_t> values) {
+        std::sort(values.begin(), values.end());
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%-8s %8lld %8lld %8lld %8lld %8zu\n", name,
+                 static_cast<long long>(percentile(values, 50)), static_cast<long long>(percentile(values, 90)),
+                 static_cast<long long>(percentile(values, 99)), static_cast<long long>(percentile(values, 100)),
+                 values.size());
+        return std::string(buffer);
+    };
+
+    std::string out = "Input replay, durations in microseconds\n";
+    out += "              p50      p90      p99      max    count\n";
+    out += line("handle", handleTimes);
+    out += line("latency", latencies);
+    return out;
+}
@@ -0,0 +1,89 @@
+/*
+ * Xournal++
+ *
+ * Replays a recorded input sequence and measures the input latency
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <chrono>      // for steady_clock
+#include <cstdint>     // for int64_t
+#include <functional>  // for function
+#include <map>         // for map
+#include <memory>      // for unique_ptr
+#include <string>      // for string
+#include <utility>     // for pair
+#include <vector>      // for vector
+
+#include <gdk/gdk.h>  // for GdkDevice
+
+#include "InputRecording.h"  // for RecordedEvent
+#include "filesystem.h"      // for path
+
+class InputContext;
+
+/**
+ * @brief Feeds a recording of InputRecorder through InputContext::handle, with the original timing.
+ *
+ * Each event is dispatched from the main loop at the time it was recorded. Rendering and other work done by the main
+ * loop in between delays the following events, just like real input would be delayed. For each event, two durations
+ * are measured:
+ *   "handle": the time spent in the input handlers
+ *   "latency": the time from the moment the event was due until it was handled
+ *
+ * Each recorded device is mapped to a device of the default seat with the same name, or else with the same device
+ * class in the settings, so that the events of a pen and of a touchscreen can be told apart. Without such a device,
+ * its events come from the seat's pointer.
+ *
+ * Keyboard events are not part of recordings, the replay does not need a tablet or a keyboard and runs on a virtual
+ * display (e.g. xvfb-run) in CI.
+ */
+class InputReplay {
+public:
+    /**
+     * @brief Load a recording
+     * @return nullptr if the file could not be read
+     */
+    static std::unique_ptr<InputReplay> load(const fs::path& file, InputContext* context);
+
+    /**
+     * Start replaying the events, `finished` is called from the main loop after the last one
+     */
+    void start(std::function<void()> finished);
+
+    /**
+     * @return The percentiles of the measured durations, in a human readable table
+     */
+    std::string report() const;
+
+private:
+    InputReplay(std::vector<RecordedEvent> events, InputContext* context);
+
+    static void step(InputReplay* self);
+    void scheduleNext();
+
+    /**
+     * @return The device of the default seat replaying the events of the recorded device
+     */
+    GdkDevice* getDevice(const RecordedEvent& r);
+
+private:
+    std::vector<RecordedEvent> events;
+    size_t next = 0;
+    InputContext* context;
+    std::function<void()> finished;
+
+    /// Replaying device of each recorded device class and name
+    std::map<std::pair<InputDeviceClass, std::string>, GdkDevice*> devices;
+
+    std::chrono::steady_clock::time_point start;
+
+    /// Durations for each replayed event, in microseconds
+    std::vector<int64_t> handleTimes;
+    std::vector<int64_t> latencies;
+};
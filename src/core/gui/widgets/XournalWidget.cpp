@@ -1,6 +1,7 @@
 #include "XournalWidget.h"
 
 #include <algorithm>  // for max
+#include <chrono>     // for steady_clock, duration_cast
 #include <cmath>      // for NAN
 #include <optional>   // for optional
 #include <vector>     // for vector
@@ -14,12 +15,14 @@
 #include "gui/Layout.h"                     // for Layout
 #include "gui/LegacyRedrawable.h"           // for Redrawable
 #include "gui/PageView.h"                   // for XojPageView
+#include "gui/PerformanceOverlay.h"         // for PerformanceOverlay
 #include "gui/Shadow.h"                     // for Shadow
 #include "gui/XournalView.h"                // for XournalView
 #include "gui/inputdevices/InputContext.h"  // for InputContext
 #include "gui/scroll/ScrollHandling.h"      // for ScrollHandling
 #include "util/Color.h"                     // for cairo_set_source_rgbi
 #include "util/Rectangle.h"                 // for Rectangle
+#include "util/Trace.h"                     // for XOJ_TRACE_SCOPE
 
 
 using xoj::util::Rectangle;
@@ -248,6 +251,9 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
 
     GtkXournal* xournal = GTK_XOURNAL(widget);
 
+    XOJ_TRACE_SCOPE("XournalWidget::draw", "gui");
+    auto frameStart = std::chrono::steady_clock::now();
+
     double x1 = NAN, x2 = NAN, y1 = NAN, y2 = NAN;
 
     cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
@@ -290,6 +296,14 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
         cairo_restore(cr);
     }
 
+    if (PerformanceOverlay* overlay = xournal->view->getPerformanceOverlay(); overlay && overlay->isActive()) {
+        overlay->frameDrawn(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                  frameStart));
+        int x = static_cast<int>(gtk_adjustment_get_value(xournal->scrollHandling->getHorizontal()));
+        int y = static_cast<int>(gtk_adjustment_get_value(xournal->scrollHandling->getVertical()));
+        overlay->paint(cr, x, y);
+    }
+
     return true;
 }
 
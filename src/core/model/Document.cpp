@@ -1,11 +1,13 @@
 #include "Document.h"
 
+#include <algorithm>  // for min
 #include <array>
 #include <ctime>  // for size_t, localtime, strf...
 #include <iomanip>
 #include <sstream>
-#include <string>   // for string
-#include <utility>  // for move, pair
+#include <string>        // for string, to_string
+#include <system_error>  // for error_code
+#include <utility>       // for move, pair
 
 #include <glib-object.h>  // for g_object_unref, G_TYPE_...
 
@@ -103,10 +105,12 @@ void Document::clearDocument(bool destroy) {
 
     this->pages.clear();
     this->pageIndex.reset();
+    resetPageNumbers();
     freeTreeContentModel();
 
     this->filepath = fs::path{};
     this->pdfFilepath = fs::path{};
+    this->pdfFingerprint.clear();
 }
 
 /**
@@ -122,6 +126,8 @@ auto Document::getFilepath() const -> fs::path { return filepath; }
 
 auto Document::getPdfFilepath() const -> fs::path { return pdfFilepath; }
 
+auto Document::getPdfFingerprint() const -> const std::string& { return pdfFingerprint; }
+
 auto Document::createSaveFolder(fs::path lastSavePath) -> fs::path {
     if (!filepath.empty()) {
         return filepath.parent_path();
@@ -207,7 +213,7 @@ auto Document::findPdfPage(size_t pdfPage) -> size_t {
     if (pos == this->pageIndex->end()) {
         return npos;
     } else {
-        return pos->second;
+        return indexOf(pos->second);
     }
 }
 
@@ -250,15 +256,51 @@ void Document::buildTreeContentsModel(GtkTreeIter* parent, XojPdfBookmarkIterato
 
 void Document::indexPdfPages() {
     auto index = std::make_unique<PageIndex>();
-    for (size_t i = 0; i < this->pages.size(); ++i) {
-        const auto& p = this->pages[i];
+    for (const auto& p: this->pages) {
         if (p->getBackgroundType().isPdfPage()) {
-            index->emplace(p->getPdfPageNr(), i);
+            index->emplace(p->getPdfPageNr(), p.get());
         }
     }
     this->pageIndex.swap(index);
 }
 
+void Document::indexInsertedPdfPage(const PageRef& p, size_t position) {
+    invalidatePageNumbers(position);
+
+    if (!this->pageIndex || !p->getBackgroundType().isPdfPage()) {
+        return;
+    }
+
+    auto [it, inserted] = this->pageIndex->emplace(p->getPdfPageNr(), p.get());
+    // The index refers to the first page with this pdf background
+    if (!inserted && indexOf(it->second) > position) {
+        it->second = p.get();
+    }
+}
+
+void Document::unindexDeletedPdfPage(const PageRef& p) {
+    if (!this->pageIndex || !p->getBackgroundType().isPdfPage()) {
+        return;
+    }
+
+    auto it = this->pageIndex->find(p->getPdfPageNr());
+    if (it != this->pageIndex->end() && it->second == p.get()) {
+        // Another page may use the same pdf background: rebuild the index lazily
+        this->pageIndex.reset();
+    }
+}
+
+void Document::invalidatePageNumbers(size_t from) {
+    std::lock_guard lock(this->pageNumbersMutex);
+    this->validPageNumbersEnd = std::min(this->validPageNumbersEnd, from);
+}
+
+void Document::resetPageNumbers() {
+    std::lock_guard lock(this->pageNumbersMutex);
+    this->pageNumbers.clear();
+    this->validPageNumbersEnd = 0;
+}
+
 
 void Document::buildContentsModel() {
     freeTreeContentModel();
@@ -305,14 +347,14 @@ void Document::updateIndexPageNumbers() {
     }
 }
 
-auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDocument, gpointer data, gsize length)
-        -> bool {
+auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDocument, GBytes* data,
+                       const std::string& dataFingerprint) -> bool {
     GError* popplerError = nullptr;
 
     lock();
 
     if (data != nullptr) {
-        if (!pdfDocument.load(data, length, password, &popplerError)) {
+        if (!pdfDocument.load(data, password, &popplerError)) {
             lastError = FS(_F("Document not loaded! ({1}), {2}") % filename.u8string() % popplerError->message);
             g_error_free(popplerError);
             unlock();
@@ -336,8 +378,24 @@ auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDo
     this->attachPdf = attachToDocument;
     lastError = "";
 
+    if (data != nullptr && !dataFingerprint.empty()) {
+        this->pdfFingerprint = dataFingerprint;
+    } else if (data != nullptr) {
+        // The name of an attached PDF is the same in all documents
+        gchar* checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, data);
+        this->pdfFingerprint = checksum;
+        g_free(checksum);
+    } else {
+        std::error_code ec;
+        auto size = fs::file_size(filename, ec);
+        auto modificationTime = fs::last_write_time(filename, ec);
+        this->pdfFingerprint = fs::absolute(filename, ec).u8string() + "/" + std::to_string(size) + "/" +
+                               std::to_string(modificationTime.time_since_epoch().count());
+    }
+
     if (initPages) {
         this->pages.clear();
+        resetPageNumbers();
     }
 
     if (initPages) {
@@ -373,38 +431,53 @@ auto Document::getLastErrorMsg() const -> std::string { return lastError; }
 
 void Document::deletePage(size_t pNr) {
     auto it = this->pages.begin() + as_signed(pNr);
+
+    unindexDeletedPdfPage(*it);
+    {
+        std::lock_guard lock(this->pageNumbersMutex);
+        this->pageNumbers.erase(it->get());
+        this->validPageNumbersEnd = std::min(this->validPageNumbersEnd, pNr);
+    }
+
     this->pages.erase(it);
 
-    // Reset the page index
-    this->pageIndex.reset();
     updateIndexPageNumbers();
 }
 
 void Document::insertPage(const PageRef& p, size_t position) {
     this->pages.insert(this->pages.begin() + as_signed(position), p);
 
-    // Reset the page index
-    this->pageIndex.reset();
+    indexInsertedPdfPage(p, position);
     updateIndexPageNumbers();
 }
 
 void Document::addPage(const PageRef& p) {
     this->pages.push_back(p);
 
-    // Reset the page index
-    this->pageIndex.reset();
+    indexInsertedPdfPage(p, this->pages.size() - 1);
     updateIndexPageNumbers();
 }
 
-auto Document::indexOf(const PageRef& page) -> size_t {
-    for (size_t i = 0; i < this->pages.size(); i++) {
-        PageRef pg = this->pages[i];
-        if (pg == page) {
-            return i;
-        }
+auto Document::indexOf(const PageRef& page) const -> size_t { return indexOf(page.get()); }
+
+auto Document::indexOf(const XojPage* page) const -> size_t {
+    std::lock_guard lock(this->pageNumbersMutex);
+    if (auto it = this->pageNumbers.find(page); it != this->pageNumbers.end() && it->second < validPageNumbersEnd) {
+        return it->second;
+    }
+
+    if (validPageNumbersEnd == this->pages.size()) {
+        // All positions are up to date: the page is not part of the document
+        return npos;
+    }
+
+    for (size_t i = validPageNumbersEnd; i < this->pages.size(); i++) {
+        this->pageNumbers[this->pages[i].get()] = i;
     }
+    validPageNumbersEnd = this->pages.size();
 
-    return npos;
+    auto it = this->pageNumbers.find(page);
+    return it == this->pageNumbers.end() ? npos : it->second;
 }
 
 auto Document::getPage(size_t page) const -> PageRef {
@@ -431,9 +504,11 @@ auto Document::operator=(const Document& doc) -> Document& {
     this->password = doc.password;
     this->createBackupOnSave = doc.createBackupOnSave;
     this->pdfFilepath = doc.pdfFilepath;
+    this->pdfFingerprint = doc.pdfFingerprint;
     this->filepath = doc.filepath;
     this->pages = doc.pages;
     this->attachPdf = doc.attachPdf;
+    resetPageNumbers();
 
     indexPdfPages();
     buildContentsModel();
@@ -21,7 +21,7 @@
 #include <vector>         // for vector
 
 #include <cairo.h>    // for cairo_surface_t
-#include <glib.h>     // for gpointer, gsize
+#include <glib.h>     // for GBytes
 #include <gtk/gtk.h>  // for GtkTreeModel, GtkTreeIter, GtkT...
 
 #include "pdf/base/XojPdfDocument.h"  // for XojPdfDocument
@@ -42,8 +42,13 @@ public:
 public:
     enum DocumentType { XOPP, XOJ, PDF };
 
-    bool readPdf(const fs::path& filename, bool initPages, bool attachToDocument, gpointer data = nullptr,
-                 gsize length = 0);
+    /**
+     * Load the background PDF. If data is set, the PDF is read from it (without copying it) instead of the file.
+     * @param dataFingerprint Identifies data, e.g. the CRC32 and size of the zip entry it was read from. If empty, a
+     *                        hash of data is computed, which reads the whole PDF.
+     */
+    bool readPdf(const fs::path& filename, bool initPages, bool attachToDocument, GBytes* data = nullptr,
+                 const std::string& dataFingerprint = "");
 
     size_t getPageCount() const;
     size_t getPdfPageCount() const;
@@ -61,7 +66,18 @@ public:
     static double getPageWidth(PageRef p);
     static double getPageHeight(PageRef p);
 
-    size_t indexOf(const PageRef& page);
+    /**
+     * @return The position of the page in the document, or npos
+     *
+     * Constant time, except for the first lookup after a page was inserted or deleted: it recomputes the positions
+     * of all the pages following that one, in linear time.
+     *
+     * As for the other page accessors, the caller must either hold the document lock or run on the UI thread, which
+     * is the only one modifying the pages. The cached positions have a mutex of their own, so that such concurrent
+     * lookups may update them safely.
+     */
+    size_t indexOf(const PageRef& page) const;
+    size_t indexOf(const XojPage* page) const;
 
     /**
      * @return The last error message to show to the user
@@ -75,6 +91,12 @@ public:
     void setFilepath(fs::path filepath);
     fs::path getFilepath() const;
     fs::path getPdfFilepath() const;
+
+    /**
+     * Identifies the content of the PDF background: the fingerprint of the data of an attached PDF (see readPdf), or
+     * the absolute path, size and modification time of the file it was loaded from. Empty without PDF background.
+     */
+    const std::string& getPdfFingerprint() const;
     fs::path createSaveFolder(fs::path lastSavePath);
     fs::path createSaveFilename(DocumentType type, const std::string& defaultSaveName, const std::string& defaultPfdName = "");
 
@@ -112,6 +134,7 @@ private:
 
     fs::path filepath;
     fs::path pdfFilepath;
+    std::string pdfFingerprint;
     bool attachPdf = false;
 
     /**
@@ -127,9 +150,9 @@ private:
     std::vector<PageRef> pages;
 
     /**
-     * Index from pdf page number to document page number
+     * Index from pdf page number to the first document page with this pdf background
      */
-    using PageIndex = std::unordered_map<size_t, size_t>;
+    using PageIndex = std::unordered_map<size_t, const XojPage*>;
 
     /**
      * The cached page index
@@ -137,12 +160,45 @@ private:
     std::unique_ptr<PageIndex> pageIndex;
 
     /**
-     * Creates an index from pdf page number to document page number
+     * Creates an index from pdf page number to document page
      *
      * Clears the index first in case it is already exists.
      */
     void indexPdfPages();
 
+    /**
+     * Updates the pdf page index after a page has been inserted at the given position
+     */
+    void indexInsertedPdfPage(const PageRef& p, size_t position);
+
+    /**
+     * Updates the pdf page index before the page is removed from the document
+     */
+    void unindexDeletedPdfPage(const PageRef& p);
+
+    /**
+     * The position of each page in the document. Only the positions below validPageNumbersEnd are up to date, the
+     * others are recomputed lazily by indexOf(). Inserting or deleting a page only invalidates the positions of the
+     * subsequent pages.
+     */
+    mutable std::unordered_map<const XojPage*, size_t> pageNumbers;
+    mutable size_t validPageNumbersEnd = 0;
+
+    /**
+     * Protects pageNumbers and validPageNumbersEnd, which indexOf() updates
+     */
+    mutable std::mutex pageNumbersMutex;
+
+    /**
+     * Marks the positions of all pages starting from the given position as out of date
+     */
+    void invalidatePageNumbers(size_t from);
+
+    /**
+     * Forgets all page positions (e.g. after the page list has been replaced)
+     */
+    void resetPageNumbers();
+
     /**
      * The bookmark contents model
      */
@@ -166,7 +222,10 @@ private:
 
 template <class InputIter>
 void Document::addPages(InputIter first, InputIter last) {
+    size_t position = this->pages.size();
     this->pages.insert(this->pages.end(), first, last);
-    this->pageIndex.reset();
+    for (; position < this->pages.size(); ++position) {
+        indexInsertedPdfPage(this->pages[position], position);
+    }
     updateIndexPageNumbers();
 }
@@ -1,6 +1,7 @@
 #include "Text.h"
 
-#include <utility>  // for move
+#include <algorithm>  // for find_if
+#include <utility>    // for move
 
 #include <glib.h>  // for g_warning
 #include <pango/pangocairo.h>
@@ -53,18 +54,20 @@ auto Text::getFontName() const -> std::string { return font.getName(); }
 auto Text::getText() const -> const std::string& { return this->text; }
 
 void Text::setText(std::string text) {
+    std::lock_guard lock(this->layoutMutex);
     this->text = std::move(text);
+    this->textVersion++;
     sizeCalculated = false;
 }
 
 void Text::calcSize() const {
-    auto layout = createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
-    int w = 0;
-    int h = 0;
-    pango_layout_get_size(layout.get(), &w, &h);
-    this->width = (static_cast<double>(w)) / PANGO_SCALE;
-    this->height = (static_cast<double>(h)) / PANGO_SCALE;
+    usePangoLayout([&](PangoLayout* layout) {
+        int w = 0;
+        int h = 0;
+        pango_layout_get_size(layout, &w, &h);
+        this->width = (static_cast<double>(w)) / PANGO_SCALE;
+        this->height = (static_cast<double>(h)) / PANGO_SCALE;
+    });
     this->updateSnapping();
 }
 
@@ -94,6 +97,30 @@ auto Text::createPangoLayout() const -> xoj::util::GObjectSPtr<PangoLayout> {
     return layout;
 }
 
+auto Text::getCachedLayoutUnlocked() const -> PangoLayout* {
+    const auto thread = std::this_thread::get_id();
+    auto it = std::find_if(this->layouts.begin(), this->layouts.end(),
+                           [&](const CachedLayout& l) { return l.thread == thread; });
+    if (it == this->layouts.end()) {
+        // Created like the layout of the TextEditor, so that the text has the same size once edition is over
+        auto layout = createPangoLayout();
+        pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
+        this->layouts.push_back({thread, std::move(layout), this->font, this->textVersion});
+        return this->layouts.back().layout.get();
+    }
+
+    if (it->textVersion != this->textVersion) {
+        pango_layout_set_text(it->layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
+        it->textVersion = this->textVersion;
+    }
+    if (it->font.getName() != this->font.getName() || it->font.getSize() != this->font.getSize()) {
+        // The font can be modified through getFont() or scale()
+        updatePangoFont(it->layout.get());
+        it->font = this->font;
+    }
+    return it->layout.get();
+}
+
 void Text::updatePangoFont(PangoLayout* layout) const {
     PangoFontDescription* desc = pango_font_description_from_string(this->getFontName().c_str());
     pango_font_description_set_absolute_size(desc, this->getFontSize() * PANGO_SCALE);
@@ -159,7 +186,11 @@ void Text::readSerialized(ObjectInputStream& in) {
 
     this->AudioElement::readSerialized(in);
 
-    this->text = in.readString();
+    {
+        std::lock_guard lock(this->layoutMutex);
+        this->text = in.readString();
+        this->textVersion++;
+    }
 
     font.readSerialized(in);
 
@@ -176,29 +207,36 @@ auto Text::findText(const std::string& search) const -> std::vector<XojPdfRectan
         return {};
     }
 
-    auto layout = this->createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
-
-
     std::string text = StringUtils::toLowerCase(this->text);
 
     std::string pattern = StringUtils::toLowerCase(search);
 
     std::vector<XojPdfRectangle> list;
 
-    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
-        XojPdfRectangle mark;
-        PangoRectangle rect = {0};
-        pango_layout_index_to_pos(layout.get(), static_cast<int>(pos), &rect);
-        mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + this->getX();
-        mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + this->getY();
-
-        pango_layout_index_to_pos(layout.get(), static_cast<int>(pos + patternLength - 1), &rect);
-        mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + this->getX();
-        mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + this->getY();
-
-        list.push_back(mark);
+    size_t pos = text.find(pattern);
+    if (pos == std::string::npos) {
+        return list;
     }
 
+    // May compute the size, which requires the layout: do it before locking it
+    const double x = this->getX();
+    const double y = this->getY();
+
+    usePangoLayout([&](PangoLayout* layout) {
+        for (; pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+            XojPdfRectangle mark;
+            PangoRectangle rect = {0};
+            pango_layout_index_to_pos(layout, static_cast<int>(pos), &rect);
+            mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + x;
+            mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + y;
+
+            pango_layout_index_to_pos(layout, static_cast<int>(pos + patternLength - 1), &rect);
+            mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + x;
+            mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + y;
+
+            list.push_back(mark);
+        }
+    });
+
     return list;
 }
@@ -11,7 +11,10 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <mutex>    // for mutex, lock_guard
+#include <string>   // for string
+#include <thread>   // for thread
 #include <vector>
 
 #include <pango/pango.h>
@@ -49,6 +52,16 @@ public:
     xoj::util::GObjectSPtr<PangoLayout> createPangoLayout() const;
     void updatePangoFont(PangoLayout* layout) const;
 
+    /**
+     * Calls fun(PangoLayout*) with a layout of this text. The layout is shaped once and kept until the text or the
+     * font changes, so that rendering, size computation and search do not need to reshape the text.
+     *
+     * This may be called from any thread: every thread gets its own layout, created like createPangoLayout(). fun may
+     * update its context (e.g. with pango_cairo_update_layout()) but must not keep the layout after returning.
+     */
+    template <class Fun>
+    auto usePangoLayout(Fun&& fun) const;
+
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
@@ -71,6 +84,13 @@ protected:
     void calcSize() const override;
     void updateSnapping() const;
 
+private:
+    /**
+     * @return the cached layout of the calling thread, up to date with the text and font. The caller must hold
+     * layoutMutex.
+     */
+    PangoLayout* getCachedLayoutUnlocked() const;
+
 public:
     std::vector<XojPdfRectangle> findText(const std::string& search) const;
 
@@ -80,4 +100,32 @@ private:
     std::string text;
 
     bool inEditing = false;
+
+    /**
+     * Layout of one thread, and the font and text version it was shaped with.
+     * Pango objects are bound to the font map of the thread which created them.
+     */
+    struct CachedLayout {
+        std::thread::id thread;
+        xoj::util::GObjectSPtr<PangoLayout> layout;
+        XojFont font;
+        size_t textVersion;
+    };
+
+    /**
+     * Incremented whenever the text changes
+     */
+    size_t textVersion = 0;
+
+    /**
+     * Protects the cached layouts and textVersion
+     */
+    mutable std::mutex layoutMutex;
+    mutable std::vector<CachedLayout> layouts;
 };
+
+template <class Fun>
+auto Text::usePangoLayout(Fun&& fun) const {
+    std::lock_guard lock(this->layoutMutex);
+    return fun(getCachedLayoutUnlocked());
+}
@@ -30,6 +30,14 @@ void XojPdfDocument::assign(XojPdfDocumentInterface* doc) { this->doc->assign(do
 
 auto XojPdfDocument::equals(XojPdfDocumentInterface* doc) const -> bool { return this->doc->equals(doc); }
 
+auto XojPdfDocument::reopen(XojPdfDocumentInterface* doc, GError** error) -> bool {
+    return this->doc->reopen(doc, error);
+}
+
+auto XojPdfDocument::reopen(const XojPdfDocument& doc, GError** error) -> bool {
+    return this->doc->reopen(doc.doc, error);
+}
+
 auto XojPdfDocument::save(fs::path const& file, GError** error) const -> bool { return doc->save(file, error); }
 
 auto XojPdfDocument::load(fs::path const& file, std::string password, GError** error) -> bool {
@@ -40,6 +48,10 @@ auto XojPdfDocument::load(gpointer data, gsize length, std::string password, GEr
     return doc->load(data, length, password, error);
 }
 
+auto XojPdfDocument::load(GBytes* data, std::string password, GError** error) -> bool {
+    return doc->load(data, password, error);
+}
+
 auto XojPdfDocument::isLoaded() const -> bool { return doc->isLoaded(); }
 
 auto XojPdfDocument::getPage(size_t page) const -> XojPdfPageSPtr { return doc->getPage(page); }
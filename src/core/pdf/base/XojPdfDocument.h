@@ -17,7 +17,7 @@
 #include <string>
 #include <vector>
 
-#include <glib.h>  // for GError, gpointer, gsize
+#include <glib.h>  // for GError, gpointer, gsize, GBytes
 
 #include "XojPdfDocumentInterface.h"  // for XojPdfDocumentInterface
 #include "XojPdfPage.h"               // for XojPdfPageSPtr
@@ -37,11 +37,14 @@ public:
     bool operator==(XojPdfDocument& doc) const;
     void assign(XojPdfDocumentInterface* doc) override;
     bool equals(XojPdfDocumentInterface* doc) const override;
+    bool reopen(XojPdfDocumentInterface* doc, GError** error) override;
+    bool reopen(const XojPdfDocument& doc, GError** error);
 
 public:
     bool save(fs::path const& file, GError** error) const override;
     bool load(fs::path const& file, std::string password, GError** error) override;
     bool load(gpointer data, gsize length, std::string password, GError** error) override;
+    bool load(GBytes* data, std::string password, GError** error) override;
     bool isLoaded() const override;
 
     XojPdfPageSPtr getPage(size_t page) const override;
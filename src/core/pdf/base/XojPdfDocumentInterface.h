@@ -14,7 +14,7 @@
 #include <cstddef>  // for size_t
 #include <string>   // for string
 
-#include <glib.h>  // for GError, gpointer, gsize
+#include <glib.h>  // for GError, gpointer, gsize, GBytes
 
 #include "XojPdfPage.h"  // for XojPdfPageSPtr
 #include "filesystem.h"  // for path
@@ -30,10 +30,20 @@ public:
     virtual void assign(XojPdfDocumentInterface* doc) = 0;
     virtual bool equals(XojPdfDocumentInterface* doc) const = 0;
 
+    /**
+     * Open the document loaded in doc a second time, independently of doc: pages of both instances can be used
+     * concurrently.
+     */
+    virtual bool reopen(XojPdfDocumentInterface* doc, GError** error) = 0;
+
 public:
     virtual bool save(fs::path const& file, GError** error) const = 0;
     virtual bool load(fs::path const& file, std::string password, GError** error) = 0;
     virtual bool load(gpointer data, gsize length, std::string password, GError** error) = 0;
+    /**
+     * Load the document from data without copying it: the document keeps a reference to it
+     */
+    virtual bool load(GBytes* data, std::string password, GError** error) = 0;
     virtual bool isLoaded() const = 0;
 
     virtual XojPdfPageSPtr getPage(size_t page) const = 0;
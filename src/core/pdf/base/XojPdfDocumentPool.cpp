@@ -0,0 +1,92 @@
+#include "XojPdfDocumentPool.h"
+
+#include <algorithm>  // for max
+#include <utility>    // for move
+
+#include <glib.h>  // for g_warning, GError
+
+XojPdfDocumentPool::XojPdfDocumentPool(const XojPdfDocument& doc, size_t size):
+        document(doc), size(std::max<size_t>(size, 1)) {}
+
+XojPdfDocumentPool::~XojPdfDocumentPool() = default;
+
+XojPdfDocumentPool::Lease::Lease(XojPdfDocumentPool* pool, std::unique_ptr<XojPdfDocument> doc):
+        pool(pool), doc(std::move(doc)) {}
+
+XojPdfDocumentPool::Lease::~Lease() {
+    if (this->doc) {
+        this->pool->release(std::move(this->doc));
+    }
+}
+
+auto XojPdfDocumentPool::acquire() -> Lease {
+    std::unique_lock lock(this->mutex);
+    while (true) {
+        if (!this->idle.empty()) {
+            auto doc = std::move(this->idle.back());
+            this->idle.pop_back();
+            return Lease(this, std::move(doc));
+        }
+
+        if (this->openCount < this->size) {
+            this->openCount++;
+            // Opening parses the document: do not block the other threads meanwhile
+            lock.unlock();
+
+            auto doc = std::make_unique<XojPdfDocument>();
+            GError* error = nullptr;
+            bool opened = this->document.isLoaded() && doc->reopen(this->document, &error);
+            if (!opened) {
+                g_warning("Could not open another instance of the PDF document: %s",
+                          error ? error->message : "not loaded");
+                if (error) {
+                    g_error_free(error);
+                }
+            }
+
+            lock.lock();
+            if (opened || this->openCount == 1) {
+                // Hand out the instance even if it could not be opened, rather than waiting forever. It is dropped
+                // once released, so that the next acquire tries again.
+                return Lease(this, std::move(doc));
+            }
+            // Use the instances which are already open, and try again once one of them is released
+            this->openCount--;
+            this->released.wait(lock);
+            continue;
+        }
+
+        this->released.wait(lock);
+    }
+}
+
+void XojPdfDocumentPool::release(std::unique_ptr<XojPdfDocument> doc) {
+    {
+        std::lock_guard lock(this->mutex);
+        if (this->openCount > this->size || !doc->isLoaded()) {
+            this->openCount--;
+        } else {
+            this->idle.push_back(std::move(doc));
+        }
+    }
+    this->released.notify_one();
+}
+
+void XojPdfDocumentPool::setSize(size_t size) {
+    std::lock_guard lock(this->mutex);
+    this->size = std::max<size_t>(size, 1);
+    while (this->openCount > this->size && !this->idle.empty()) {
+        this->idle.pop_back();
+        this->openCount--;
+    }
+}
+
+auto XojPdfDocumentPool::getSize() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->size;
+}
+
+auto XojPdfDocumentPool::getOpenCount() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->openCount;
+}
@@ -0,0 +1,92 @@
+/*
+ * Xournal++
+ *
+ * Pool of independently opened instances of a PDF document
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <vector>              // for vector
+
+#include "XojPdfDocument.h"  // for XojPdfDocument
+
+/**
+ * Pages of the same poppler document cannot be used concurrently. The pool opens the document again (from the same
+ * file or the same data) up to a given number of times, so that its users never share an instance with each other,
+ * nor with the loaded document. Instances are only opened when all the others are in use.
+ */
+class XojPdfDocumentPool {
+public:
+    /**
+     * @param doc The loaded document. The pool only reads its source, the instances are opened separately.
+     * @param size The maximal number of instances. With 1, the pool serializes the uses of its single instance.
+     */
+    XojPdfDocumentPool(const XojPdfDocument& doc, size_t size);
+    ~XojPdfDocumentPool();
+
+    XojPdfDocumentPool(const XojPdfDocumentPool&) = delete;
+    XojPdfDocumentPool& operator=(const XojPdfDocumentPool&) = delete;
+
+    /**
+     * Exclusive use of an instance of the document, until the lease is destroyed.
+     * The pages got from the instance must not be used after that.
+     */
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept = default;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        const XojPdfDocument& operator*() const { return *doc; }
+        const XojPdfDocument* operator->() const { return doc.get(); }
+
+    private:
+        Lease(XojPdfDocumentPool* pool, std::unique_ptr<XojPdfDocument> doc);
+
+        XojPdfDocumentPool* pool;
+        std::unique_ptr<XojPdfDocument> doc;
+
+        friend class XojPdfDocumentPool;
+    };
+
+    /**
+     * Get an idle instance, open a new one if the pool is not full, or wait until an instance is released
+     */
+    auto acquire() -> Lease;
+
+    /**
+     * Change the maximal number of instances. Superfluous instances are closed once they are released.
+     */
+    void setSize(size_t size);
+    auto getSize() const -> size_t;
+
+    /**
+     * @return The number of instances currently open (in use or not)
+     */
+    auto getOpenCount() const -> size_t;
+
+private:
+    void release(std::unique_ptr<XojPdfDocument> doc);
+
+private:
+    XojPdfDocument document;
+
+    mutable std::mutex mutex;
+    std::condition_variable released;
+
+    std::vector<std::unique_ptr<XojPdfDocument>> idle;
+    size_t openCount = 0;
+    size_t size = 1;
+};
@@ -61,6 +61,13 @@ public:
         std::unique_ptr<XojPdfAction> action;
     };
 
+    struct TextContent {
+        /// The text of the page, in reading order (UTF-8)
+        std::string text;
+        /// The bounding box of each character of text, in page coordinates (origin top left)
+        std::vector<XojPdfRectangle> charBounds;
+    };
+
     virtual double getWidth() const = 0;
     virtual double getHeight() const = 0;
 
@@ -77,6 +84,11 @@ public:
 
     virtual std::vector<XojPdfRectangle> findText(const std::string& text) = 0;
 
+    /**
+     * @return The whole text of the page together with the position of each character.
+     */
+    virtual TextContent getTextContent() = 0;
+
     /// Retrieve the text contained in the provided rectangle using the given
     /// selection style.
     /// @param rect start and end points
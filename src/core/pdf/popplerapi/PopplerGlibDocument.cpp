@@ -2,6 +2,7 @@
 
 #include <memory>    // for make_shared
 #include <optional>  // for optional
+#include <utility>   // for move
 
 #include <poppler-document.h>  // for poppler_document_get_n_...
 
@@ -15,12 +16,21 @@ class XojPdfBookmarkIterator;
 
 using std::string;
 
+namespace {
+auto newDocumentFromBytes(GBytes* bytes, const string& password, GError** error) -> PopplerDocument* {
+    gsize length = 0;
+    auto* data = static_cast<char*>(const_cast<void*>(g_bytes_get_data(bytes, &length)));
+    return poppler_document_new_from_data(data, static_cast<int>(length), password.c_str(), error);
+}
+}  // namespace
+
 PopplerGlibDocument::PopplerGlibDocument() = default;
 
 PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): document(doc.document) {
     if (document) {
         g_object_ref(document);
     }
+    setSource(doc.filepath, doc.data, doc.password);
 }
 
 PopplerGlibDocument::~PopplerGlibDocument() {
@@ -28,6 +38,7 @@ PopplerGlibDocument::~PopplerGlibDocument() {
         g_object_unref(document);
         document = nullptr;
     }
+    setSource({}, nullptr, {});
 }
 
 void PopplerGlibDocument::assign(XojPdfDocumentInterface* doc) {
@@ -35,16 +46,44 @@ void PopplerGlibDocument::assign(XojPdfDocumentInterface* doc) {
         g_object_unref(document);
     }
 
-    document = (dynamic_cast<PopplerGlibDocument*>(doc))->document;
+    auto* other = dynamic_cast<PopplerGlibDocument*>(doc);
+    document = other->document;
     if (document) {
         g_object_ref(document);
     }
+    setSource(other->filepath, other->data, other->password);
 }
 
 auto PopplerGlibDocument::equals(XojPdfDocumentInterface* doc) const -> bool {
     return document == (dynamic_cast<PopplerGlibDocument*>(doc))->document;
 }
 
+auto PopplerGlibDocument::reopen(XojPdfDocumentInterface* doc, GError** error) -> bool {
+    auto* other = dynamic_cast<PopplerGlibDocument*>(doc);
+    if (!other->isLoaded()) {
+        return false;
+    }
+
+    if (document) {
+        g_object_unref(document);
+        document = nullptr;
+    }
+    setSource(other->filepath, other->data, other->password);
+
+    if (data) {
+        this->document = newDocumentFromBytes(data.get(), password, error);
+    } else if (auto uri = Util::toUri(filepath)) {
+        this->document = poppler_document_new_from_file(uri->c_str(), password.c_str(), error);
+    }
+    return this->document != nullptr;
+}
+
+void PopplerGlibDocument::setSource(const fs::path& filepath, xoj::util::GBytesSPtr data, std::string password) {
+    this->data = std::move(data);
+    this->filepath = filepath;
+    this->password = std::move(password);
+}
+
 auto PopplerGlibDocument::save(fs::path const& file, GError** error) const -> bool {
     if (document == nullptr) {
         return false;
@@ -69,16 +108,31 @@ auto PopplerGlibDocument::load(fs::path const& file, string password, GError** e
     }
 
     this->document = poppler_document_new_from_file(uri->c_str(), password.c_str(), error);
+    setSource(file, nullptr, std::move(password));
     return this->document != nullptr;
 }
 
 auto PopplerGlibDocument::load(gpointer data, gsize length, string password, GError** error) -> bool {
     if (document) {
         g_object_unref(document);
+        document = nullptr;
+    }
+
+    // Poppler reads the data as long as the document exists: keep a copy, the caller may free it
+    xoj::util::GBytesSPtr bytes(g_bytes_new(data, length), xoj::util::adopt);
+    this->document = newDocumentFromBytes(bytes.get(), password, error);
+    setSource({}, std::move(bytes), std::move(password));
+    return this->document != nullptr;
+}
+
+auto PopplerGlibDocument::load(GBytes* data, string password, GError** error) -> bool {
+    if (document) {
+        g_object_unref(document);
+        document = nullptr;
     }
 
-    this->document =
-            poppler_document_new_from_data(static_cast<char*>(data), static_cast<int>(length), password.c_str(), error);
+    this->document = newDocumentFromBytes(data, password, error);
+    setSource({}, xoj::util::GBytesSPtr(data, xoj::util::ref), std::move(password));
     return this->document != nullptr;
 }
 
@@ -14,11 +14,12 @@
 #include <cstddef>  // for size_t
 #include <string>   // for string
 
-#include <glib.h>     // for GError, gpointer, gsize
+#include <glib.h>     // for GError, gpointer, gsize, GBytes
 #include <poppler.h>  // for PopplerDocument
 
 #include "pdf/base/XojPdfDocumentInterface.h"  // for XojPdfDocumentInterface
 #include "pdf/base/XojPdfPage.h"               // for XojPdfPageSPtr
+#include "util/raii/GBytesSPtr.h"              // for GBytesSPtr
 
 #include "filesystem.h"  // for path
 
@@ -33,17 +34,30 @@ public:
 public:
     void assign(XojPdfDocumentInterface* doc) override;
     bool equals(XojPdfDocumentInterface* doc) const override;
+    bool reopen(XojPdfDocumentInterface* doc, GError** error) override;
 
 public:
     bool save(fs::path const& filepath, GError** error) const override;
     bool load(fs::path const& filepath, std::string password, GError** error) override;
     bool load(gpointer data, gsize length, std::string password, GError** error) override;
+    bool load(GBytes* data, std::string password, GError** error) override;
     bool isLoaded() const override;
 
     XojPdfPageSPtr getPage(size_t page) const override;
     size_t getPageCount() const override;
     XojPdfBookmarkIterator* getContentsIter() const override;
 
+private:
+    void setSource(const fs::path& filepath, xoj::util::GBytesSPtr data, std::string password);
+
 private:
     PopplerDocument* document = nullptr;
+
+    /**
+     * Where the document was loaded from, to open it again: either a file, or the data (which poppler does not copy,
+     * and which is shared by all instances opened from it)
+     */
+    fs::path filepath;
+    xoj::util::GBytesSPtr data;
+    std::string password;
 };
@@ -99,6 +99,25 @@ auto PopplerGlibPage::findText(const std::string& text) -> std::vector<XojPdfRec
     return findings;
 }
 
+auto PopplerGlibPage::getTextContent() -> TextContent {
+    TextContent content;
+
+    char* text = poppler_page_get_text(page);
+    PopplerRectangle* rects = nullptr;
+    guint numRects = 0;
+    if (text && poppler_page_get_text_layout(page, &rects, &numRects)) {
+        content.text = text;
+        content.charBounds.reserve(numRects);
+        for (guint i = 0; i < numRects; i++) {
+            content.charBounds.emplace_back(rects[i].x1, rects[i].y1, rects[i].x2, rects[i].y2);
+        }
+        g_free(rects);
+    }
+    g_free(text);
+
+    return content;
+}
+
 auto getPopplerSelectionStyle(XojPdfPageSelectionStyle style) -> PopplerSelectionStyle {
     switch (style) {
         case XojPdfPageSelectionStyle::Word:
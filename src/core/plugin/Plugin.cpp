@@ -17,7 +17,9 @@
 
 #include <utility>  // for move, pair
 
+#include "control/Control.h"                     // for Control
 #include "gui/toolbarMenubar/ToolMenuHandler.h"  // for ToolMenuHandler
+#include "plugin/PluginJob.h"                    // for PluginJob
 #include "util/i18n.h"                           // for _
 #include "util/raii/GObjectSPtr.h"
 
@@ -146,6 +148,22 @@ void Plugin::registerToolButton(std::string description, std::string toolbarId,
 
 auto Plugin::getControl() const -> Control* { return control; }
 
+void Plugin::beginBatchEdit() { batchEdit.begin(); }
+
+void Plugin::endBatchEdit(bool failed) { batchEdit.end(control->getUndoRedoHandler(), failed); }
+
+auto Plugin::isInBatchEdit() const -> bool { return batchEdit.isOpen(); }
+
+auto Plugin::isRunningInBackground() const -> bool { return runningInBackground; }
+
+void Plugin::setRunningInBackground(bool running) { runningInBackground = running; }
+
+void Plugin::addBatchInsert(const PageRef& page, const Layer* layer, const std::vector<Element*>& elements) {
+    batchEdit.addInsert(page, layer, elements);
+}
+
+void Plugin::addBatchRefresh(const PageRef& page) { batchEdit.addRefresh(page); }
+
 void Plugin::loadIni() {
     GKeyFile* config = g_key_file_new();
     g_key_file_set_list_separator(config, ',');
@@ -193,30 +211,30 @@ void Plugin::registerXournalppLibs(lua_State* luaPtr) {
     }
 }
 
-void Plugin::addPluginToLuaPath() {
-    lua_getglobal(lua.get(), "package");
+void Plugin::addPluginToLuaPath(lua_State* luaPtr) const {
+    lua_getglobal(luaPtr, "package");
 
     // get field "path" from table at top of stack (-1)
-    lua_getfield(lua.get(), -1, "path");
+    lua_getfield(luaPtr, -1, "path");
 
     // grab path string from top of stack
-    std::string luaPath = lua_tostring(lua.get(), -1);
+    std::string luaPath = lua_tostring(luaPtr, -1);
 
     // prepend the path of the current plugin
     auto curPath = this->path / "?.lua";
     std::string combinedPath = curPath.string() + ";" + luaPath;
 
     // get rid of the std::string on the stack we just pushed
-    lua_pop(lua.get(), 1);
+    lua_pop(luaPtr, 1);
 
     // push the new one
-    lua_pushstring(lua.get(), combinedPath.c_str());
+    lua_pushstring(luaPtr, combinedPath.c_str());
 
     // set the field "path" in table at -2 with value at top of stack
-    lua_setfield(lua.get(), -2, "path");
+    lua_setfield(luaPtr, -2, "path");
 
     // get rid of package table from top of stack
-    lua_pop(lua.get(), 1);
+    lua_pop(luaPtr, 1);
 }
 
 void Plugin::loadScript() {
@@ -261,7 +279,7 @@ void Plugin::loadScript() {
 
     registerXournalppLibs(lua.get());
 
-    addPluginToLuaPath();
+    addPluginToLuaPath(lua.get());
 
     // Run the loaded Lua script
     if (lua_pcall(lua.get(), 0, 0, 0) != LUA_OK) {
@@ -296,6 +314,36 @@ auto Plugin::callFunction(const std::string& fnc, ptrdiff_t mode) -> bool {
     return true;
 }
 
+auto Plugin::callFunctionAsBatchEdit(const std::string& fnc, lua_State* args, int numArgs) -> bool {
+    int top = lua_gettop(lua.get());
+    lua_getglobal(lua.get(), fnc.c_str());
+
+    int first = lua_gettop(args) - numArgs + 1;
+    for (int i = 0; i < numArgs; i++) {
+        if (!PluginJob::copyValue(args, first + i, lua.get())) {
+            lua_settop(lua.get(), top);
+            g_warning("Error in Plugin: \"%s\", unsupported value passed to \"%s\"", name.c_str(), fnc.c_str());
+            return false;
+        }
+    }
+    lua_pop(args, numArgs);
+
+    beginBatchEdit();
+    int status = lua_pcall(lua.get(), numArgs, 0, 0);
+    endBatchEdit(status != LUA_OK);
+
+    if (status != LUA_OK) {
+        const char* errMsg = lua_tostring(lua.get(), -1);
+        XojMsgBox::showPluginMessage(name, errMsg, true);
+
+        g_warning("Error in Plugin: \"%s\", error: \"%s\"", name.c_str(), errMsg);
+        lua_pop(lua.get(), 1);
+        return false;
+    }
+
+    return true;
+}
+
 auto Plugin::getName() const -> std::string const& { return name; }
 auto Plugin::getDescription() const -> std::string const& { return description; }
 auto Plugin::getAuthor() const -> std::string const& { return author; }
@@ -25,9 +25,11 @@
 
 #include <gtk/gtk.h>  // for GtkWidget, GtkWindow
 
+#include "model/PageRef.h"  // for PageRef
 #include "util/raii/GObjectSPtr.h"
 
-#include "filesystem.h"  // for path
+#include "PluginBatchEdit.h"  // for PluginBatchEdit
+#include "filesystem.h"       // for path
 
 extern "C" {
 #include <lua.h>  // for lua_State, lua_close
@@ -35,6 +37,8 @@ extern "C" {
 
 class Plugin;
 class Control;
+class Element;
+class Layer;
 class ToolMenuHandler;
 
 struct MenuEntry final {
@@ -151,6 +155,31 @@ public:
     ///@return The main controller
     auto getControl() const -> Control*;
 
+    /// Start a batch edit scope, scopes may be nested
+    void beginBatchEdit();
+
+    /// End a batch edit scope. The outermost scope adds the collected undo actions and rerenders the changed pages.
+    /// If failed, the elements inserted in the scope are removed again (see PluginBatchEdit::end)
+    void endBatchEdit(bool failed = false);
+
+    ///@return true while a batch edit scope is open
+    auto isInBatchEdit() const -> bool;
+
+    /// Record elements inserted during a batch edit, they get a single undo action per layer when the scope ends
+    /// (see PluginBatchEdit::addInsert)
+    void addBatchInsert(const PageRef& page, const Layer* layer, const std::vector<Element*>& elements);
+
+    /// Record a page to rerender when the batch edit scope ends
+    void addBatchRefresh(const PageRef& page);
+
+    ///@return true while a background job of the plugin is scheduled or running
+    auto isRunningInBackground() const -> bool;
+
+    void setRunningInBackground(bool running);
+
+    /// Add the plugin folder to the lua path of a lua state
+    void addPluginToLuaPath(lua_State* luaPtr) const;
+
 private:
     /// Load ini file
     void loadIni();
@@ -158,9 +187,6 @@ private:
     /// Load custom Lua Libraries
     static void registerXournalppLibs(lua_State* luaPtr);
 
-    /// Add the plugin folder to the lua path
-    void addPluginToLuaPath();
-
 public:
     /// Get Plugin from lua engine
     static auto getPluginFromLua(lua_State* lua) -> Plugin*;
@@ -168,6 +194,12 @@ public:
     /// Execute lua function
     auto callFunction(const std::string& fnc, ptrdiff_t mode = std::numeric_limits<ptrdiff_t>::max()) -> bool;
 
+    /**
+     * Execute lua function as one batch edit, with the values on top of the stack of another lua state as arguments.
+     * The values are popped from that state.
+     */
+    auto callFunctionAsBatchEdit(const std::string& fnc, lua_State* args, int numArgs) -> bool;
+
 private:
     Control* control;                                      ///< The main controller
     std::unique_ptr<lua_State, LuaDeleter> lua{};          ///< Lua engine
@@ -175,6 +207,8 @@ private:
     xoj::util::GObjectSPtr<GMenu> menuSection;             ///< Menu section containing the menu entries
     std::vector<ToolbarButtonEntry> toolbarButtonEntries;  ///< All registered toolbar button entries
 
+    PluginBatchEdit batchEdit;          ///< Changes collected in the current batch edit
+    bool runningInBackground = false;  ///< A background job of the plugin is running
 
     std::string name;             ///< Plugin name
     std::string description;      ///< Description of the plugin
@@ -0,0 +1,102 @@
+#include "PluginBatchEdit.h"
+
+#include <algorithm>      // for find, find_if, remove_if
+#include <cstddef>        // for ptrdiff_t
+#include <memory>         // for make_unique
+#include <unordered_set>  // for unordered_set
+#include <utility>        // for exchange, move
+
+#include "model/Layer.h"            // for Layer
+#include "model/XojPage.h"          // for XojPage
+#include "undo/InsertUndoAction.h"  // for InsertsUndoAction
+#include "undo/UndoRedoHandler.h"   // for UndoRedoHandler
+#include "util/Assert.h"            // for xoj_assert
+
+void PluginBatchEdit::begin() { scopes.push_back(inserts.size()); }
+
+void PluginBatchEdit::end(UndoRedoHandler* undo, bool failed) {
+    xoj_assert(!scopes.empty());
+    const size_t first = scopes.back();
+    scopes.pop_back();
+
+    if (failed) {
+        for (auto it = inserts.begin() + static_cast<std::ptrdiff_t>(first); it != inserts.end(); ++it) {
+            addRefresh(it->page);
+            if (Layer* layer = findLayer(*it)) {
+                for (Element* e: it->elements) {
+                    if (layer->indexOf(e) != Element::InvalidIndex) {
+                        layer->removeElement(e, true);
+                    }
+                }
+            }
+        }
+        inserts.erase(inserts.begin() + static_cast<std::ptrdiff_t>(first), inserts.end());
+    }
+
+    if (!scopes.empty()) {
+        return;
+    }
+
+    // A single undo action per layer, for all scopes
+    std::vector<Insert> merged;
+    for (auto& insert: std::exchange(inserts, {})) {
+        auto it = std::find_if(merged.begin(), merged.end(),
+                               [&](const Insert& i) { return i.page == insert.page && i.layer == insert.layer; });
+        if (it == merged.end()) {
+            merged.push_back(std::move(insert));
+        } else {
+            it->elements.insert(it->elements.end(), insert.elements.begin(), insert.elements.end());
+        }
+    }
+
+    for (auto& insert: merged) {
+        addRefresh(insert.page);
+
+        // The plugin may have deleted the layer or some of the elements meanwhile: only keep what is still in the page
+        Layer* layer = findLayer(insert);
+        if (!layer) {
+            continue;
+        }
+
+        const auto& layerElements = layer->getElements();
+        std::unordered_set<const Element*> contained(layerElements.begin(), layerElements.end());
+        auto& elements = insert.elements;
+        elements.erase(std::remove_if(elements.begin(), elements.end(),
+                                      [&](const Element* e) { return contained.count(e) == 0; }),
+                       elements.end());
+        if (!elements.empty()) {
+            undo->addUndoAction(std::make_unique<InsertsUndoAction>(insert.page, layer, std::move(elements)));
+        }
+    }
+
+    // Take the list first, the page change listeners may start another batch
+    for (auto& page: std::exchange(refreshes, {})) {
+        page->firePageChanged();
+    }
+}
+
+auto PluginBatchEdit::isOpen() const -> bool { return !scopes.empty(); }
+
+auto PluginBatchEdit::findLayer(const Insert& insert) const -> Layer* {
+    auto* layers = insert.page->getLayers();
+    auto it = std::find(layers->begin(), layers->end(), insert.layer);
+    return it == layers->end() ? nullptr : *it;
+}
+
+void PluginBatchEdit::addInsert(const PageRef& page, const Layer* layer, const std::vector<Element*>& elements) {
+    xoj_assert(!scopes.empty());
+    // Kept apart per scope, so that a failed scope only removes its own elements
+    auto begin = inserts.begin() + static_cast<std::ptrdiff_t>(scopes.back());
+    auto it = std::find_if(begin, inserts.end(), [&](const Insert& i) { return i.page == page && i.layer == layer; });
+    if (it == inserts.end()) {
+        inserts.push_back({page, layer, elements});
+    } else {
+        it->elements.insert(it->elements.end(), elements.begin(), elements.end());
+    }
+}
+
+void PluginBatchEdit::addRefresh(const PageRef& page) {
+    if (std::find(refreshes.begin(), refreshes.end(), page) == refreshes.end()) {
+        refreshes.push_back(page);
+    }
+}
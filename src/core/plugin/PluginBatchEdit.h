@@ -0,0 +1,64 @@
+/*
+ * Xournal++
+ *
+ * Changes collected during the batch edit scopes of a plugin
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "model/PageRef.h"  // for PageRef
+
+class Element;
+class Layer;
+class UndoRedoHandler;
+
+/**
+ * @brief Collects the changes made by a plugin inside batch edit scopes (see app.batchEdit), so that they get a single
+ * undo action per layer and every changed page is rerendered once when the outermost scope ends.
+ */
+class PluginBatchEdit final {
+public:
+    /// Start a scope, scopes may be nested
+    void begin();
+
+    /**
+     * End a scope. The outermost scope adds the collected undo actions to undo and rerenders the changed pages.
+     * @param failed The scope was left by an error: the elements inserted in it are removed again, without undo action
+     */
+    void end(UndoRedoHandler* undo, bool failed = false);
+
+    ///@return true while a scope is open
+    bool isOpen() const;
+
+    /**
+     * Record elements inserted into a layer. The layer is only remembered for comparison: when the scope ends, the
+     * elements are only added to an undo action if the layer is still part of the page and still contains them, as
+     * the plugin may have deleted either meanwhile.
+     */
+    void addInsert(const PageRef& page, const Layer* layer, const std::vector<Element*>& elements);
+
+    /// Record a page to rerender when the scope ends
+    void addRefresh(const PageRef& page);
+
+private:
+    struct Insert {
+        PageRef page;
+        const Layer* layer;
+        std::vector<Element*> elements;
+    };
+
+    /// The layer of insert if it is still part of its page, nullptr otherwise
+    Layer* findLayer(const Insert& insert) const;
+
+    std::vector<size_t> scopes;      ///< For each open scope, the index of its first entry in inserts
+    std::vector<Insert> inserts;     ///< Elements inserted in the open scopes, in order
+    std::vector<PageRef> refreshes;  ///< Pages to rerender at the end of the outermost scope
+};
@@ -0,0 +1,176 @@
+#include "PluginJob.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <utility>  // for move
+
+#include <glib.h>  // for g_warning
+
+#include "control/Control.h"  // for Control
+#include "util/Trace.h"       // for setThreadName
+#include "util/Util.h"        // for execInUiThread
+#include "util/XojMsgBox.h"   // for XojMsgBox
+
+extern "C" {
+#include <lauxlib.h>  // for luaL_newstate, luaL_loadfile, luaL_checkinteger
+#include <lualib.h>   // for luaL_openlibs
+}
+
+namespace {
+/**
+ * Nesting depth up to which tables are copied, deeper ones are most likely cyclic
+ */
+constexpr int MAX_COPY_DEPTH = 64;
+};  // namespace
+
+PluginJob::PluginJob(Plugin* plugin, const fs::path& file, std::string callback, std::string message):
+        plugin(plugin), file(plugin->getPath() / file), callback(std::move(callback)), message(std::move(message)) {
+    plugin->setRunningInBackground(true);
+    plugin->getControl()->beginBackgroundTask(this->message);
+}
+
+PluginJob::~PluginJob() {
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+auto PluginJob::getType() -> JobType { return JOB_TYPE_PLUGIN; }
+
+auto PluginJob::prepare(lua_State* from, int firstArg, int numArgs) -> std::string {
+    worker.reset(luaL_newstate());
+    luaL_openlibs(worker.get());
+    plugin->addPluginToLuaPath(worker.get());
+
+    lua_pushlightuserdata(worker.get(), this);
+    lua_setfield(worker.get(), LUA_REGISTRYINDEX, "Xournalpp_PluginJob");
+    lua_register(worker.get(), "progress", &PluginJob::progress);
+
+    if (luaL_loadfile(worker.get(), file.string().c_str()) != LUA_OK) {
+        return lua_tostring(worker.get(), -1);
+    }
+
+    if (!lua_checkstack(worker.get(), numArgs)) {
+        return "Too many arguments";
+    }
+    for (int i = 0; i < numArgs; i++) {
+        if (!copyValue(from, firstArg + i, worker.get())) {
+            return "Only nil, booleans, numbers, strings and tables of those can be passed to a background job";
+        }
+    }
+    this->numArgs = numArgs;
+
+    return "";
+}
+
+auto PluginJob::copyValue(lua_State* from, int index, lua_State* to, int depth) -> bool {
+    index = lua_absindex(from, index);
+    if (!lua_checkstack(to, 3)) {
+        return false;
+    }
+
+    switch (lua_type(from, index)) {
+        case LUA_TNIL:
+            lua_pushnil(to);
+            return true;
+        case LUA_TBOOLEAN:
+            lua_pushboolean(to, lua_toboolean(from, index));
+            return true;
+        case LUA_TNUMBER:
+            if (lua_isinteger(from, index)) {
+                lua_pushinteger(to, lua_tointeger(from, index));
+            } else {
+                lua_pushnumber(to, lua_tonumber(from, index));
+            }
+            return true;
+        case LUA_TSTRING: {
+            size_t len = 0;
+            const char* str = lua_tolstring(from, index, &len);
+            lua_pushlstring(to, str, len);
+            return true;
+        }
+        case LUA_TTABLE:
+            if (depth >= MAX_COPY_DEPTH || !lua_checkstack(from, 2)) {
+                return false;
+            }
+            lua_newtable(to);
+            lua_pushnil(from);
+            while (lua_next(from, index) != 0) {
+                if (!copyValue(from, -2, to, depth + 1)) {
+                    lua_pop(from, 2);
+                    lua_pop(to, 1);
+                    return false;
+                }
+                if (!copyValue(from, -1, to, depth + 1)) {
+                    lua_pop(from, 2);
+                    lua_pop(to, 2);
+                    return false;
+                }
+                lua_rawset(to, -3);
+                lua_pop(from, 1);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+void PluginJob::start() {
+    // Released once afterRun() was called
+    ref();
+    this->thread = std::thread([this] {
+        xoj::util::trace::setThreadName("PluginJob");
+        run();
+    });
+}
+
+void PluginJob::run() {
+    int base = lua_gettop(worker.get()) - numArgs - 1;
+    if (lua_pcall(worker.get(), numArgs, LUA_MULTRET, 0) != LUA_OK) {
+        error = lua_tostring(worker.get(), -1);
+    } else {
+        numResults = lua_gettop(worker.get()) - base;
+    }
+
+    Util::execInUiThread([this] {
+        // The thread is done once it added this callback
+        this->thread.join();
+        afterRun();
+        unref();
+    });
+}
+
+void PluginJob::afterRun() {
+    plugin->setRunningInBackground(false);
+    plugin->getControl()->endBackgroundTask(message);
+
+    if (!error.empty()) {
+        XojMsgBox::showPluginMessage(plugin->getName(), error, true);
+        g_warning("Error in background job of Plugin: \"%s\", error: \"%s\"", plugin->getName().c_str(),
+                  error.c_str());
+    } else if (!callback.empty()) {
+        plugin->callFunctionAsBatchEdit(callback, worker.get(), numResults);
+    }
+
+    worker.reset();
+}
+
+auto PluginJob::progress(lua_State* L) -> int {
+    auto current = luaL_checkinteger(L, 1);
+    auto max = luaL_checkinteger(L, 2);
+    if (current < 0 || max <= 0) {
+        return luaL_error(L, "Invalid progress %d / %d", static_cast<int>(current), static_cast<int>(max));
+    }
+
+    lua_getfield(L, LUA_REGISTRYINDEX, "Xournalpp_PluginJob");
+    auto* job = static_cast<PluginJob*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+
+    // Both only post their value to the UI thread, in this order
+    Control* control = job->plugin->getControl();
+    control->setMaximumState(static_cast<size_t>(max));
+    control->setCurrentState(static_cast<size_t>(current));
+    return 0;
+}
+
+#endif
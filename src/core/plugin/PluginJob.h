@@ -0,0 +1,101 @@
+/*
+ * Xournal++
+ *
+ * Runs a Lua script of a plugin in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "config-features.h"  // for ENABLE_PLUGINS
+
+#ifdef ENABLE_PLUGINS
+
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+#include <thread>  // for thread
+
+#include "control/jobs/Job.h"  // for Job, JobType
+
+#include "Plugin.h"      // for LuaDeleter
+#include "filesystem.h"  // for path
+
+extern "C" {
+#include <lua.h>  // for lua_State
+}
+
+/**
+ * @brief Runs a worker script of a plugin on a thread of its own, in a Lua state of its own.
+ *
+ * The worker has no access to the app library, which is not thread safe. Instead it gets a snapshot of the data it
+ * needs as arguments, taken by the plugin on the UI thread, and may report its progress to the status bar with the
+ * global function progress(current, max). The UI is not blocked meanwhile: the document may change before the
+ * results are applied.
+ *
+ * When the worker has finished, its return values are passed to a callback of the plugin on the UI thread. The
+ * callback runs as a batch edit (see app.batchEdit), so all changes it makes to the document become a single undo
+ * action per layer and are rerendered once.
+ */
+class PluginJob: public Job {
+public:
+    /**
+     * @param file The worker script, relative to the plugin folder
+     * @param callback Name of the global function of the plugin receiving the results, may be empty
+     * @param message Shown in the status bar while the worker runs
+     */
+    PluginJob(Plugin* plugin, const fs::path& file, std::string callback, std::string message);
+
+protected:
+    ~PluginJob() override;
+
+public:
+    /**
+     * @brief Load the worker script and copy its arguments from the stack of the calling Lua state.
+     * Must be called before the job is started.
+     *
+     * @return An error message, empty on success
+     */
+    std::string prepare(lua_State* from, int firstArg, int numArgs);
+
+    /**
+     * @brief Copy a value (nil, boolean, number, string or table of those) from one Lua state to another
+     *
+     * @return false if the value (or an element of it) is of another type, nothing is pushed in this case
+     */
+    static bool copyValue(lua_State* from, int index, lua_State* to, int depth = 0);
+
+    /**
+     * Run the worker on a new thread, then pass its results to the callback on the UI thread. The worker does not
+     * run on the scheduler, so that the pages are still rendered while the UI is used meanwhile.
+     */
+    void start();
+
+public:
+    JobType getType() override;
+
+protected:
+    void run() override;
+    void afterRun() override;
+
+private:
+    static int progress(lua_State* L);
+
+private:
+    Plugin* plugin;
+    fs::path file;
+    std::string callback;
+    std::string message;
+
+    std::unique_ptr<lua_State, LuaDeleter> worker;
+    std::thread thread;
+
+    int numArgs = 0;
+    int numResults = 0;
+    std::string error;
+};
+
+#endif
@@ -43,6 +43,7 @@
 #include "model/Text.h"
 #include "model/XojPage.h"
 #include "plugin/Plugin.h"
+#include "plugin/PluginJob.h"
 #include "undo/InsertUndoAction.h"
 #include "util/StringUtils.h"
 #include "util/XojMsgBox.h"
@@ -482,9 +483,20 @@ static int applib_layerAction(lua_State* L) {
  * - "individual" each of the elements get an own undo-redo-action
  * - "none": no undo-redo-action will be inserted
  * if an invalid value is being passed as allowUndoRedoAction this function errors
+ * Inside a batch edit scope, the elements of "grouped" and "individual" insertions are collected and get a single
+ * undo-redo-action per layer when the scope ends.
  */
 static int handleUndoRedoActionHelper(lua_State* L, Control* control, const char* allowUndoRedoAction,
                                       const std::vector<Element*>& elements) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    if (plugin->isInBatchEdit() && (strcmp("grouped", allowUndoRedoAction) == 0 ||
+                                    strcmp("individual", allowUndoRedoAction) == 0)) {
+        // Grouped with everything else inserted in the batch edit scope, see app.batchEdit
+        PageRef const& page = control->getCurrentPage();
+        plugin->addBatchInsert(page, page->getSelectedLayer(), elements);
+        return 0;
+    }
+
     if (strcmp("grouped", allowUndoRedoAction) == 0) {
         PageRef const& page = control->getCurrentPage();
         Layer* layer = page->getSelectedLayer();
@@ -505,6 +517,66 @@ static int handleUndoRedoActionHelper(lua_State* L, Control* control, const char
     return 0;
 }
 
+/**
+ * Helper function to read an array of numbers, given either as a table or as a string of packed native doubles (as
+ * created by string.pack("d", ...) or by a C module). Packed strings avoid the per-element stack traffic of tables,
+ * which dominates for strokes with many points.
+ *
+ * @return false if the value at the given index is neither a table nor a string
+ */
+static bool readNumberArrayHelper(lua_State* L, int index, std::vector<double>& values) {
+    index = lua_absindex(L, index);
+    values.clear();
+
+    if (lua_type(L, index) == LUA_TSTRING) {
+        size_t length = 0;
+        const char* data = lua_tolstring(L, index, &length);
+        if (length % sizeof(double) != 0) {
+            luaL_error(L, "Packed number array length %d is not a multiple of %d", static_cast<int>(length),
+                       static_cast<int>(sizeof(double)));
+        }
+        values.resize(length / sizeof(double));
+        std::memcpy(values.data(), data, length);
+        return true;
+    }
+
+    if (lua_istable(L, index)) {
+        size_t count = lua_rawlen(L, index);
+        values.reserve(count);
+        for (size_t i = 1; i <= count; i++) {
+            lua_rawgeti(L, index, as_signed(i));
+            values.push_back(lua_tonumber(L, -1));
+            lua_pop(L, 1);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Helper function to push one coordinate of all points of a stroke, either as a table or as a string of packed
+ * native doubles.
+ */
+static void pushPointArrayHelper(lua_State* L, const std::vector<Point>& points, double Point::*coordinate,
+                                 bool packed) {
+    if (packed) {
+        std::vector<double> values;
+        values.reserve(points.size());
+        for (const Point& p: points) {
+            values.push_back(p.*coordinate);
+        }
+        lua_pushlstring(L, reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+        return;
+    }
+
+    lua_createtable(L, static_cast<int>(points.size()), 0);
+    lua_Integer i = 0;
+    for (const Point& p: points) {
+        lua_pushnumber(L, p.*coordinate);
+        lua_rawseti(L, -2, ++i);
+    }
+}
 
 /**
  * Helper function for addStroke API. Parses pen settings from API call, taking
@@ -630,7 +702,7 @@ static void addStrokeHelper(lua_State* L, Stroke* stroke) {
  * startX, startY, ctrl1X, ctrl1Y, ctrl2X, ctrl2Y, endX, endY, startX, startY, ...
  *
  * The function checks that the length of the coordinate table is divisible by eight, and will throw
- * an error if it is not.
+ * an error if it is not. The coordinates can also be given as a string of packed native doubles, see app.addStrokes.
  *
  * Example: app.addSplines({
  *            ["splines"] = { -- The outer table is a table of strokes
@@ -685,17 +757,10 @@ static int applib_addSplines(lua_State* L) {
         lua_pushinteger(L, as_signed(a));
         lua_gettable(L, -2);                 // get current spline from splines table
         lua_getfield(L, -1, "coordinates");  // get coordinates of the current spline
-        if (!lua_istable(L, -1)) {
+        if (!lua_istable(L, -1) && lua_type(L, -1) != LUA_TSTRING) {
             return luaL_error(L, "Missing coordinate table!");
         }
-        size_t numCoords = lua_rawlen(L, -1);
-        for (size_t b = 1; b <= numCoords; b++) {
-            lua_pushinteger(L, as_signed(b));
-            lua_gettable(L, -2);  // get current coordinate from coordinates
-            double point = lua_tonumber(L, -1);
-            coordStream.push_back(point);  // Each segment is going to have multiples of 8 points.
-            lua_pop(L, 1);                 // cleanup fetched coordinate
-        }
+        readNumberArrayHelper(L, -1, coordStream);  // Each segment is going to have multiples of 8 points.
         // pop value + copy of key, leaving original key
         lua_pop(L, 1);  // cleanup coordinates table
         // Handle those points
@@ -762,6 +827,9 @@ static int applib_addSplines(lua_State* L) {
  * The function checks for consistency among table lengths, and throws an
  * error if there is a discrepancy
  *
+ * For large strokes, x, y and pressure can also be given as strings of packed native doubles,
+ * e.g. ["x"] = string.pack(string.rep("d", #xs), table.unpack(xs)), which avoids converting every point separately.
+ *
  * Example:
  *
  * app.addStrokes({
@@ -833,46 +901,21 @@ static int applib_addStrokes(lua_State* L) {
         lua_gettable(L, -2);  // get current stroke
 
         lua_getfield(L, -1, "x");  // get x array of current stroke
-        if (!lua_istable(L, -1)) {
+        if (!readNumberArrayHelper(L, -1, xStream)) {
             return luaL_error(L, "Missing X-Coordinate table!");
         }
-        size_t xPoints = lua_rawlen(L, -1);
-        for (size_t b = 1; b <= xPoints; b++) {
-            lua_pushinteger(L, as_signed(b));
-            lua_gettable(L, -2);  // get current x-Coordinate
-            double value = lua_tonumber(L, -1);
-            xStream.push_back(value);
-            lua_pop(L, 1);  // cleanup x-Coordinate
-        }
         lua_pop(L, 1);  // cleanup x array
 
         // Fetch table of Y values form the Lua stack
         lua_getfield(L, -1, "y");  // get y array of current stroke
-        if (!lua_istable(L, -1)) {
+        if (!readNumberArrayHelper(L, -1, yStream)) {
             return luaL_error(L, "Missing Y-Coordinate table!");
         }
-        size_t yPoints = lua_rawlen(L, -1);
-        for (size_t b = 1; b <= yPoints; b++) {
-            lua_pushinteger(L, as_signed(b));
-            lua_gettable(L, -2);  // get current y-Coordinate
-            double value = lua_tonumber(L, -1);
-            yStream.push_back(value);
-            lua_pop(L, 1);  // cleanup y-Coordinate
-        }
         lua_pop(L, 1);  // cleanup y array
 
         // Fetch table of pressure values from the Lua stack
         lua_getfield(L, -1, "pressure");
-        if (lua_istable(L, -1)) {
-            size_t pressurePoints = lua_rawlen(L, -1);
-            for (size_t b = 1; b <= pressurePoints; b++) {
-                lua_pushinteger(L, as_signed(b));
-                lua_gettable(L, -2);  // get current pressure
-                double value = lua_tonumber(L, -1);
-                pressureStream.push_back(value);
-                lua_pop(L, 1);  // cleanup pressure
-            }
-        }
+        readNumberArrayHelper(L, -1, pressureStream);
 
         lua_pop(L, 1);  // cleanup pressure array
 
@@ -891,17 +934,12 @@ static int applib_addStrokes(lua_State* L) {
             return 1;
         }
         // Add points to the stroke. Include pressure, if it exists.
-        if (pressureStream.size() > 0) {
-            for (long unsigned int i = 0; i < xStream.size(); i++) {
-                Point myPoint = Point(xStream.at(i), yStream.at(i), pressureStream.at(i));
-                stroke->addPoint(myPoint);
-            }
-        } else {
-            for (long unsigned int i = 0; i < xStream.size(); i++) {
-                Point myPoint = Point(xStream.at(i), yStream.at(i), Point::NO_PRESSURE);
-                stroke->addPoint(myPoint);
-            }
+        std::vector<Point> points;
+        points.reserve(xStream.size());
+        for (size_t i = 0; i < xStream.size(); i++) {
+            points.emplace_back(xStream[i], yStream[i], pressureStream.empty() ? Point::NO_PRESSURE : pressureStream[i]);
         }
+        stroke->setPointVector(std::move(points));
 
         // Finish building the Stroke and apply it to the layer.
         addStrokeHelper(L, stroke);
@@ -917,24 +955,8 @@ static int applib_addStrokes(lua_State* L) {
     // Check how the user wants to handle undoing
     lua_getfield(L, 1, "allowUndoRedoAction");
     allowUndoRedoAction = luaL_optstring(L, -1, "grouped");
-    if (strcmp("grouped", allowUndoRedoAction) == 0) {
-        PageRef const& page = ctrl->getCurrentPage();
-        Layer* layer = page->getSelectedLayer();
-        UndoRedoHandler* undo = ctrl->getUndoRedoHandler();
-        undo->addUndoAction(std::make_unique<InsertsUndoAction>(page, layer, strokes));
-    } else if (strcmp("individual", allowUndoRedoAction) == 0) {
-        PageRef const& page = ctrl->getCurrentPage();
-        Layer* layer = page->getSelectedLayer();
-        UndoRedoHandler* undo = ctrl->getUndoRedoHandler();
-        for (Element* element: strokes) {
-            undo->addUndoAction(std::make_unique<InsertUndoAction>(page, layer, element));
-        }
-    } else if (strcmp("none", allowUndoRedoAction) == 0)
-        g_warning("Not allowing undo/redo action.");
-    else {
-        return luaL_error(L, "Unrecognized undo/redo option: %s", allowUndoRedoAction);
-    }
-    return 0;
+    lua_pop(L, 1);
+    return handleUndoRedoActionHelper(L, ctrl, allowUndoRedoAction, strokes);
 }
 
 /**
@@ -1216,6 +1238,9 @@ static int applib_getTexts(lua_State* L) {
  * Is inverse to app.addStrokes
  *
  * Required argument: type ("selection" or "layer")
+ * Optional argument: packed (boolean, default false). If true, x, y and pressure are returned as strings of packed
+ *                    native doubles instead of tables, which can be passed to app.addStrokes as they are or read
+ *                    with string.unpack
  *
  * Example: local strokes = app.getStrokes("selection")
  *
@@ -1256,6 +1281,7 @@ static int applib_getTexts(lua_State* L) {
 static int applib_getStrokes(lua_State* L) {
     Plugin* plugin = Plugin::getPluginFromLua(L);
     std::string type = luaL_checkstring(L, 1);
+    bool packed = lua_toboolean(L, 2);
     std::vector<Element*> elements = {};
     Control* control = plugin->getControl();
 
@@ -1282,7 +1308,6 @@ static int applib_getStrokes(lua_State* L) {
 
     lua_newtable(L);  // create table of the elements
     int currStrokeNo = 0;
-    int currPointNo = 0;
 
     // stack now has following:
     //  1 = type (string)
@@ -1300,33 +1325,17 @@ static int applib_getStrokes(lua_State* L) {
             // -2 = index of the current stroke
             // -1 = current stroke
 
-            lua_newtable(L);  // create table of x-coordinates
-            for (auto p: s->getPointVector()) {
-                lua_pushinteger(L, ++currPointNo);  // key
-                lua_pushnumber(L, p.x);             // value
-                lua_settable(L, -3);                // insert
-            }
+            const std::vector<Point>& points = s->getPointVector();
+
+            pushPointArrayHelper(L, points, &Point::x, packed);
             lua_setfield(L, -2, "x");  // add x-coordinates to stroke
-            currPointNo = 0;
 
-            lua_newtable(L);  // create table for y-coordinates
-            for (auto p: s->getPointVector()) {
-                lua_pushinteger(L, ++currPointNo);  // key
-                lua_pushnumber(L, p.y);             // value
-                lua_settable(L, -3);                // insert
-            }
+            pushPointArrayHelper(L, points, &Point::y, packed);
             lua_setfield(L, -2, "y");  // add y-coordinates to stroke
-            currPointNo = 0;
 
             if (s->hasPressure()) {
-                lua_newtable(L);  // create table for pressures
-                for (auto p: s->getPointVector()) {
-                    lua_pushinteger(L, ++currPointNo);  // key
-                    lua_pushnumber(L, p.z);             // value
-                    lua_settable(L, -3);                // insert
-                }
+                pushPointArrayHelper(L, points, &Point::z, packed);
                 lua_setfield(L, -2, "pressure");  // add pressures to stroke
-                currPointNo = 0;
             }
 
             // stack now has following:
@@ -1367,7 +1376,7 @@ static int applib_getStrokes(lua_State* L) {
 
 /**
  * Notifies program of any updates to the working document caused
- * by the API.
+ * by the API. Inside a batch edit scope, the page is rerendered once when the scope ends.
  *
  * Example: app.refreshPage()
  */
@@ -1375,7 +1384,9 @@ static int applib_refreshPage(lua_State* L) {
     Plugin* plugin = Plugin::getPluginFromLua(L);
     Control* ctrl = plugin->getControl();
     PageRef const& page = ctrl->getCurrentPage();
-    if (page) {
+    if (page && plugin->isInBatchEdit()) {
+        plugin->addBatchRefresh(page);
+    } else if (page) {
         page->firePageChanged();
     } else {
         return luaL_error(L, "Called applib_refreshPage, but there is no current page.");
@@ -1383,6 +1394,99 @@ static int applib_refreshPage(lua_State* L) {
     return 0;
 }
 
+/**
+ * Runs a function as a batch edit: the undo-redo-actions of all elements added inside it (by app.addStrokes,
+ * app.addSplines, app.addImages and app.addTexts with allowUndoRedoAction "grouped" or "individual") are combined
+ * into one per layer, and the pages are rerendered only once, when the function returns.
+ * The function's return values are passed through. If it raises an error, the elements it added are removed again
+ * and the error is propagated after the scope is closed.
+ *
+ * Example:
+ *   app.batchEdit(function()
+ *     for _, s in ipairs(importedStrokes) do
+ *       app.addStrokes({strokes = {s}})
+ *     end
+ *     app.refreshPage()
+ *   end)
+ */
+static int applib_batchEdit(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+
+    // Discard any extra arguments passed in
+    lua_settop(L, 1);
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+
+    plugin->beginBatchEdit();
+    int status = lua_pcall(L, 0, LUA_MULTRET, 0);
+    plugin->endBatchEdit(status != LUA_OK);
+
+    if (status != LUA_OK) {
+        return lua_error(L);
+    }
+    return lua_gettop(L);
+}
+
+/**
+ * Runs a worker script of the plugin in the background, so that long computations do not freeze the window.
+ * The first argument is a table with the keys
+ *   "file": the worker script, relative to the plugin folder
+ *   "callback": (optional) name of the function receiving the return values of the worker script
+ *   "message": (optional) text shown in the status bar while the worker runs
+ * All further arguments are copied and passed to the worker script (available as "..." in it). Only nil,
+ * booleans, numbers, strings and tables of those can be passed, back and forth.
+ *
+ * The worker script runs in a Lua state of its own, without the app library: it works on a snapshot of the
+ * document passed as arguments, e.g. the result of app.getStrokes("layer", true). It may report its progress
+ * with progress(current, max). The callback runs as one batch edit (see app.batchEdit), so all changes it applies
+ * to the document are undone in one step and rerendered once, or removed again if it raises an error.
+ * The application stays usable while the worker runs, only one worker per plugin may run at a time.
+ *
+ * Example:
+ *   app.runInBackground({file = "recolor.lua", callback = "applyRecolor", message = "Recoloring"},
+ *                       app.getStrokes("layer", true))
+ *
+ *   -- recolor.lua
+ *   local strokes = ...
+ *   for i, s in ipairs(strokes) do
+ *     s.color = 0xff0000
+ *     progress(i, #strokes)
+ *   end
+ *   return strokes
+ */
+static int applib_runInBackground(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int numArgs = lua_gettop(L) - 1;
+
+    lua_getfield(L, 1, "file");
+    lua_getfield(L, 1, "callback");
+    lua_getfield(L, 1, "message");
+    std::string file = luaL_checkstring(L, -3);
+    std::string callback = luaL_optstring(L, -2, "");
+    std::string message = luaL_optstring(L, -1, plugin->getName().c_str());
+    lua_pop(L, 3);
+
+    if (file.find("..") != std::string::npos) {
+        return luaL_error(L, "Unsupported path \"%s\"", file.c_str());
+    }
+    if (plugin->isRunningInBackground()) {
+        return luaL_error(L, "A background job of this plugin is already running");
+    }
+
+    auto* job = new PluginJob(plugin, file, callback, message);
+    std::string error = job->prepare(L, 2, numArgs);
+    if (!error.empty()) {
+        plugin->setRunningInBackground(false);
+        plugin->getControl()->endBackgroundTask(message);
+        job->unref();
+        return luaL_error(L, "%s", error.c_str());
+    }
+
+    job->start();
+    job->unref();
+    return 0;
+}
+
 /**
  * Change page background of current page
  *
@@ -2704,6 +2808,8 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},  // Todo(gtk4) remo
                                   {"addTexts", applib_addTexts},
                                   {"getFilePath", applib_getFilePath},
                                   {"refreshPage", applib_refreshPage},
+                                  {"batchEdit", applib_batchEdit},
+                                  {"runInBackground", applib_runInBackground},
                                   {"getStrokes", applib_getStrokes},
                                   {"getImages", applib_getImages},
                                   {"getTexts", applib_getTexts},
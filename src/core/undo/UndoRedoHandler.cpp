@@ -52,15 +52,11 @@ constexpr bool UNDO_TRACE = false;
 void UndoRedoHandler::printContents() {
     if constexpr (UNDO_TRACE)  // NOLINT
     {
-        g_message("redoList");             // NOLINT
-        printUndoList(this->redoList);     // NOLINT
-        g_message("undoList");             // NOLINT
-        printUndoList(this->undoList);     // NOLINT
-        g_message("savedUndo");            // NOLINT
-        if (this->savedUndo)               // NOLINT
-        {                                  // NOLINT
-            printAction(this->savedUndo);  // NOLINT
-        }                                  // NOLINT
+        g_message("redoList");                                // NOLINT
+        printUndoList(this->redoList);                        // NOLINT
+        g_message("undoList");                                // NOLINT
+        printUndoList(this->undoList);                        // NOLINT
+        g_message("savedState %" PRIu64, this->savedState);  // NOLINT
     }
 }
 
@@ -77,10 +73,11 @@ void UndoRedoHandler::clearContents() {
 #endif  // UNDO_TRACE
 
     undoList.clear();
+    undoIds.clear();
     clearRedo();
 
-    this->savedUndo = nullptr;
-    this->autosavedUndo = nullptr;
+    this->savedState = 0;
+    this->autosavedState = 0;
 
     printContents();
 }
@@ -92,6 +89,7 @@ void UndoRedoHandler::clearRedo() {
     }
 #endif
     redoList.clear();
+    redoIds.clear();
     printContents();
 }
 
@@ -105,6 +103,8 @@ void UndoRedoHandler::undo() {
     auto& undoAction = *this->undoList.back();
     this->redoList.emplace_back(std::move(this->undoList.back()));
     this->undoList.pop_back();
+    this->redoIds.push_back(this->undoIds.back());
+    this->undoIds.pop_back();
 
     Document* doc = control->getDocument();
     doc->lock();
@@ -134,6 +134,8 @@ void UndoRedoHandler::redo() {
 
     this->undoList.emplace_back(std::move(this->redoList.back()));
     this->redoList.pop_back();
+    this->undoIds.push_back(this->redoIds.back());
+    this->redoIds.pop_back();
 
     Document* doc = control->getDocument();
     doc->lock();
@@ -165,6 +167,7 @@ void UndoRedoHandler::addUndoAction(UndoActionPtr action) {
     }
 
     this->undoList.emplace_back(std::move(action));
+    this->undoIds.push_back(this->nextId++);
     clearRedo();
     fireUpdateUndoRedoButtons(this->undoList.back()->getPages());
 
@@ -198,36 +201,34 @@ auto UndoRedoHandler::redoDescription() -> string {
 void UndoRedoHandler::fireUpdateUndoRedoButtons(const std::vector<PageRef>& pages) {
     for (auto&& undoRedoListener: this->listener) { undoRedoListener->undoRedoChanged(); }
 
+    bool pageChanged = false;
     for (PageRef page: pages) {
         if (!page) {
             continue;
         }
 
+        pageChanged = true;
         for (auto&& undoRedoListener: this->listener) { undoRedoListener->undoRedoPageChanged(page); }
     }
+
+    if (!pageChanged) {
+        for (auto&& undoRedoListener: this->listener) { undoRedoListener->undoRedoDocumentChanged(); }
+    }
 }
 
 void UndoRedoHandler::addUndoRedoListener(UndoRedoListener* listener) { this->listener.emplace_back(listener); }
 
-auto UndoRedoHandler::isChanged() -> bool {
-    if (this->undoList.empty()) {
-        return this->savedUndo;
-    }
+auto UndoRedoHandler::isChanged() -> bool { return this->savedState != getCurrentState(); }
 
-    return this->savedUndo != this->undoList.back().get();
-}
+auto UndoRedoHandler::isChangedAutosave() -> bool { return this->autosavedState != getCurrentState(); }
 
-auto UndoRedoHandler::isChangedAutosave() -> bool {
-    if (this->undoList.empty()) {
-        return this->autosavedUndo;
-    }
-    return this->autosavedUndo != this->undoList.back().get();
-}
+void UndoRedoHandler::documentAutosaved() { this->autosavedState = getCurrentState(); }
 
-void UndoRedoHandler::documentAutosaved() {
-    this->autosavedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
-}
+void UndoRedoHandler::documentSaved() { this->savedState = getCurrentState(); }
 
-void UndoRedoHandler::documentSaved() {
-    this->savedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
+void UndoRedoHandler::documentSaved(StateId savedState) {
+    // If the saved state was undone and discarded by a new action since, no state will ever match it again
+    this->savedState = savedState;
 }
+
+auto UndoRedoHandler::getCurrentState() const -> StateId { return this->undoIds.empty() ? 0 : this->undoIds.back(); }
@@ -11,9 +11,10 @@
 
 #pragma once
 
-#include <deque>   // for deque
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstdint>  // for uint64_t
+#include <deque>    // for deque
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
@@ -26,11 +27,22 @@ public:
     virtual void undoRedoChanged() = 0;
     virtual void undoRedoPageChanged(PageRef page) = 0;
 
+    /**
+     * An action changed the document without telling which page, e.g. renaming a layer
+     */
+    virtual void undoRedoDocumentChanged() {}
+
     virtual ~UndoRedoListener() = default;
 };
 
 class UndoRedoHandler {
 public:
+    /**
+     * Identifies a state of the document: the id of the last action of the undo list, or 0 if it is empty. Unlike the
+     * addresses of the actions, ids are never reused.
+     */
+    using StateId = uint64_t;
+
     explicit UndoRedoHandler(Control* control);
     virtual ~UndoRedoHandler();
 
@@ -55,6 +67,17 @@ public:
     void documentAutosaved();
     void documentSaved();
 
+    /**
+     * The document was saved as it was in savedState, which may be older than the current state if the document was
+     * edited during the save.
+     */
+    void documentSaved(StateId savedState);
+
+    /**
+     * @return the state to pass to documentSaved() once the document as it is now has been saved
+     */
+    StateId getCurrentState() const;
+
 private:
     void clearRedo();
     void printContents();
@@ -63,8 +86,15 @@ private:
     std::deque<UndoActionPtr> undoList;
     std::deque<UndoActionPtr> redoList;
 
-    UndoAction* savedUndo = nullptr;
-    UndoAction* autosavedUndo = nullptr;
+    /**
+     * The ids of the actions of undoList and redoList, in the same order
+     */
+    std::deque<StateId> undoIds;
+    std::deque<StateId> redoIds;
+    StateId nextId = 1;
+
+    StateId savedState = 0;
+    StateId autosavedState = 0;
 
     std::vector<UndoRedoListener*> listener;
 
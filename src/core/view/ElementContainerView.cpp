@@ -1,6 +1,5 @@
 #include "ElementContainerView.h"
 
-#include <memory>  // for unique_ptr
 #include <vector>  // for vector
 
 #include "model/ElementContainer.h"  // for ElementContainer
@@ -15,7 +14,6 @@ ElementContainerView::ElementContainerView(const ElementContainer* container): c
 
 void ElementContainerView::draw(const Context& ctx) const {
     for (Element* e: container->getElements()) {
-        auto elementView = ElementView::createFromElement(e);
-        elementView->draw(ctx);
+        ElementView::drawElement(e, ctx);
     }
 }
@@ -1,5 +1,3 @@
-#include <memory>  // for make_unique, unique_ptr
-
 #include "model/Element.h"   // for Element, ELEMENT_IMAGE, ELEMENT_STROKE
 #include "model/Image.h"     // for Image
 #include "model/Stroke.h"    // for Stroke
@@ -15,18 +13,22 @@
 
 using namespace xoj::view;
 
-auto ElementView::createFromElement(const Element* e) -> std::unique_ptr<ElementView> {
+void ElementView::drawElement(const Element* e, const Context& ctx) {
+    // The type tells the class of the element, no need for a dynamic_cast
     switch (e->getType()) {
         case ELEMENT_STROKE:
-            return std::make_unique<StrokeView>(dynamic_cast<const Stroke*>(e));
+            StrokeView(static_cast<const Stroke*>(e)).draw(ctx);
+            break;
         case ELEMENT_TEXT:
-            return std::make_unique<TextView>(dynamic_cast<const Text*>(e));
+            TextView(static_cast<const Text*>(e)).draw(ctx);
+            break;
         case ELEMENT_IMAGE:
-            return std::make_unique<ImageView>(dynamic_cast<const Image*>(e));
+            ImageView(static_cast<const Image*>(e)).draw(ctx);
+            break;
         case ELEMENT_TEXIMAGE:
-            return std::make_unique<TexImageView>(dynamic_cast<const TexImage*>(e));
+            TexImageView(static_cast<const TexImage*>(e)).draw(ctx);
+            break;
         default:
-            xoj_assert_message(false, "ElementView::getFromElement: Unknown element type!");
-            return nullptr;
+            xoj_assert_message(false, "ElementView::drawElement: Unknown element type!");
     }
 }
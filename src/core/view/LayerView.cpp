@@ -1,6 +1,5 @@
 #include "LayerView.h"
 
-#include <memory>  // for unique_ptr
 #include <vector>  // for vector
 
 #include <cairo.h>  // for cairo_clip_extents, cairo_rectangle
@@ -40,7 +39,7 @@ void LayerView::draw(const Context& ctx) const {
         });
 
         if (e->intersectsArea(minX, minY, maxX - minX, maxY - minY)) {
-            ElementView::createFromElement(e)->draw(ctx);
+            ElementView::drawElement(e, ctx);
             IF_DEBUG_REPAINT(drawn++;);
         }
         IF_DEBUG_REPAINT(else { notDrawn++; });
@@ -1,5 +1,6 @@
 #include "Mask.h"
 
+#include <algorithm>  // for max, min
 #include <iostream>
 
 #include <cairo.h>
@@ -63,8 +64,8 @@ void Mask::constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom
                                                  " -- " + std::to_string(extent.maxY));
     xoj_assert(zoom > 0.0);
 
-    const int width = ceil_cast<int>(extent.maxX * zoom) - xOffset;
-    const int height = ceil_cast<int>(extent.maxY * zoom) - yOffset;
+    this->width = ceil_cast<int>(extent.maxX * zoom) - xOffset;
+    this->height = ceil_cast<int>(extent.maxY * zoom) - yOffset;
 
     /*
      * Create the most suitable kind of surface.
@@ -84,6 +85,13 @@ void Mask::constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom
         std::cout << "  Its DPI scaling: " << x << " x " << y << std::endl;
     });
 
+    double scaleX = 1.0;
+    double scaleY = 1.0;
+    cairo_surface_get_device_scale(surf, &scaleX, &scaleY);
+    const size_t bytesPerPixel = contentType == CAIRO_CONTENT_ALPHA ? 1 : 4;
+    this->memorySize = static_cast<size_t>(std::max(0, ceil_cast<int>(width * scaleX))) *
+                       static_cast<size_t>(std::max(0, ceil_cast<int>(height * scaleY))) * bytesPerPixel;
+
     this->cr.reset(cairo_create(surf), xoj::util::adopt);
     cairo_surface_destroy(surf);  // surf is now owned by this->cr
 
@@ -109,11 +117,53 @@ void Mask::blitTo(cairo_t* targetCr) const {
     cairo_mask_surface(targetCr, cairo_get_target(const_cast<cairo_t*>(cr.get())), xOffset, yOffset);
 }
 
-void Mask::paintTo(cairo_t* targetCr) const {
+void Mask::blitTo(cairo_t* targetCr, const Range& area) const {
+    xoj_assert(isInitialized());
+    if (!area.isValid()) {
+        return;
+    }
+    xoj::util::CairoSaveGuard guard(targetCr);
+    cairo_scale(targetCr, 1. / zoom, 1. / zoom);
+    // Align the clip on the pixels of the mask, so cairo does not need an antialiased clip
+    const int x1 = std::max(floor_cast<int>(area.minX * zoom), xOffset);
+    const int y1 = std::max(floor_cast<int>(area.minY * zoom), yOffset);
+    const int x2 = std::min(ceil_cast<int>(area.maxX * zoom), xOffset + width);
+    const int y2 = std::min(ceil_cast<int>(area.maxY * zoom), yOffset + height);
+    if (x1 >= x2 || y1 >= y2) {
+        return;
+    }
+    cairo_rectangle(targetCr, x1, y1, x2 - x1, y2 - y1);
+    cairo_clip(targetCr);
+    cairo_mask_surface(targetCr, cairo_get_target(const_cast<cairo_t*>(cr.get())), xOffset, yOffset);
+}
+
+auto Mask::isCompatible(cairo_surface_t* target, const Range& extent, double zoom, cairo_content_t contentType) const
+        -> bool {
+    if (!isInitialized() || zoom != this->zoom || !extent.isValid()) {
+        return false;
+    }
+    cairo_surface_t* surf = cairo_get_target(const_cast<cairo_t*>(cr.get()));
+    if (cairo_surface_get_type(surf) != cairo_surface_get_type(target) ||
+        cairo_surface_get_content(surf) != contentType) {
+        return false;
+    }
+    double scaleX = 1.0, scaleY = 1.0, targetScaleX = 1.0, targetScaleY = 1.0;
+    cairo_surface_get_device_scale(surf, &scaleX, &scaleY);
+    cairo_surface_get_device_scale(target, &targetScaleX, &targetScaleY);
+    if (scaleX != targetScaleX || scaleY != targetScaleY) {
+        return false;
+    }
+    return floor_cast<int>(extent.minX * zoom) >= xOffset && floor_cast<int>(extent.minY * zoom) >= yOffset &&
+           ceil_cast<int>(extent.maxX * zoom) <= xOffset + width &&
+           ceil_cast<int>(extent.maxY * zoom) <= yOffset + height;
+}
+
+void Mask::paintTo(cairo_t* targetCr, cairo_filter_t filter) const {
     xoj_assert(isInitialized());
     xoj::util::CairoSaveGuard guard(targetCr);
     cairo_scale(targetCr, 1. / zoom, 1. / zoom);
     cairo_set_source_surface(targetCr, cairo_get_target(const_cast<cairo_t*>(cr.get())), xOffset, yOffset);
+    cairo_pattern_set_filter(cairo_get_source(targetCr), filter);
     cairo_paint(targetCr);
 }
 
@@ -137,7 +187,12 @@ void Mask::wipeRange(const Range& rg) {
     wipe();
 }
 
-void Mask::reset() { cr.reset(); }
+void Mask::reset() {
+    cr.reset();
+    width = 0;
+    height = 0;
+    memorySize = 0;
+}
 
 #ifdef DEBUG_MASKS
 namespace {
@@ -11,12 +11,14 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+
 #include <cairo.h>
 #include <gdk/gdk.h>
 
+#include "util/Range.h"  // for Range
 #include "util/raii/CairoWrappers.h"
 
-class Range;
 
 namespace xoj::view {
 
@@ -53,10 +55,17 @@ public:
      * @brief Use the surface as a mask
      */
     void blitTo(cairo_t* targetCr) const;
+    /**
+     * @brief Use the part of the surface within the given area as a mask. Cheaper than blitTo(targetCr) if only a
+     * small part of the surface was drawn on.
+     * @param area The area, in local coordinates. Outside of it, the surface must be blank.
+     */
+    void blitTo(cairo_t* targetCr, const Range& area) const;
     /**
      * @brief Paint the content of the surface to the target cairo context
+     * @param filter The filter used to scale the surface, if its zoom differs from the target's
      */
-    void paintTo(cairo_t* targetCr) const;
+    void paintTo(cairo_t* targetCr, cairo_filter_t filter = CAIRO_FILTER_GOOD) const;
     /**
      * @brief Erase all the surface's content
      */
@@ -73,8 +82,20 @@ public:
      */
     void reset();
 
+    /**
+     * @brief Check if the mask could be used in place of Mask(target, extent, zoom, contentType), i.e. it is at least as
+     * large and blits to the same kind of surface.
+     */
+    bool isCompatible(cairo_surface_t* target, const Range& extent, double zoom,
+                      cairo_content_t contentType = CAIRO_CONTENT_ALPHA) const;
+
     inline double getZoom() const { return zoom; }
 
+    /**
+     * @brief Approximate memory used by the surface, in bytes (0 if not initialized)
+     */
+    inline size_t getMemorySize() const { return memorySize; }
+
 private:
     template <typename DPIInfoType>
     void constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom, cairo_content_t contentType);
@@ -82,6 +103,17 @@ private:
     xoj::util::CairoSPtr cr;
     int xOffset = 0;
     int yOffset = 0;
+    int width = 0;   ///< In device space coordinates
+    int height = 0;  ///< In device space coordinates
     double zoom = 1.0;
+    size_t memorySize = 0;
+};
+
+/**
+ * @brief A mask kept for reuse, and the part of it that was drawn on
+ */
+struct RecycledMask {
+    Mask mask;
+    Range touched;  ///< In local coordinates
 };
 };  // namespace xoj::view
@@ -21,6 +21,7 @@ class Rectangle;
 namespace xoj::view {
 class OverlayView;
 class ToolView;
+struct RecycledMask;
 
 class Repaintable {
 public:
@@ -64,5 +65,12 @@ public:
      * the display
      */
     virtual void deleteOverlayView(OverlayView* v, const Range& rg) = 0;
+
+    /**
+     * @brief Storage for the mask of the last stroke drawn on this repaintable, which the next stroke may reuse (see
+     * BaseStrokeToolView). Only accessed from the UI thread.
+     * @return nullptr if masks are not kept
+     */
+    virtual RecycledMask* getRecycledMask() { return nullptr; }
 };
 };  // namespace xoj::view
@@ -11,13 +11,6 @@
 
 #pragma once
 
-#include <string>  // for string
-#include <vector>  // for vector
-
-#include <pango/pangocairo.h>  // for PangoLayout, cairo_t
-
-#include "util/raii/GObjectSPtr.h"
-
 #include "View.h"  // for ElementView
 
 class Text;
@@ -32,11 +25,6 @@ public:
      */
     void draw(const Context& ctx) const override;
 
-    /**
-     * Initialize a Pango layout
-     */
-    static xoj::util::GObjectSPtr<PangoLayout> initPango(cairo_t* cr, const Text* t);
-
 private:
     const Text* text;
 };
@@ -11,8 +11,6 @@
 
 #pragma once
 
-#include <memory>
-
 #include <gtk/gtk.h>
 
 class Element;
@@ -39,7 +37,11 @@ class ElementView {
 public:
     virtual ~ElementView() = default;
     virtual void draw(const Context& ctx) const = 0;
-    static std::unique_ptr<ElementView> createFromElement(const Element* e);
+
+    /**
+     * Draws the element with a view of its type, constructed on the stack: no allocation per element and render
+     */
+    static void drawElement(const Element* e, const Context& ctx);
 };
 
 class TexImageView;
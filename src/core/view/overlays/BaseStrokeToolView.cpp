@@ -1,6 +1,7 @@
 #include "BaseStrokeToolView.h"
 
 #include <cmath>
+#include <utility>
 
 #include <cairo.h>
 
@@ -47,12 +48,29 @@ auto BaseStrokeToolView::createMask(cairo_t* tgtcr) const -> Mask {
     // area's border
     visibleRange.addPadding(0.5 * this->strokeWidth);
 
-    Mask mask(cairo_get_target(tgtcr), visibleRange, zoom);
+    Mask mask;
+    RecycledMask* recycled = this->parent->getRecycledMask();
+    if (recycled && recycled->mask.isCompatible(cairo_get_target(tgtcr), visibleRange, zoom)) {
+        mask = std::move(recycled->mask);
+        if (recycled->touched.isValid()) {
+            mask.wipeRange(recycled->touched);
+        }
+        *recycled = RecycledMask();
+    } else {
+        mask = Mask(cairo_get_target(tgtcr), visibleRange, zoom);
+    }
     cairo_t* cr = mask.get();
 
     cairo_set_source_rgba(cr, 1, 1, 1, 1);
     cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
     cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
     cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+    cairo_set_dash(cr, nullptr, 0, 0);
     return mask;
 }
+
+void BaseStrokeToolView::recycleMask(Mask&& mask, const Range& touched) const {
+    if (RecycledMask* recycled = this->parent->getRecycledMask(); recycled && mask.isInitialized()) {
+        *recycled = {std::move(mask), touched};
+    }
+}
@@ -17,6 +17,7 @@
 #include "util/Color.h"
 #include "view/overlays/OverlayView.h"
 
+class Range;
 class Stroke;
 
 namespace xoj::view {
@@ -32,9 +33,18 @@ protected:
      * @brief Creates a mask corresponding to the parent's visible area.
      * The mask is optimized (?) to be blitted to a surface of the same type as cairo_get_target(targetCr).
      * If targetCr == nullptr, the surface is of CAIRO_SURFACE_TYPE_IMAGE.
+     *
+     * If the mask recycled by the previous stroke on the parent covers the visible area, it is wiped where it was
+     * drawn on and reused instead: allocating and clearing a mask of the size of the screen at each pen down is slow.
      */
     Mask createMask(cairo_t* targetCr) const;
 
+    /**
+     * @brief Hand the mask over to the parent, for the next call to createMask()
+     * @param touched The part of the mask that was drawn on, in local coordinates
+     */
+    void recycleMask(Mask&& mask, const Range& touched) const;
+
     /**
      * @brief Helper function to get a color whose alpha value depends on the tool's properties
      */
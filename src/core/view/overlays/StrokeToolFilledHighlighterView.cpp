@@ -16,7 +16,7 @@ StrokeToolFilledHighlighterView::StrokeToolFilledHighlighterView(const StrokeHan
 
 StrokeToolFilledHighlighterView::~StrokeToolFilledHighlighterView() noexcept = default;
 
-void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
+void StrokeToolFilledHighlighterView::drawWithoutDrawingAids(cairo_t* cr) const {
 
     std::vector<Point> pts = this->flushBuffer();
     if (pts.empty()) {
@@ -69,5 +69,5 @@ void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
     Util::cairo_set_source_argb(cr, this->strokeColor);
     cairo_set_operator(cr, this->cairoOp);
 
-    this->mask.blitTo(cr);
+    this->mask.blitTo(cr, this->maskTouched);
 }
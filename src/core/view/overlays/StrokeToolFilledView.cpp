@@ -42,7 +42,7 @@ void StrokeToolFilledView::on(StrokeToolView::AddPointRequest, const Point& p) {
     auto rg = this->getRepaintRange(lastPoint, p);
     // Add the first point, so that the range covers all the filling changes
     rg.addPoint(this->filling.firstPoint.x, this->filling.firstPoint.y);
-    this->parent->flagDirtyRegion(rg);
+    this->flagDirtyRegion(rg);
 }
 
 void StrokeToolFilledView::on(StrokeToolView::StrokeReplacementRequest, const Stroke& newStroke) {
@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 #include <numeric>
+#include <utility>
 
 #include "control/tools/StrokeHandler.h"
 #include "model/LineStyle.h"
@@ -20,14 +21,22 @@ using namespace xoj::view;
 StrokeToolView::StrokeToolView(const StrokeHandler* strokeHandler, const Stroke& stroke, Repaintable* parent):
         BaseStrokeToolView(parent, stroke), strokeHandler(strokeHandler), pointBuffer(stroke.getPointVector()) {
     this->registerToPool(strokeHandler->getViewPool());
-    parent->flagDirtyRegion(Range(stroke.boundingRect()));
+    this->flagDirtyRegion(Range(stroke.boundingRect()));
 }
 
-StrokeToolView::~StrokeToolView() noexcept { this->unregisterFromPool(); }
+StrokeToolView::~StrokeToolView() noexcept {
+    this->unregisterFromPool();
+    recycleMask(std::move(this->mask), this->maskTouched);
+}
 
 bool StrokeToolView::isViewOf(const OverlayBase* overlay) const { return overlay == this->strokeHandler; }
 
 void StrokeToolView::draw(cairo_t* cr) const {
+    this->drawWithoutDrawingAids(cr);
+    this->drawPrediction(cr);
+}
+
+void StrokeToolView::drawWithoutDrawingAids(cairo_t* cr) const {
 
     std::vector<Point> pts = this->flushBuffer();
     if (pts.empty()) {
@@ -75,7 +84,7 @@ void StrokeToolView::draw(cairo_t* cr) const {
         this->drawDot(this->mask.get(), pts.back());
     }
 
-    this->mask.blitTo(cr);
+    this->mask.blitTo(cr, this->maskTouched);
 }
 
 void StrokeToolView::on(StrokeToolView::AddPointRequest, const Point& p) {
@@ -83,7 +92,7 @@ void StrokeToolView::on(StrokeToolView::AddPointRequest, const Point& p) {
     xoj_assert(!this->pointBuffer.empty());  // front() is the last point we painted on the mask (see flushBuffer())
     Point lastPoint = this->pointBuffer.back();
     this->pointBuffer.emplace_back(p);
-    this->parent->flagDirtyRegion(this->getRepaintRange(lastPoint, p));
+    this->flagDirtyRegion(this->getRepaintRange(lastPoint, p));
 }
 
 void StrokeToolView::on(StrokeToolView::ThickenFirstPointRequest, double newWidth) {
@@ -94,16 +103,36 @@ void StrokeToolView::on(StrokeToolView::ThickenFirstPointRequest, double newWidt
     p.z = newWidth;
     Range rg = Range(p.x, p.y);
     rg.addPadding(0.5 * newWidth);
-    this->parent->flagDirtyRegion(rg);
+    this->flagDirtyRegion(rg);
+}
+
+void StrokeToolView::on(StrokeToolView::PredictionRequest, const std::vector<Point>& points) {
+    if (this->predictionRange.isValid()) {
+        this->parent->flagDirtyRegion(this->predictionRange);
+    }
+    this->prediction = points;
+    this->predictionRange = Range();
+    for (const Point& p: this->prediction) {
+        this->predictionRange.addPoint(p.x, p.y);
+    }
+    if (this->predictionRange.isValid()) {
+        const Point& first = this->prediction.front();
+        this->predictionRange.addPadding(0.5 * (first.z == Point::NO_PRESSURE ? this->strokeWidth : first.z));
+        this->parent->flagDirtyRegion(this->predictionRange);
+    }
 }
 
 void StrokeToolView::deleteOn(StrokeToolView::CancellationRequest, const Range& rg) {
     this->pointBuffer.clear();
-    this->parent->drawAndDeleteToolView(this, rg);
+    this->parent->drawAndDeleteToolView(this, rg.unite(this->predictionRange));
 }
 
 void StrokeToolView::on(StrokeToolView::StrokeReplacementRequest, const Stroke& newStroke) {
-    this->mask.wipe();
+    if (this->mask.isInitialized() && this->maskTouched.isValid()) {
+        this->mask.wipeRange(this->maskTouched);
+    }
+    this->maskTouched = Range(newStroke.boundingRect());
+    this->prediction.clear();
     this->pointBuffer = newStroke.getPointVector();
     this->dashOffset = 0;
     this->strokeWidth = newStroke.getWidth();
@@ -114,7 +143,8 @@ void StrokeToolView::on(StrokeToolView::StrokeReplacementRequest, const Stroke&
 }
 
 void StrokeToolView::deleteOn(StrokeToolView::FinalizationRequest, const Range& rg) {
-    this->parent->drawAndDeleteToolView(this, rg);
+    // The predicted ink is not part of the stroke: it must be erased from the screen
+    this->parent->drawAndDeleteToolView(this, rg.unite(this->predictionRange));
 }
 
 auto StrokeToolView::getRepaintRange(const Point& lastPoint, const Point& addedPoint) const -> Range {
@@ -125,6 +155,11 @@ auto StrokeToolView::getRepaintRange(const Point& lastPoint, const Point& addedP
     return rg;
 }
 
+void StrokeToolView::flagDirtyRegion(const Range& rg) {
+    this->maskTouched = this->maskTouched.unite(rg);
+    this->parent->flagDirtyRegion(rg);
+}
+
 void StrokeToolView::drawDot(cairo_t* cr, const Point& p) const {
     cairo_set_line_width(cr, p.z == Point::NO_PRESSURE ? this->strokeWidth : p.z);
     cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
@@ -133,6 +168,20 @@ void StrokeToolView::drawDot(cairo_t* cr, const Point& p) const {
     cairo_stroke(cr);
 }
 
+void StrokeToolView::drawPrediction(cairo_t* cr) const {
+    if (this->prediction.size() < 2 || this->cairoOp != CAIRO_OPERATOR_OVER) {
+        // The highlighter's color would add up where the prediction overlaps the stroke
+        return;
+    }
+    xoj::util::CairoSaveGuard saveGuard(cr);
+    Util::cairo_set_source_argb(cr, strokeColor);
+    if (this->prediction.front().z == Point::NO_PRESSURE) {
+        StrokeViewHelper::drawNoPressure(cr, this->prediction, this->strokeWidth, this->lineStyle, this->dashOffset);
+    } else {
+        StrokeViewHelper::drawWithPressure(cr, this->prediction, this->lineStyle, this->dashOffset);
+    }
+}
+
 std::vector<Point> StrokeToolView::flushBuffer() const {
     std::vector<Point> pts;
     std::swap(this->pointBuffer, pts);
@@ -15,13 +15,13 @@
 #include <cairo.h>
 
 #include "util/DispatchPool.h"
+#include "util/Range.h"
 #include "view/Mask.h"
 
 #include "BaseStrokeToolView.h"
 
 class StrokeHandler;
 class Point;
-class Range;
 class Stroke;
 class OverlayBase;
 
@@ -35,7 +35,11 @@ public:
 
     bool isViewOf(const OverlayBase* overlay) const override;
 
+    /**
+     * @brief Draws the stroke and the predicted ink ahead of it (if any)
+     */
     void draw(cairo_t* cr) const override;
+    void drawWithoutDrawingAids(cairo_t* cr) const override;
 
     /**
      * Listener interface
@@ -52,6 +56,13 @@ public:
     } STROKE_REPLACEMENT_REQUEST = {};
     virtual void on(StrokeReplacementRequest, const Stroke& newStroke);
 
+    /**
+     * @brief Replace the predicted ink. The first point is the end of the stroke. An empty vector removes it.
+     */
+    static constexpr struct PredictionRequest {
+    } PREDICTION_REQUEST = {};
+    void on(PredictionRequest, const std::vector<Point>& points);
+
     static constexpr struct CancellationRequest {
     } CANCELLATION_REQUEST = {};
     void deleteOn(CancellationRequest, const Range& rg);
@@ -69,8 +80,15 @@ protected:
      */
     auto getRepaintRange(const Point& lastPoint, const Point& addedPoint) const -> Range;
 
+    /**
+     * @brief Flag the range as dirty in the parent and remember that it will be drawn on the mask
+     */
+    void flagDirtyRegion(const Range& rg);
+
     void drawDot(cairo_t* cr, const Point& p) const;
 
+    void drawPrediction(cairo_t* cr) const;
+
     /**
      * @brief (Thread-safe) Flush the communication buffer and returns its content.
      */
@@ -104,5 +122,18 @@ protected:
      * Upon calls to draw(), the buffer is flushed and the corresponding part of stroke is added to the mask.
      */
     mutable Mask mask;
+
+    /**
+     * @brief The part of the mask drawn on (or about to be). Only this part is blitted, and wiped when the mask is
+     * reused by another stroke.
+     */
+    Range maskTouched;
+
+    /**
+     * @brief Where the pen is expected to be in the next few ms. Drawn directly (not on the mask) and never added to
+     * the stroke, so it disappears as soon as the actual points come in.
+     */
+    std::vector<Point> prediction;
+    Range predictionRange;
 };
 };  // namespace xoj::view
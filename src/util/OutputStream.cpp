@@ -1,7 +1,8 @@
 #include "util/OutputStream.h"
 
-#include <cstring>  // for strlen
-#include <utility>  // for move
+#include <algorithm>  // for min
+#include <cstring>    // for strlen
+#include <utility>    // for move
 
 #include "util/GzUtil.h"  // for GzUtil
 #include "util/i18n.h"    // for FS, _F
@@ -18,15 +19,75 @@ void OutputStream::write(const char* str) { write(str, static_cast<unsigned int>
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
-    if (this->fp == nullptr) {
+namespace {
+/// Size of the uncompressed blocks compressed in parallel
+constexpr size_t BLOCK_SIZE = 128 * 1024;
+/// Each block is compressed with the end of the previous one as dictionary: deflate refers back at most 32 KiB
+constexpr size_t DICTIONARY_SIZE = 32 * 1024;
+
+void writeLE32(std::ofstream& out, uLong value) {
+    const char bytes[] = {static_cast<char>(value & 0xff), static_cast<char>((value >> 8) & 0xff),
+                          static_cast<char>((value >> 16) & 0xff), static_cast<char>((value >> 24) & 0xff)};
+    out.write(bytes, sizeof(bytes));
+}
+
+/**
+ * An empty gzip member: a header with the extra field, an empty final deflate block, then the CRC and size (both 0)
+ */
+void writeExtraMember(std::ofstream& out, const std::string& extra) {
+    const char header[] = {'\x1f', '\x8b', 8, 4 /* FEXTRA */, 0, 0, 0, 0, 0, '\xff'};
+    out.write(header, sizeof(header));
+    const char extraLength[] = {static_cast<char>(extra.size() & 0xff), static_cast<char>((extra.size() >> 8) & 0xff)};
+    out.write(extraLength, sizeof(extraLength));
+    out.write(extra.data(), static_cast<std::streamsize>(extra.size()));
+    const char emptyBlock[] = {3, 0};
+    out.write(emptyBlock, sizeof(emptyBlock));
+    writeLE32(out, 0);
+    writeLE32(out, 0);
+}
+}  // namespace
+
+GzOutputStream::GzOutputStream(fs::path file, int level, unsigned int threads, const std::string& extra):
+        file(std::move(file)), level(level), threads(threads) {
+    const bool writeExtra = !extra.empty() && extra.size() <= 0xffff;
+    if (writeExtra) {
+        std::ofstream header(this->file, std::ios::binary | std::ios::trunc);
+        writeExtraMember(header, extra);
+        if (!header) {
+            this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
+            return;
+        }
+    }
+
+    if (threads <= 1) {
+        // Appending starts a new gzip member after the one with the extra field
+        std::string mode = writeExtra ? "a" : "w";
+        if (level >= 0 && level <= 9) {
+            mode += static_cast<char>('0' + level);
+        }
+        this->fp = GzUtil::openPath(this->file, mode);
+        if (this->fp == nullptr) {
+            this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
+        }
+        return;
+    }
+
+    this->out.open(this->file, std::ios::binary | (writeExtra ? std::ios::app : std::ios::trunc));
+    if (!this->out) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
+        return;
     }
+    this->opened = true;
+    this->crc = crc32(0, nullptr, 0);
+    this->block.reserve(BLOCK_SIZE);
+
+    // gzip header: magic, deflate, no flags, no modification time, no extra flags, unknown OS
+    const char header[] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'};
+    this->out.write(header, sizeof(header));
 }
 
 GzOutputStream::~GzOutputStream() {
-    if (this->fp) {
+    if (this->fp || this->opened) {
         close();
     }
     this->fp = nullptr;
@@ -34,11 +95,91 @@ GzOutputStream::~GzOutputStream() {
 
 auto GzOutputStream::getLastError() -> std::string& { return this->error; }
 
-void GzOutputStream::write(const char* data, unsigned int len) { gzwrite(this->fp, data, len); }
+void GzOutputStream::write(const char* data, unsigned int len) {
+    if (this->fp) {
+        gzwrite(this->fp, data, len);
+        return;
+    }
+    if (!this->opened) {
+        return;
+    }
+
+    while (len > 0) {
+        size_t n = std::min<size_t>(len, BLOCK_SIZE - this->block.size());
+        this->block.append(data, n);
+        data += n;
+        len -= static_cast<unsigned int>(n);
+        if (this->block.size() == BLOCK_SIZE) {
+            compressBlock(false);
+        }
+    }
+}
+
+void GzOutputStream::compressBlock(bool last) {
+    auto compress = [level = this->level, last](std::string input, std::string dictionary) {
+        CompressedBlock result{{}, crc32(0, nullptr, 0), input.size()};
+        result.crc = crc32(result.crc, reinterpret_cast<const Bytef*>(input.data()), static_cast<uInt>(input.size()));
+
+        // Raw deflate data, ended by a sync flush (byte aligned, not final) so that the blocks can be concatenated
+        z_stream strm{};
+        deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        if (!dictionary.empty()) {
+            deflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(dictionary.data()),
+                                 static_cast<uInt>(dictionary.size()));
+        }
+        result.data.resize(deflateBound(&strm, input.size()) + 16);
+        strm.next_in = reinterpret_cast<Bytef*>(input.data());
+        strm.avail_in = static_cast<uInt>(input.size());
+        size_t written = 0;
+        while (true) {
+            strm.next_out = reinterpret_cast<Bytef*>(result.data.data() + written);
+            strm.avail_out = static_cast<uInt>(result.data.size() - written);
+            int ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+            written = result.data.size() - strm.avail_out;
+            if ((last && ret == Z_STREAM_END) || (!last && strm.avail_out != 0) || ret == Z_STREAM_ERROR) {
+                break;
+            }
+            result.data.resize(result.data.size() * 2);
+        }
+        deflateEnd(&strm);
+        result.data.resize(written);
+        return result;
+    };
+
+    std::string input;
+    input.reserve(BLOCK_SIZE);
+    std::swap(input, this->block);
+    std::string dictionary = std::move(this->dictionary);
+    this->dictionary = input.substr(input.size() - std::min(input.size(), DICTIONARY_SIZE));
+
+    this->pending.push_back(std::async(std::launch::async, compress, std::move(input), std::move(dictionary)));
+
+    // Keep the threads busy, but do not buffer the whole file
+    while (this->pending.size() > (last ? 0 : 2 * this->threads)) {
+        writeBlock(this->pending.front().get());
+        this->pending.pop_front();
+    }
+}
+
+void GzOutputStream::writeBlock(CompressedBlock block) {
+    this->out.write(block.data.data(), static_cast<std::streamsize>(block.data.size()));
+    this->crc = crc32_combine(this->crc, block.crc, static_cast<z_off_t>(block.length));
+    this->size += block.length;
+}
 
 void GzOutputStream::close() {
     if (this->fp) {
         gzclose(this->fp);
         this->fp = nullptr;
     }
+    if (this->opened) {
+        this->opened = false;
+        compressBlock(true);
+        writeLE32(this->out, this->crc);
+        writeLE32(this->out, static_cast<uLong>(this->size & 0xffffffff));
+        this->out.close();
+        if (!this->out && this->error.empty()) {
+            this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
+        }
+    }
 }
@@ -1,6 +1,8 @@
 #include "util/Range.h"
 
-#include <algorithm>  // for max, min
+#include <algorithm>  // for max, min, copy_if, partition, sort
+#include <iterator>   // for back_inserter
+#include <utility>    // for move
 
 #include "util/Rectangle.h"
 
@@ -58,3 +60,46 @@ bool Range::contains(double x, double y) const { return x >= minX && x <= maxX &
 bool Range::contains(const xoj::util::Rectangle<double>& r) const {
     return this->minX <= r.x && this->maxX >= r.x + r.width && this->minY <= r.y && this->maxY >= r.y + r.height;
 }
+
+auto Range::coalesce(const std::vector<Range>& ranges) -> std::vector<Range> {
+    std::vector<Range> result;
+    result.reserve(ranges.size());
+    std::copy_if(ranges.begin(), ranges.end(), std::back_inserter(result),
+                 [](const Range& rg) { return rg.isValid(); });
+    auto byMinX = [](const Range& a, const Range& b) { return a.minX < b.minX; };
+
+    // Sweep over the ranges sorted by minX: a range can only overlap the previous ones which end after its minX. A
+    // merged range may grow over ranges the sweep has passed, so sweep again until a sweep merges nothing.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        std::sort(result.begin(), result.end(), byMinX);
+
+        std::vector<Range> swept;
+        swept.reserve(result.size());
+        std::vector<Range> active;
+        for (Range rg: result) {
+            // Neither rg nor any of the following ranges reach back to the ranges ending before rg
+            auto passed =
+                    std::partition(active.begin(), active.end(), [&](const Range& a) { return a.maxX >= rg.minX; });
+            swept.insert(swept.end(), passed, active.end());
+            active.erase(passed, active.end());
+
+            for (auto it = active.begin(); it != active.end();) {
+                if (rg.intersect(*it).isValid()) {
+                    rg = rg.unite(*it);
+                    it = active.erase(it);
+                    merged = true;
+                } else {
+                    ++it;
+                }
+            }
+            active.push_back(rg);
+        }
+        swept.insert(swept.end(), active.begin(), active.end());
+        result = std::move(swept);
+    }
+
+    std::sort(result.begin(), result.end(), byMinX);
+    return result;
+}
@@ -0,0 +1,168 @@
+#include "util/Trace.h"
+
+#include <chrono>   // for steady_clock, duration_cast, microseconds
+#include <cstdint>  // for uint32_t, int64_t
+#include <fstream>  // for ofstream
+#include <map>      // for map
+#include <mutex>    // for mutex, lock_guard, unique_lock
+#include <string>   // for string
+#include <utility>  // for move, swap
+#include <vector>   // for vector
+
+#include <glib.h>  // for g_warning
+
+#include "util/serdesstream.h"  // for serdes_stream
+
+namespace xoj::util::trace {
+
+std::atomic_bool enabled{false};
+
+namespace {
+struct Event {
+    const char* name;
+    const char* category;
+    int64_t start;
+    int64_t duration;
+    uint32_t thread;
+};
+
+const auto processStart = std::chrono::steady_clock::now();
+
+/**
+ * Protects the buffered events and the thread names. Taken before fileMutex.
+ */
+std::mutex mutex;
+std::vector<Event> events;
+std::map<uint32_t, std::string> threadNames;
+
+/**
+ * Protects the file, which is written without holding mutex
+ */
+std::mutex fileMutex;
+std::ofstream outputStream;
+fs::path outputFile;
+bool firstEntry = true;
+
+auto threadId() -> uint32_t {
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t id = next++;
+    return id;
+}
+
+void writeEscaped(std::ostream& out, const char* str) {
+    out << '"';
+    for (const char* c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) >= 0x20) {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * The caller must hold fileMutex
+ */
+void writeEvents(const std::vector<Event>& recorded) {
+    for (const Event& e: recorded) {
+        outputStream << (firstEntry ? "" : ",\n") << R"({"ph":"X","pid":1,"tid":)" << e.thread << R"(,"ts":)" << e.start
+            << R"(,"dur":)" << e.duration << R"(,"name":)";
+        writeEscaped(outputStream, e.name);
+        outputStream << R"(,"cat":)";
+        writeEscaped(outputStream, e.category);
+        outputStream << "}";
+        firstEntry = false;
+    }
+}
+}  // namespace
+
+void start(fs::path file) {
+    std::lock_guard lock{mutex};
+    std::lock_guard fileLock{fileMutex};
+    if (enabled) {
+        return;
+    }
+
+    outputStream = serdes_stream<std::ofstream>(file);
+    if (!outputStream) {
+        g_warning("Could not write the trace to %s", file.u8string().c_str());
+        return;
+    }
+    outputStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    outputFile = std::move(file);
+    firstEntry = true;
+    events.reserve(FLUSH_EVENTS);
+    enabled = true;
+}
+
+auto stop() -> bool {
+    std::vector<Event> recorded;
+    std::map<uint32_t, std::string> names;
+    std::unique_lock lock{mutex};
+    if (!enabled) {
+        return true;
+    }
+    enabled = false;
+    std::swap(recorded, events);
+    names = threadNames;
+
+    // Waits for the events being written by record()
+    std::lock_guard fileLock{fileMutex};
+    lock.unlock();
+
+    for (auto& [tid, name]: names) {
+        outputStream << (firstEntry ? "" : ",\n") << R"({"ph":"M","name":"thread_name","pid":1,"tid":)" << tid
+            << R"(,"args":{"name":)";
+        writeEscaped(outputStream, name.c_str());
+        outputStream << "}}";
+        firstEntry = false;
+    }
+    writeEvents(recorded);
+    outputStream << "\n]}\n";
+    outputStream.close();
+
+    if (!outputStream) {
+        g_warning("Could not write the trace to %s", outputFile.u8string().c_str());
+        return false;
+    }
+    return true;
+}
+
+void setThreadName(const char* name) {
+    thread_local bool named = false;
+    if (named) {
+        return;
+    }
+    named = true;
+
+    std::lock_guard lock{mutex};
+    threadNames[threadId()] = name;
+}
+
+auto now() -> int64_t {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - processStart)
+            .count();
+}
+
+void record(const char* name, const char* category, int64_t start, int64_t duration) {
+    uint32_t thread = threadId();
+    std::unique_lock lock{mutex};
+    if (!enabled) {
+        return;
+    }
+    events.push_back({name, category, start, duration, thread});
+    if (events.size() < FLUSH_EVENTS) {
+        return;
+    }
+
+    // Only this thread waits for the file, the others can go on recording meanwhile
+    std::vector<Event> recorded;
+    recorded.reserve(FLUSH_EVENTS);
+    std::swap(recorded, events);
+    std::lock_guard fileLock{fileMutex};
+    lock.unlock();
+    writeEvents(recorded);
+}
+
+}  // namespace xoj::util::trace
@@ -1,8 +1,10 @@
 #include "util/XojPreviewExtractor.h"
 
 #include <array>    // for array
-#include <cstring>  // for strlen, strncmp
+#include <cstring>  // for memcpy, strlen, strncmp
+#include <fstream>  // for ifstream, istream
 #include <string>   // for allocator, string
+#include <vector>   // for vector
 
 #include <glib.h>     // for g_free, g_base64_decode, g_malloc, gsize
 #include <zip.h>      // for zip_close, zip_fclose, zip_stat_t, zip_fopen
@@ -23,6 +25,15 @@ const char* TAG_PREVIEW_END_NAME = "/preview";
 const size_t TAG_PREVIEW_END_NAME_LEN = strlen(TAG_PREVIEW_END_NAME);
 constexpr auto BUF_SIZE = 8192;
 
+/// ID of the subfield of the gzip extra field (RFC 1952) with the preview
+constexpr unsigned char PREVIEW_SUBFIELD_ID[] = {'X', 'P'};
+/// The extra field length is a 16 bit value, and each subfield has a 4 byte header
+constexpr size_t MAX_EXTRA_FIELD_LEN = 0xffff;
+constexpr size_t SUBFIELD_HEADER_LEN = 4;
+constexpr unsigned char GZIP_FLAG_EXTRA = 4;
+
+static auto readLE16(const unsigned char* bytes) -> size_t { return bytes[0] | static_cast<size_t>(bytes[1]) << 8; }
+
 XojPreviewExtractor::XojPreviewExtractor() = default;
 
 XojPreviewExtractor::~XojPreviewExtractor() {
@@ -39,6 +50,45 @@ auto XojPreviewExtractor::getData(gsize& dataLen) -> unsigned char* {
     return this->data;
 }
 
+auto XojPreviewExtractor::makeGzipExtraField(const std::string& png) -> std::string {
+    if (png.empty() || png.size() > MAX_EXTRA_FIELD_LEN - SUBFIELD_HEADER_LEN) {
+        return {};
+    }
+    std::string extra{static_cast<char>(PREVIEW_SUBFIELD_ID[0]), static_cast<char>(PREVIEW_SUBFIELD_ID[1]),
+                      static_cast<char>(png.size() & 0xff), static_cast<char>((png.size() >> 8) & 0xff)};
+    return extra + png;
+}
+
+auto XojPreviewExtractor::readGzipExtraField(std::istream& in) -> bool {
+    // Skip the modification time, extra flags and OS
+    std::array<unsigned char, 8> header{};
+    in.read(reinterpret_cast<char*>(header.data()), header.size());
+    if (in.gcount() != static_cast<std::streamsize>(header.size())) {
+        return false;
+    }
+    size_t extraLen = readLE16(header.data() + 6);
+    std::vector<unsigned char> extra(extraLen);
+    in.read(reinterpret_cast<char*>(extra.data()), static_cast<std::streamsize>(extraLen));
+    if (in.gcount() != static_cast<std::streamsize>(extraLen)) {
+        return false;
+    }
+
+    for (size_t pos = 0; pos + SUBFIELD_HEADER_LEN <= extraLen;) {
+        size_t len = readLE16(extra.data() + pos + 2);
+        if (pos + SUBFIELD_HEADER_LEN + len > extraLen) {
+            return false;
+        }
+        if (extra[pos] == PREVIEW_SUBFIELD_ID[0] && extra[pos + 1] == PREVIEW_SUBFIELD_ID[1] && len > 0) {
+            this->data = static_cast<unsigned char*>(g_malloc(len));
+            memcpy(this->data, extra.data() + pos + SUBFIELD_HEADER_LEN, len);
+            this->dataLen = len;
+            return true;
+        }
+        pos += SUBFIELD_HEADER_LEN + len;
+    }
+    return false;
+}
+
 /**
  * Try to read the preview from byte buffer
  * @param buffer Buffer
@@ -104,11 +154,27 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
     if (!Util::hasXournalFileExt(file)) {
         return PREVIEW_RESULT_BAD_FILE_EXTENSION;
     }
+
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
+    }
+    std::array<unsigned char, 4> magic{};
+    in.read(reinterpret_cast<char*>(magic.data()), magic.size());
+    const bool gzipped =
+            in.gcount() == static_cast<std::streamsize>(magic.size()) && magic[0] == 0x1f && magic[1] == 0x8b;
+
+    // Fast path for files saved by Xournal++: the preview is in the first gzip header
+    if (gzipped && (magic[3] & GZIP_FLAG_EXTRA) && readGzipExtraField(in)) {
+        return PREVIEW_RESULT_IMAGE_READ;
+    }
+    in.close();
+
     // read the new file format
     int zipError = 0;
-    zip_t* zipFp = zip_open(file.u8string().c_str(), ZIP_RDONLY, &zipError);
+    zip_t* zipFp = gzipped ? nullptr : zip_open(file.u8string().c_str(), ZIP_RDONLY, &zipError);
 
-    if (!zipFp && zipError == ZIP_ER_NOZIP) {
+    if (gzipped || (!zipFp && zipError == ZIP_ER_NOZIP)) {
         gzFile fp = GzUtil::openPath(file, "r");
         if (!fp) {
             return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
@@ -11,9 +11,13 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <cstdint>  // for uint64_t
+#include <deque>    // for deque
+#include <fstream>  // for ofstream
+#include <future>   // for future
+#include <string>   // for string
 
-#include <zlib.h>  // for gzFile
+#include <zlib.h>  // for gzFile, uLong, Z_DEFAULT_COMPRESSION
 
 #include "filesystem.h"  // for path
 
@@ -32,7 +36,15 @@ public:
 
 class GzOutputStream: public OutputStream {
 public:
-    GzOutputStream(fs::path file);
+    /**
+     * @param level The compression level, from 0 (fastest) to 9 (smallest), or Z_DEFAULT_COMPRESSION
+     * @param threads With more than one thread, the data is cut into blocks which are compressed in parallel (like
+     *                pigz does). The result is still a single gzip stream, a few bytes larger.
+     * @param extra If not empty, the file starts with an empty gzip member with this extra field (RFC 1952), which can
+     *              be read without decompressing anything. Gzip readers skip it. At most 65535 bytes.
+     */
+    GzOutputStream(fs::path file, int level = Z_DEFAULT_COMPRESSION, unsigned int threads = 1,
+                   const std::string& extra = {});
     ~GzOutputStream() override;
 
 public:
@@ -42,6 +54,16 @@ public:
 
     std::string& getLastError();
 
+private:
+    struct CompressedBlock {
+        std::string data;
+        uLong crc;
+        size_t length;
+    };
+
+    void compressBlock(bool last);
+    void writeBlock(CompressedBlock block);
+
 private:
     gzFile fp = nullptr;
 
@@ -49,4 +71,17 @@ private:
 
     std::string target;
     fs::path file;
+
+    /**
+     * Block-parallel compression
+     */
+    int level;
+    unsigned int threads;
+    std::ofstream out;
+    bool opened = false;
+    std::string block;
+    std::string dictionary;
+    std::deque<std::future<CompressedBlock>> pending;
+    uLong crc = 0;
+    uint64_t size = 0;
 };
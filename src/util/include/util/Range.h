@@ -12,6 +12,7 @@
 #pragma once
 
 #include <limits>
+#include <vector>
 
 namespace xoj::util {
 template <typename Float>
@@ -43,6 +44,12 @@ public:
     [[nodiscard]] bool contains(double x, double y) const;
     [[nodiscard]] bool contains(const xoj::util::Rectangle<double>& r) const;
 
+    /**
+     * @brief Merge overlapping or touching ranges until no two of them overlap.
+     * @return Pairwise disjoint ranges covering all the given ones
+     */
+    [[nodiscard]] static std::vector<Range> coalesce(const std::vector<Range>& ranges);
+
     double minX = std::numeric_limits<double>::max();
     double minY = std::numeric_limits<double>::max();
     double maxX = std::numeric_limits<double>::lowest();
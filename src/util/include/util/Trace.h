@@ -0,0 +1,101 @@
+/*
+ * Xournal++
+ *
+ * Timing instrumentation, written as a Chrome trace (chrome://tracing, https://ui.perfetto.dev)
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>   // for atomic_bool, memory_order_relaxed
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t
+
+#include "filesystem.h"  // for path
+
+/**
+ * Usage:
+ *      void RenderJob::run() {
+ *          XOJ_TRACE_SCOPE("RenderJob::run", "render");
+ *          ...
+ *      }
+ *
+ * The time spent in the scope is recorded as one event, if tracing was started. Otherwise, the scope costs a single
+ * relaxed atomic load. Names and categories must be string literals (or otherwise outlive the tracing session).
+ */
+#define XOJ_TRACE_SCOPE(name, category) \
+    xoj::util::trace::Scope XOJ_TRACE_CONCAT(xojTraceScope, __LINE__) { name, category }
+#define XOJ_TRACE_CONCAT(a, b) XOJ_TRACE_CONCAT_IMPL(a, b)
+#define XOJ_TRACE_CONCAT_IMPL(a, b) a##b
+
+namespace xoj::util::trace {
+
+/**
+ * The name of the environment variable which starts tracing to the file it contains
+ */
+constexpr auto ENV_VARIABLE = "XOURNALPP_TRACE";
+
+/**
+ * Recorded events are appended to the file whenever this many are buffered. The memory used by a long session thus
+ * stays bounded, and the file of a crashed session still contains most of its events.
+ */
+constexpr size_t FLUSH_EVENTS = 1 << 14;
+
+extern std::atomic_bool enabled;
+
+inline auto isEnabled() -> bool { return enabled.load(std::memory_order_relaxed); }
+
+/**
+ * Start recording events as Chrome trace JSON to the file. Does nothing if the file cannot be created.
+ */
+void start(fs::path file);
+
+/**
+ * Stop recording, write the events not written yet and complete the file. Does nothing if tracing was not started.
+ * @return false if the file could not be written
+ */
+auto stop() -> bool;
+
+/**
+ * Name the calling thread in the trace. Can be called before tracing starts and for each run of a callback: only
+ * the first call of each thread has an effect.
+ */
+void setThreadName(const char* name);
+
+/**
+ * @return The time since the start of the process in µs, the time base of the trace
+ */
+auto now() -> int64_t;
+
+/**
+ * Record a complete event of the calling thread
+ */
+void record(const char* name, const char* category, int64_t start, int64_t duration);
+
+class Scope {
+public:
+    Scope(const char* name, const char* category): name(name), category(category) {
+        if (isEnabled()) {
+            this->start = now();
+        }
+    }
+    ~Scope() {
+        if (this->start >= 0 && isEnabled()) {
+            record(this->name, this->category, this->start, now() - this->start);
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    int64_t start = -1;
+};
+
+}  // namespace xoj::util::trace
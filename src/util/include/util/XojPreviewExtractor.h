@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <iosfwd>  // for istream
+#include <string>  // for string
+
 #include <glib.h>  // for gsize
 
 #include "filesystem.h"  // for path
@@ -70,6 +73,22 @@ public:
      */
     unsigned char* getData(gsize& dataLen);
 
+    /**
+     * Saved files start with an empty gzip member, whose extra field contains the preview PNG. It is found at a fixed
+     * offset, without decompressing the document.
+     * @param png The preview
+     * @return The extra field to pass to GzOutputStream, or an empty string if the preview does not fit into it
+     */
+    static std::string makeGzipExtraField(const std::string& png);
+
+private:
+    /**
+     * Try to read the preview from the extra field of a gzip header
+     * @param in The file, after the first 4 bytes of the header
+     * @return If an image was read
+     */
+    bool readGzipExtraField(std::istream& in);
+
     // Member
 private:
     /**
@@ -0,0 +1,34 @@
+/*
+ * Xournal++
+ *
+ * RAII wrappers for C library classes
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#include "CLibrariesSPtr.h"
+
+namespace xoj::util {
+
+inline namespace raii {
+namespace specialization {
+
+class GBytesHandler {
+public:
+    constexpr static auto ref = [](GBytes* b) { return g_bytes_ref(b); };
+    constexpr static auto unref = [](GBytes* b) { g_bytes_unref(b); };
+    constexpr static auto adopt = [](GBytes* b) { return b; };
+};
+};  // namespace specialization
+
+using GBytesSPtr = CLibrariesSPtr<GBytes, raii::specialization::GBytesHandler>;
+
+};  // namespace raii
+};  // namespace xoj::util
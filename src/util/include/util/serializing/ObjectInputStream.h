@@ -11,15 +11,15 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <cstdint>  // for uint32_t
-#include <sstream>  // for istringstream
-#include <string>   // for string
-#include <vector>   // for vector
-
-#include "util/safe_casts.h"  // for as_signed
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t
+#include <cstring>      // for memcpy
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
 
 #include "InputStreamException.h"
+#include "Serializable.h"  // for ObjectStreamFormat
 
 class ObjectInputStream {
 public:
@@ -27,6 +27,10 @@ public:
     virtual ~ObjectInputStream() = default;
 
 public:
+    /**
+     * Start reading the data, in the compact or in the tagged format. The data is not copied: it must stay valid
+     * while the stream is read.
+     */
     bool read(const char* data, size_t len);
 
     void readObject(const char* name);
@@ -54,35 +58,36 @@ private:
     template <class T>
     T readType();
 
+    /// Throws if less than n bytes are left
+    void checkAvailable(size_t n, const char* what) const;
+    size_t readSize();
+    std::string_view readChars();
+
 private:
-    std::istringstream istream;
-    size_t pos();
+    const char* data = nullptr;
     size_t len = 0;
+    size_t pos = 0;
+    ObjectStreamFormat format = ObjectStreamFormat::TAGGED;
 };
 
-extern template size_t ObjectInputStream::readType<size_t>();
-
 template <typename T>
 void ObjectInputStream::readData(std::vector<T>& data) {
     checkType('b');
 
-    if (istream.str().size() < 2 * sizeof(size_t)) {
-        throw InputStreamException("End reached, but try to read data len and width", __FILE__, __LINE__);
-    }
-
-    size_t len = readType<size_t>();
-    size_t width = readType<size_t>();
+    size_t len = readSize();
+    size_t width = readSize();
 
     if (width != sizeof(T)) {
         throw InputStreamException("Data width mismatch requested type width", __FILE__, __LINE__);
     }
 
-    if (istream.str().size() < len * width) {
+    if (len > (this->len - this->pos) / width) {
         throw InputStreamException("End reached, but try to read data", __FILE__, __LINE__);
     }
 
+    data.resize(len);
     if (len) {
-        data.resize(len);
-        istream.read((char*)data.data(), as_signed(len * width));
+        std::memcpy(static_cast<void*>(data.data()), this->data + this->pos, len * width);
+        this->pos += len * width;
     }
 }
@@ -13,17 +13,21 @@
 
 #include <cstddef>      // for size_t
 #include <cstdint>      // for uint32_t
-#include <string>       // for string
 #include <string_view>  // for string_view
 #include <vector>       // for vector
 
 #include <glib.h>  // for GString
 
+#include "Serializable.h"  // for ObjectStreamFormat
+
 class ObjectEncoding;
 
 class ObjectOutputStream {
 public:
-    ObjectOutputStream(ObjectEncoding* encoder);
+    /**
+     * The tagged format is only kept to produce data for older versions, which cannot read the compact one
+     */
+    ObjectOutputStream(ObjectEncoding* encoder, ObjectStreamFormat format = ObjectStreamFormat::COMPACT);
     virtual ~ObjectOutputStream();
 
 public:
@@ -34,8 +38,7 @@ public:
     void writeUInt(uint32_t u);
     void writeDouble(double d);
     void writeSizeT(size_t st);
-    void writeString(const char* str);
-    void writeString(const std::string& s);
+    void writeString(std::string_view s);
 
     void writeData(const void* data, size_t len, size_t width);
 
@@ -47,8 +50,14 @@ public:
 
     GString* getStr();
 
+private:
+    void writeTag(char type);
+    void writeSize(size_t size);
+    void writeChars(std::string_view s);
+
 private:
     ObjectEncoding* encoder = nullptr;
+    ObjectStreamFormat format;
 };
 
 template <typename T>
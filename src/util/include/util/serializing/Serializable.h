@@ -17,6 +17,17 @@ class ObjectInputStream;
 class ObjectOutputStream;
 
 const static char* const XML_VERSION_STR = "XojStrm1:";
+const static char* const COMPACT_VERSION_STR = "XojStrm2:";
+
+/**
+ * Layout of the data of ObjectOutputStream / ObjectInputStream
+ */
+enum class ObjectStreamFormat {
+    /// Each value is preceded by a two characters tag ("_d", "_s", ...), lengths are written as size_t
+    TAGGED,
+    /// Each value is preceded by a one byte tag, lengths are written as variable length integers
+    COMPACT
+};
 
 class Serializable {
 public:
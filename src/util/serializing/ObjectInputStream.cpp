@@ -1,41 +1,77 @@
 #include "util/serializing/ObjectInputStream.h"
 
-#include <cstdint>  // for uint32_t
+#include <cstdint>  // for uint32_t, uint8_t
+#include <cstring>  // for memcpy, memcmp, strlen
+#include <sstream>  // for ostringstream
 
 #include <glib.h>  // for g_free, g_strdup_...
 
 #include "util/PlaceholderString.h"                 // for PlaceholderString
 #include "util/i18n.h"                              // for FORMAT_STR, FS
-#include "util/safe_casts.h"                        // for as_signed
 #include "util/serializing/InputStreamException.h"  // for InputStreamException
-#include "util/serializing/Serializable.h"          // for XML_VERSION_STR
-
-template size_t ObjectInputStream::readType<size_t>();
+#include "util/serializing/Serializable.h"          // for XML_VERSION_STR, COMPACT_VERSION_STR
 
 // This function requires that T is read from its binary representation to work (e.g. integer type)
 template <typename T>
 T ObjectInputStream::readType() {
-    if (istream.str().size() < sizeof(T)) {
+    if (len - pos < sizeof(T)) {
         std::ostringstream oss;
-        oss << "End reached: trying to read " << sizeof(T) << " bytes while only " << istream.str().size()
-            << " bytes available";
+        oss << "End reached: trying to read " << sizeof(T) << " bytes while only " << len - pos << " bytes available";
         throw InputStreamException(oss.str(), __FILE__, __LINE__);
     }
     T output;
-
-    istream.read((char*)&output, as_signed(sizeof(T)));
+    std::memcpy(&output, data + pos, sizeof(T));
+    pos += sizeof(T);
 
     return output;
 }
 
-size_t ObjectInputStream::pos() { return static_cast<size_t>(istream.tellg()); }
+void ObjectInputStream::checkAvailable(size_t n, const char* what) const {
+    if (len - pos < n) {
+        throw InputStreamException(
+                FS(FORMAT_STR("End reached, but try to read {1}, index {2} of {3}") % what % pos % len), __FILE__,
+                __LINE__);
+    }
+}
+
+auto ObjectInputStream::readSize() -> size_t {
+    if (format == ObjectStreamFormat::TAGGED) {
+        return readType<size_t>();
+    }
+
+    size_t size = 0;
+    for (unsigned shift = 0; shift < sizeof(size_t) * 8; shift += 7) {
+        checkAvailable(1, "a size");
+        auto byte = static_cast<uint8_t>(data[pos++]);
+        size |= static_cast<size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return size;
+        }
+    }
+    throw InputStreamException("Invalid size", __FILE__, __LINE__);
+}
+
+auto ObjectInputStream::readChars() -> std::string_view {
+    size_t length = readSize();
+    checkAvailable(length, "a string");
+    std::string_view chars(data + pos, length);
+    pos += length;
+    return chars;
+}
 
 auto ObjectInputStream::read(const char* data, size_t data_len) -> bool {
-    istream.clear();
-    len = data_len;
-    std::string dataStr = std::string(data, len);
-    istream.str(dataStr);
+    this->data = data;
+    this->len = data_len;
+    this->pos = 0;
+
+    const size_t compactVersionLen = std::strlen(COMPACT_VERSION_STR);
+    if (len >= compactVersionLen && std::memcmp(data, COMPACT_VERSION_STR, compactVersionLen) == 0) {
+        this->format = ObjectStreamFormat::COMPACT;
+        this->pos = compactVersionLen;
+        return true;
+    }
 
+    this->format = ObjectStreamFormat::TAGGED;
     try {
         std::string version = readString();
         if (version != XML_VERSION_STR) {
@@ -60,16 +96,16 @@ void ObjectInputStream::readObject(const char* name) {
 
 auto ObjectInputStream::readObject() -> std::string {
     checkType('{');
+    if (format == ObjectStreamFormat::COMPACT) {
+        return std::string(readChars());
+    }
     return readString();
 }
 
 auto ObjectInputStream::getNextObjectName() -> std::string {
-    auto position = istream.tellg();
-
-    checkType('{');
-    std::string name = readString();
-
-    istream.seekg(position);
+    auto position = pos;
+    std::string name = readObject();
+    pos = position;
     return name;
 }
 
@@ -92,59 +128,38 @@ auto ObjectInputStream::readDouble() -> double {
 
 auto ObjectInputStream::readSizeT() -> size_t {
     checkType('l');
-    return readType<size_t>();
+    return readSize();
 }
 
 auto ObjectInputStream::readString() -> std::string {
     checkType('s');
-
-    size_t lenString = readType<size_t>();
-
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an string", __FILE__, __LINE__);
-    }
-
-    std::string output;
-    output.resize(lenString);
-
-    istream.read(&output[0], as_signed(lenString));
-
-    return output;
+    return std::string(readChars());
 }
 
 auto ObjectInputStream::readImage() -> std::string {
     checkType('m');
-
-    if (istream.str().size() < sizeof(size_t)) {
-        throw InputStreamException("End reached, but try to read an image's data's length", __FILE__, __LINE__);
-    }
-
-    const size_t len = readType<size_t>();
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an image", __FILE__, __LINE__);
-    }
-    std::string data;
-    data.resize(len);
-    istream.read(data.data(), as_signed(len));
-
-    return data;
+    return std::string(readChars());
 }
 
 void ObjectInputStream::checkType(char type) {
-    if (istream.str().size() < 2) {
+    const size_t tagLength = format == ObjectStreamFormat::COMPACT ? 1 : 2;
+    if (len - pos < tagLength) {
         throw InputStreamException(
-                FS(FORMAT_STR("End reached, but try to read {1}, index {2} of {3}") % getType(type) % pos() % len),
+                FS(FORMAT_STR("End reached, but try to read {1}, index {2} of {3}") % getType(type) % pos % len),
                 __FILE__, __LINE__);
     }
-    char t = 0, underscore = 0;
-    istream >> underscore >> t;
 
-    if (underscore != '_') {
-        throw InputStreamException(FS(FORMAT_STR("Expected type signature of {1}, index {2} of {3}, but read '{4}'") %
-                                      getType(type) % (pos() + 1) % len % underscore),
-                                   __FILE__, __LINE__);
+    if (format == ObjectStreamFormat::TAGGED) {
+        char underscore = data[pos++];
+        if (underscore != '_') {
+            throw InputStreamException(
+                    FS(FORMAT_STR("Expected type signature of {1}, index {2} of {3}, but read '{4}'") % getType(type) %
+                       pos % len % underscore),
+                    __FILE__, __LINE__);
+        }
     }
 
+    char t = data[pos++];
     if (t != type) {
         throw InputStreamException(FS(FORMAT_STR("Expected {1} but read {2}") % getType(type) % getType(t)), __FILE__,
                                    __LINE__);
@@ -1,16 +1,22 @@
 #include "util/serializing/ObjectOutputStream.h"
 
-#include <cairo.h>  // for CAIRO_STATUS_SUCCESS
+#include <cstdint>  // for uint8_t
+#include <cstring>  // for strlen
 
 #include "util/Assert.h"                      // for xoj_assert
 #include "util/serializing/ObjectEncoding.h"  // for ObjectEncoding
-#include "util/serializing/Serializable.h"    // for XML_VERSION_STR
+#include "util/serializing/Serializable.h"    // for XML_VERSION_STR, COMPACT_VERSION_STR
 
-ObjectOutputStream::ObjectOutputStream(ObjectEncoding* encoder) {
+ObjectOutputStream::ObjectOutputStream(ObjectEncoding* encoder, ObjectStreamFormat format): format(format) {
     xoj_assert(encoder != nullptr);
     this->encoder = encoder;
 
-    writeString(XML_VERSION_STR);
+    if (format == ObjectStreamFormat::COMPACT) {
+        // Written without tag: a tagged stream starts with "_s"
+        this->encoder->addData(COMPACT_VERSION_STR, std::strlen(COMPACT_VERSION_STR));
+    } else {
+        writeString(XML_VERSION_STR);
+    }
 }
 
 ObjectOutputStream::~ObjectOutputStream() {
@@ -18,59 +24,91 @@ ObjectOutputStream::~ObjectOutputStream() {
     this->encoder = nullptr;
 }
 
+void ObjectOutputStream::writeTag(char type) {
+    if (this->format == ObjectStreamFormat::COMPACT) {
+        this->encoder->addData(&type, 1);
+    } else {
+        const char tag[] = {'_', type, '\0'};
+        this->encoder->addStr(tag);
+    }
+}
+
+void ObjectOutputStream::writeSize(size_t size) {
+    if (this->format == ObjectStreamFormat::TAGGED) {
+        this->encoder->addData(&size, sizeof(size_t));
+        return;
+    }
+
+    // LEB128: 7 bits per byte, the high bit is set on every byte but the last one
+    uint8_t buffer[(sizeof(size_t) * 8 + 6) / 7];
+    size_t n = 0;
+    do {
+        buffer[n] = static_cast<uint8_t>(size & 0x7F);
+        size >>= 7;
+        if (size != 0) {
+            buffer[n] |= 0x80;
+        }
+        n++;
+    } while (size != 0);
+    this->encoder->addData(buffer, n);
+}
+
+void ObjectOutputStream::writeChars(std::string_view s) {
+    writeSize(s.length());
+    this->encoder->addData(s.data(), s.length());
+}
+
 void ObjectOutputStream::writeObject(const char* name) {
-    this->encoder->addStr("_{");
+    writeTag('{');
 
-    writeString(name);
+    if (this->format == ObjectStreamFormat::COMPACT) {
+        writeChars(name);
+    } else {
+        writeString(name);
+    }
 }
 
-void ObjectOutputStream::endObject() { this->encoder->addStr("_}"); }
+void ObjectOutputStream::endObject() { writeTag('}'); }
 
 void ObjectOutputStream::writeInt(int i) {
-    this->encoder->addStr("_i");
+    writeTag('i');
     this->encoder->addData(&i, sizeof(int));
 }
 
 void ObjectOutputStream::writeUInt(uint32_t u) {
-    this->encoder->addStr("_u");
+    writeTag('u');
     this->encoder->addData(&u, sizeof(uint32_t));
 }
 
 void ObjectOutputStream::writeDouble(double d) {
-    this->encoder->addStr("_d");
+    writeTag('d');
     this->encoder->addData(&d, sizeof(double));
 }
 
 void ObjectOutputStream::writeSizeT(size_t st) {
-    this->encoder->addStr("_l");
-    this->encoder->addData(&st, sizeof(size_t));
+    writeTag('l');
+    writeSize(st);
 }
 
-void ObjectOutputStream::writeString(const char* str) { writeString(std::string(str)); }
-
-void ObjectOutputStream::writeString(const std::string& s) {
-    this->encoder->addStr("_s");
-    size_t len = s.length();
-    this->encoder->addData(&len, sizeof(size_t));
-    this->encoder->addData(s.c_str(), len);
+void ObjectOutputStream::writeString(std::string_view s) {
+    writeTag('s');
+    writeChars(s);
 }
 
 void ObjectOutputStream::writeData(const void* data, size_t len, size_t width) {
-    this->encoder->addStr("_b");
-    this->encoder->addData(&len, sizeof(size_t));
+    writeTag('b');
+    writeSize(len);
 
     // size of one element
-    this->encoder->addData(&width, sizeof(size_t));
+    writeSize(width);
     if (data != nullptr) {
         this->encoder->addData(data, len * width);
     }
 }
 
 void ObjectOutputStream::writeImage(const std::string_view& imgData) {
-    this->encoder->addStr("_m");
-    size_t len = imgData.length();
-    this->encoder->addData(&len, sizeof(size_t));
-    this->encoder->addData(imgData.data(), len);
+    writeTag('m');
+    writeChars(imgData);
 }
 
 auto ObjectOutputStream::getStr() -> GString* { return this->encoder->getData(); }
@@ -0,0 +1,77 @@
+#include "AllocationCounter.h"
+
+#include <atomic>   // for atomic, memory_order_relaxed
+#include <cstddef>  // for max_align_t
+#include <cstdlib>  // for malloc, free
+#include <new>      // for bad_alloc, nothrow_t
+
+namespace {
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> currentBytes{0};
+std::atomic<size_t> peakBytes{0};
+
+/**
+ * The size of each allocation is stored in front of it, keeping the alignment of malloc
+ */
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+auto allocate(size_t size) noexcept -> void* {
+    auto* base = static_cast<char*>(std::malloc(size + HEADER_SIZE));
+    if (!base) {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t*>(base) = size;
+
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t current = currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+
+    return base + HEADER_SIZE;
+}
+
+void deallocate(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    char* base = static_cast<char*>(ptr) - HEADER_SIZE;
+    currentBytes.fetch_sub(*reinterpret_cast<size_t*>(base), std::memory_order_relaxed);
+    std::free(base);
+}
+};  // namespace
+
+auto operator new(size_t size) -> void* {
+    if (void* ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+auto operator new[](size_t size) -> void* { return operator new(size); }
+auto operator new(size_t size, const std::nothrow_t&) noexcept -> void* { return allocate(size); }
+auto operator new[](size_t size, const std::nothrow_t&) noexcept -> void* { return allocate(size); }
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+
+namespace bench {
+
+AllocationCounter::AllocationCounter():
+        startAllocations(allocations.load(std::memory_order_relaxed)),
+        startBytes(currentBytes.load(std::memory_order_relaxed)) {
+    peakBytes.store(startBytes, std::memory_order_relaxed);
+}
+
+void AllocationCounter::report(benchmark::State& state) const {
+    auto count = static_cast<double>(allocations.load(std::memory_order_relaxed) - startAllocations);
+    state.counters["allocs"] = benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+    state.counters["peak_bytes"] = benchmark::Counter(
+            static_cast<double>(peakBytes.load(std::memory_order_relaxed) - startBytes), benchmark::Counter::kDefaults,
+            benchmark::Counter::kIs1024);
+}
+
+}  // namespace bench
@@ -0,0 +1,45 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * Counts the heap allocations of a benchmark
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+
+#include <benchmark/benchmark.h>
+
+namespace bench {
+
+/**
+ * @brief Counts the allocations done through operator new while it exists.
+ *
+ * Linking AllocationCounter.cpp into a benchmark program replaces the global operator new and delete. Allocations of
+ * the C libraries (g_malloc, cairo, poppler, ...) are not seen.
+ */
+class AllocationCounter {
+public:
+    /// Start counting, the peak is reset to the current heap usage
+    AllocationCounter();
+
+    /**
+     * @brief Add the counters to the benchmark results:
+     *   "allocs": allocations per iteration
+     *   "peak_bytes": maximal heap usage above the usage at construction
+     */
+    void report(benchmark::State& state) const;
+
+private:
+    size_t startAllocations;
+    size_t startBytes;
+};
+
+}  // namespace bench
@@ -0,0 +1,167 @@
+#include "Workloads.h"
+
+#include <cmath>        // for sin, cos, M_PI
+#include <cstdint>      // for uint32_t
+#include <random>       // for mt19937, uniform_real_distribution
+#include <string_view>  // for string_view
+#include <utility>      // for move
+#include <vector>       // for vector
+
+#include <cairo.h>  // for cairo_image_surface_create, cairo_surface_write_to_png_stream
+
+#include "model/Font.h"     // for XojFont
+#include "model/Image.h"    // for Image
+#include "model/Layer.h"    // for Layer
+#include "model/Point.h"    // for Point
+#include "model/Stroke.h"   // for Stroke, StrokeTool
+#include "model/Text.h"     // for Text
+#include "model/XojPage.h"  // for XojPage
+#include "util/Color.h"     // for Color
+
+namespace bench {
+
+namespace {
+constexpr double PAGE_WIDTH = 595.275591;
+constexpr double PAGE_HEIGHT = 841.889764;
+constexpr double MARGIN = 20;
+
+constexpr unsigned int SEED = 4242;
+
+void addStrokes(Layer* layer, const WorkloadSpec& spec, std::mt19937& gen) {
+    std::uniform_real_distribution<double> posX(MARGIN, PAGE_WIDTH - MARGIN);
+    std::uniform_real_distribution<double> posY(MARGIN, PAGE_HEIGHT - MARGIN);
+    std::uniform_real_distribution<double> angle(-0.6, 0.6);
+    std::uniform_real_distribution<double> pressure(0.3, 1.0);
+
+    // Handwriting moves by about a pixel per point, highlighting sweeps over the page
+    const double step = spec.highlighter ? (PAGE_WIDTH - 2 * MARGIN) / static_cast<double>(spec.pointsPerStroke) : 0.8;
+
+    for (size_t s = 0; s < spec.strokesPerPage; s++) {
+        auto* stroke = new Stroke();
+        if (spec.highlighter) {
+            stroke->setToolType(StrokeTool::HIGHLIGHTER);
+            stroke->setWidth(8.5);
+            stroke->setColor(Color(0x7fffff00U));
+        } else {
+            stroke->setWidth(1.41);
+            stroke->setColor(Color(0xff000000U | static_cast<uint32_t>(gen() & 0x7f7f7fU)));
+        }
+
+        std::vector<Point> points;
+        points.reserve(spec.pointsPerStroke);
+        double x = spec.highlighter ? MARGIN : posX(gen);
+        double y = posY(gen);
+        double dir = angle(gen);
+        for (size_t p = 0; p < spec.pointsPerStroke; p++) {
+            dir += angle(gen) * 0.5;
+            x += step * std::cos(dir);
+            y += step * std::sin(dir) * (spec.highlighter ? 0.1 : 1.0);
+            points.emplace_back(x, y, spec.highlighter ? Point::NO_PRESSURE : pressure(gen));
+        }
+        stroke->setPointVector(std::move(points));
+        layer->addElement(stroke);
+    }
+}
+
+void addImages(Layer* layer, const WorkloadSpec& spec, const std::string& png, std::mt19937& gen) {
+    std::uniform_real_distribution<double> posX(MARGIN, PAGE_WIDTH / 2);
+    std::uniform_real_distribution<double> posY(MARGIN, PAGE_HEIGHT / 2);
+
+    for (size_t i = 0; i < spec.imagesPerPage; i++) {
+        auto* image = new Image();
+        image->setImage(std::string_view(png));
+        image->setX(posX(gen));
+        image->setY(posY(gen));
+        image->setWidth(PAGE_WIDTH / 2 - MARGIN);
+        image->setHeight(PAGE_WIDTH / 2 - MARGIN);
+        layer->addElement(image);
+    }
+}
+
+void addTexts(Layer* layer, const WorkloadSpec& spec) {
+    constexpr double LINE_HEIGHT = 16;
+    for (size_t i = 0; i < spec.textsPerPage; i++) {
+        auto* text = new Text();
+        text->setFont(XojFont("Sans", 12));
+        text->setText("The quick brown fox jumps over the lazy dog " + std::to_string(i));
+        text->setX(MARGIN);
+        text->setY(MARGIN + LINE_HEIGHT * static_cast<double>(i % 48));
+        layer->addElement(text);
+    }
+}
+};  // namespace
+
+auto handwriting(size_t pages) -> WorkloadSpec {
+    WorkloadSpec spec;
+    spec.pages = pages;
+    spec.strokesPerPage = 1500;
+    spec.pointsPerStroke = 40;
+    return spec;
+}
+
+auto highlighter(size_t pages) -> WorkloadSpec {
+    WorkloadSpec spec;
+    spec.pages = pages;
+    spec.strokesPerPage = 60;
+    spec.pointsPerStroke = 300;
+    spec.highlighter = true;
+    return spec;
+}
+
+auto images(size_t pages) -> WorkloadSpec {
+    WorkloadSpec spec;
+    spec.pages = pages;
+    spec.imagesPerPage = 4;
+    spec.imageSize = 1024;
+    return spec;
+}
+
+auto texts(size_t pages) -> WorkloadSpec {
+    WorkloadSpec spec;
+    spec.pages = pages;
+    spec.textsPerPage = 48;
+    return spec;
+}
+
+Workload::Workload(): doc(&handler) {}
+
+auto generate(const WorkloadSpec& spec) -> std::unique_ptr<Workload> {
+    auto workload = std::make_unique<Workload>();
+    std::mt19937 gen(SEED);
+    std::string png = spec.imagesPerPage > 0 ? generatePng(spec.imageSize, spec.imageSize) : std::string();
+
+    for (size_t i = 0; i < spec.pages; i++) {
+        auto page = std::make_shared<XojPage>(PAGE_WIDTH, PAGE_HEIGHT);
+        Layer* layer = page->getSelectedLayer();
+        addStrokes(layer, spec, gen);
+        addImages(layer, spec, png, gen);
+        addTexts(layer, spec);
+        workload->doc.addPage(page);
+    }
+
+    return workload;
+}
+
+auto generatePng(int width, int height) -> std::string {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    for (int i = 0; i < 16; i++) {
+        cairo_set_source_rgb(cr, (i % 4) / 3.0, (i / 4) / 3.0, 0.5);
+        cairo_arc(cr, width * (i % 4 + 0.5) / 4, height * (i / 4 + 0.5) / 4, width / 9.0, 0, 2 * M_PI);
+        cairo_fill(cr);
+    }
+    cairo_destroy(cr);
+
+    std::string data;
+    cairo_surface_write_to_png_stream(
+            surface,
+            [](void* closure, const unsigned char* buf, unsigned int length) {
+                static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(buf), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &data);
+    cairo_surface_destroy(surface);
+    return data;
+}
+
+}  // namespace bench
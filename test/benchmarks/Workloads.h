@@ -0,0 +1,74 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * Reproducible documents to run the benchmarks on
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+
+#include "model/Document.h"         // for Document
+#include "model/DocumentHandler.h"  // for DocumentHandler
+
+namespace bench {
+
+/**
+ * Content of a synthetic document. The content is generated from a fixed seed, so that every run of a benchmark
+ * works on the very same document.
+ */
+struct WorkloadSpec {
+    size_t pages = 1;
+    size_t strokesPerPage = 0;
+    size_t pointsPerStroke = 0;
+    /// Use the highlighter instead of the pen, with wide translucent strokes
+    bool highlighter = false;
+    size_t imagesPerPage = 0;
+    /// Size in pixels of the (square) images
+    int imageSize = 256;
+    size_t textsPerPage = 0;
+};
+
+/// Dense handwriting: many short pressure sensitive pen strokes
+WorkloadSpec handwriting(size_t pages = 1);
+
+/// Long highlighter strokes over the whole page
+WorkloadSpec highlighter(size_t pages = 1);
+
+/// A few large images per page
+WorkloadSpec images(size_t pages = 1);
+
+/// Lines of typed text
+WorkloadSpec texts(size_t pages = 1);
+
+/**
+ * A document which owns its DocumentHandler
+ */
+class Workload {
+public:
+    Workload();
+
+    DocumentHandler handler;
+    Document doc;
+};
+
+/**
+ * @brief Generate a document, all pages are A4 with the default (lined) background and a single layer
+ */
+std::unique_ptr<Workload> generate(const WorkloadSpec& spec);
+
+/**
+ * @return The data of a PNG image with a deterministic pattern
+ */
+std::string generatePng(int width, int height);
+
+}  // namespace bench
@@ -0,0 +1,330 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * Throughput, allocations and peak memory of loading and saving documents
+ *
+ * Usage: bench-io [benchmark options] [--pages=N] [--strokes=N] [--points=N] [--images=N] [--texts=N] [file.xopp...]
+ * The size options set the content of the generated document (per page), the given files are benchmarked along
+ * with it. Use --benchmark_format=json or --benchmark_out=<file> for machine readable results.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>  // for uintmax_t, int64_t
+#include <cstdio>   // for fprintf
+#include <cstdlib>  // for strtoul
+#include <cstring>  // for strncmp, strlen
+#include <memory>   // for unique_ptr, make_unique
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include <benchmark/benchmark.h>
+#include <cairo.h>  // for cairo_image_surface_create
+#include <glib.h>   // for g_string_free
+#include <zlib.h>   // for gzread, gzwrite, gzclose
+
+#include "control/xojfile/AutosaveJournal.h"      // for AutosaveJournal
+#include "control/xojfile/LoadHandler.h"          // for LoadHandler
+#include "control/xojfile/SaveHandler.h"          // for SaveHandler
+#include "model/Document.h"                       // for Document
+#include "model/Element.h"                        // for Element
+#include "model/Image.h"                          // for Image
+#include "model/Layer.h"                          // for Layer
+#include "model/Stroke.h"                         // for Stroke
+#include "model/TexImage.h"                       // for TexImage
+#include "model/Text.h"                           // for Text
+#include "model/XojPage.h"                        // for XojPage
+#include "util/GzUtil.h"                          // for GzUtil
+#include "util/PathUtil.h"                        // for getTmpDirSubfolder
+#include "util/XojPreviewExtractor.h"             // for XojPreviewExtractor
+#include "util/serializing/BinObjectEncoding.h"   // for BinObjectEncoding
+#include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
+#include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
+
+#include "AllocationCounter.h"  // for AllocationCounter
+#include "Workloads.h"          // for WorkloadSpec, generate
+#include "filesystem.h"         // for path, file_size
+
+namespace {
+/// Size of the preview embedded in saved files, see SaveJob::updatePreview
+constexpr int PREVIEW_SIZE = 128;
+
+struct Source {
+    std::string name;
+    std::unique_ptr<bench::Workload> generated;
+    std::unique_ptr<LoadHandler> loader;
+    Document* doc = nullptr;
+
+    /// The document saved by SaveHandler, read by the open and preview benchmarks
+    fs::path savedFile;
+    /// The same, recompressed as a single gzip member, like files written before the preview was in the gzip header
+    fs::path legacyFile;
+};
+
+std::vector<std::unique_ptr<Source>> sources;
+
+auto tmpFile(const Source* src, const std::string& suffix) -> fs::path {
+    return Util::getTmpDirSubfolder("bench-io") / (src->name + suffix);
+}
+
+void save(Document* doc, const fs::path& file) {
+    SaveHandler handler;
+    handler.prepareSave(doc);
+    handler.saveTo(file);
+    if (auto error = handler.getErrorMessage(); !error.empty()) {
+        fprintf(stderr, "Could not save %s: %s\n", file.u8string().c_str(), error.c_str());
+    }
+}
+
+/**
+ * Decompress and compress again: the empty gzip member with the preview at the start of the file is dropped
+ */
+void recompress(const fs::path& from, const fs::path& to) {
+    gzFile in = GzUtil::openPath(from, "r");
+    gzFile out = GzUtil::openPath(to, "w");
+    std::vector<char> buffer(1 << 16);
+    int len = 0;
+    while ((len = gzread(in, buffer.data(), static_cast<unsigned int>(buffer.size()))) > 0) {
+        gzwrite(out, buffer.data(), static_cast<unsigned int>(len));
+    }
+    gzclose(in);
+    gzclose(out);
+}
+
+void addSource(std::unique_ptr<Source> src) {
+    cairo_surface_t* preview = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, PREVIEW_SIZE, PREVIEW_SIZE);
+    src->doc->setPreview(preview);
+    cairo_surface_destroy(preview);
+
+    src->savedFile = tmpFile(src.get(), ".xopp");
+    save(src->doc, src->savedFile);
+    src->legacyFile = tmpFile(src.get(), "-legacy.xopp");
+    recompress(src->savedFile, src->legacyFile);
+    sources.push_back(std::move(src));
+}
+
+void addGenerated(const bench::WorkloadSpec& spec) {
+    auto src = std::make_unique<Source>();
+    src->name = "generated";
+    src->generated = bench::generate(spec);
+    src->doc = &src->generated->doc;
+    addSource(std::move(src));
+}
+
+void addFile(const fs::path& file) {
+    auto src = std::make_unique<Source>();
+    src->name = file.stem().u8string();
+    src->loader = std::make_unique<LoadHandler>();
+    src->doc = src->loader->loadDocument(file);
+    if (!src->doc) {
+        fprintf(stderr, "Could not load %s, skipping it: %s\n", file.u8string().c_str(),
+                src->loader->getLastError().c_str());
+        return;
+    }
+    addSource(std::move(src));
+}
+
+void setBytes(benchmark::State& state, uintmax_t bytes) {
+    state.SetBytesProcessed(static_cast<int64_t>(bytes) * static_cast<int64_t>(state.iterations()));
+}
+
+void openDocument(benchmark::State& state, Source* src) {
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        LoadHandler handler;
+        benchmark::DoNotOptimize(handler.loadDocument(src->savedFile));
+    }
+    counter.report(state);
+    setBytes(state, fs::file_size(src->savedFile));
+}
+
+void saveDocument(benchmark::State& state, Source* src) {
+    auto file = tmpFile(src, "-save.xopp");
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        save(src->doc, file);
+    }
+    counter.report(state);
+    setBytes(state, fs::file_size(file));
+}
+
+void autosaveFull(benchmark::State& state, Source* src) {
+    auto file = tmpFile(src, "-autosave.xopp");
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        // A new journal always starts with a full snapshot
+        AutosaveJournal journal;
+        journal.prepare(src->doc, file);
+        journal.write();
+    }
+    counter.report(state);
+    setBytes(state, fs::file_size(file));
+}
+
+void autosaveIncremental(benchmark::State& state, Source* src) {
+    auto file = tmpFile(src, "-autosave-incremental.xopp");
+    AutosaveJournal journal;
+    journal.prepare(src->doc, file);
+    journal.write();
+
+    PageRef page = src->doc->getPage(0);
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        // One page edited between two autosaves
+        journal.undoRedoPageChanged(page);
+        journal.prepare(src->doc, file);
+        journal.write();
+    }
+    counter.report(state);
+}
+
+/**
+ * Serializes the elements of the first page, the same way as copying them to the clipboard does
+ */
+auto serializePage(Source* src) -> std::string {
+    ObjectOutputStream out(new BinObjectEncoding());
+    Layer* layer = src->doc->getPage(0)->getSelectedLayer();
+    out.writeInt(static_cast<int>(layer->getElements().size()));
+    for (Element* e: layer->getElements()) {
+        e->serialize(out);
+    }
+    GString* str = out.getStr();
+    std::string data(str->str, str->len);
+    g_string_free(str, true);
+    return data;
+}
+
+void clipboardSerialize(benchmark::State& state, Source* src) {
+    bench::AllocationCounter counter;
+    size_t bytes = 0;
+    for (auto _: state) {
+        bytes = serializePage(src).size();
+    }
+    counter.report(state);
+    setBytes(state, bytes);
+}
+
+void clipboardDeserialize(benchmark::State& state, Source* src) {
+    std::string data = serializePage(src);
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        // Same as Control::clipboardPasteXournal
+        ObjectInputStream in;
+        in.read(data.data(), data.size());
+        std::vector<std::unique_ptr<Element>> elements;
+        int count = in.readInt();
+        for (int i = 0; i < count; i++) {
+            std::string name = in.getNextObjectName();
+            std::unique_ptr<Element> element;
+            if (name == "Stroke") {
+                element = std::make_unique<Stroke>();
+            } else if (name == "Image") {
+                element = std::make_unique<Image>();
+            } else if (name == "TexImage") {
+                element = std::make_unique<TexImage>();
+            } else if (name == "Text") {
+                element = std::make_unique<Text>();
+            } else {
+                state.SkipWithError("Unknown object in serialized data");
+                return;
+            }
+            element->readSerialized(in);
+            elements.push_back(std::move(element));
+        }
+        benchmark::DoNotOptimize(elements.data());
+    }
+    counter.report(state);
+    setBytes(state, data.size());
+}
+
+/**
+ * What xournalpp-thumbnailer does for each file. The items per second are the files a file manager gets thumbnails for.
+ */
+void extractPreview(benchmark::State& state, const fs::path& file) {
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        XojPreviewExtractor extractor;
+        if (extractor.readFile(file) != PREVIEW_RESULT_IMAGE_READ) {
+            state.SkipWithError("Could not extract the preview");
+            return;
+        }
+    }
+    counter.report(state);
+    setBytes(state, fs::file_size(file));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void previewExtraction(benchmark::State& state, Source* src) { extractPreview(state, src->savedFile); }
+
+void previewExtractionLegacy(benchmark::State& state, Source* src) { extractPreview(state, src->legacyFile); }
+
+/**
+ * Parse an option of the form --name=N
+ */
+auto parseSizeOption(const char* arg, const char* name, size_t& value) -> bool {
+    size_t len = strlen(name);
+    if (strncmp(arg, name, len) != 0 || arg[len] != '=') {
+        return false;
+    }
+    value = strtoul(arg + len + 1, nullptr, 10);
+    return true;
+}
+};  // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    bench::WorkloadSpec spec;
+    spec.pages = 20;
+    spec.strokesPerPage = 500;
+    spec.pointsPerStroke = 50;
+    spec.imagesPerPage = 1;
+    spec.textsPerPage = 20;
+
+    std::vector<fs::path> files;
+    for (int i = 1; i < argc; i++) {
+        if (!parseSizeOption(argv[i], "--pages", spec.pages) &&
+            !parseSizeOption(argv[i], "--strokes", spec.strokesPerPage) &&
+            !parseSizeOption(argv[i], "--points", spec.pointsPerStroke) &&
+            !parseSizeOption(argv[i], "--images", spec.imagesPerPage) &&
+            !parseSizeOption(argv[i], "--texts", spec.textsPerPage)) {
+            files.emplace_back(argv[i]);
+        }
+    }
+    if (spec.pages == 0) {
+        fprintf(stderr, "The document needs at least one page\n");
+        return 1;
+    }
+
+    addGenerated(spec);
+    for (auto& file: files) {
+        addFile(file);
+    }
+
+    for (auto& src: sources) {
+        Source* s = src.get();
+        auto add = [s](const char* name, void (*fn)(benchmark::State&, Source*)) {
+            benchmark::RegisterBenchmark((std::string(name) + "/" + s->name).c_str(), fn, s)
+                    ->Unit(benchmark::kMillisecond);
+        };
+        add("Open", openDocument);
+        add("Save", saveDocument);
+        add("AutosaveFull", autosaveFull);
+        add("AutosaveIncremental", autosaveIncremental);
+        add("ClipboardSerialize", clipboardSerialize);
+        add("ClipboardDeserialize", clipboardDeserialize);
+        add("PreviewExtraction", previewExtraction);
+        add("PreviewExtractionLegacy", previewExtractionLegacy);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    sources.clear();
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * Cost of dispatching the drawing of an element to the view of its type, without the drawing itself. Compares a view
+ * allocated per element with a virtual draw() (as ElementView::createFromElement did) with a view on the stack,
+ * selected by the element type (as ElementView::drawElement does).
+ *
+ * The views only read a coordinate of their element, the cairo work of the real views is the same in both cases and
+ * is measured by the FullPage benchmarks.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>  // for unique_ptr, make_unique
+#include <random>  // for mt19937
+#include <vector>  // for vector
+
+#include <benchmark/benchmark.h>
+
+#include "model/Element.h"   // for Element, ELEMENT_STROKE, ...
+#include "model/Image.h"     // for Image
+#include "model/Stroke.h"    // for Stroke
+#include "model/TexImage.h"  // for TexImage
+#include "model/Text.h"      // for Text
+
+#include "AllocationCounter.h"  // for AllocationCounter
+
+namespace {
+/// Number of elements on the page, about a page of dense handwriting
+constexpr int ELEMENT_COUNT = 50000;
+
+struct Context {
+    double* sink;
+};
+
+class View {
+public:
+    virtual ~View() = default;
+    virtual void draw(const Context& ctx) const = 0;
+};
+
+template <class E>
+class TypedView: public View {
+public:
+    explicit TypedView(const E* e): e(e) {}
+
+    // Not inlined, as the draw() of the real views is not
+    [[gnu::noinline]] void draw(const Context& ctx) const override { *ctx.sink += e->getX(); }
+
+private:
+    const E* e;
+};
+
+auto createFromElement(const Element* e) -> std::unique_ptr<View> {
+    switch (e->getType()) {
+        case ELEMENT_STROKE:
+            return std::make_unique<TypedView<Stroke>>(dynamic_cast<const Stroke*>(e));
+        case ELEMENT_TEXT:
+            return std::make_unique<TypedView<Text>>(dynamic_cast<const Text*>(e));
+        case ELEMENT_IMAGE:
+            return std::make_unique<TypedView<Image>>(dynamic_cast<const Image*>(e));
+        case ELEMENT_TEXIMAGE:
+            return std::make_unique<TypedView<TexImage>>(dynamic_cast<const TexImage*>(e));
+        default:
+            return nullptr;
+    }
+}
+
+[[gnu::noinline]] void drawElement(const Element* e, const Context& ctx) {
+    switch (e->getType()) {
+        case ELEMENT_STROKE:
+            TypedView<Stroke>(static_cast<const Stroke*>(e)).draw(ctx);
+            break;
+        case ELEMENT_TEXT:
+            TypedView<Text>(static_cast<const Text*>(e)).draw(ctx);
+            break;
+        case ELEMENT_IMAGE:
+            TypedView<Image>(static_cast<const Image*>(e)).draw(ctx);
+            break;
+        case ELEMENT_TEXIMAGE:
+            TypedView<TexImage>(static_cast<const TexImage*>(e)).draw(ctx);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 94% strokes, 4% texts, 1% images and 1% TeX images, in a fixed random order
+ */
+auto makeElements() -> std::vector<std::unique_ptr<Element>> {
+    std::vector<std::unique_ptr<Element>> elements;
+    elements.reserve(ELEMENT_COUNT);
+    std::mt19937 rng(1);
+    for (int i = 0; i < ELEMENT_COUNT; i++) {
+        auto r = rng() % 100;
+        if (r < 94) {
+            elements.push_back(std::make_unique<Stroke>());
+        } else if (r < 98) {
+            elements.push_back(std::make_unique<Text>());
+        } else if (r < 99) {
+            elements.push_back(std::make_unique<Image>());
+        } else {
+            elements.push_back(std::make_unique<TexImage>());
+        }
+    }
+    return elements;
+}
+
+void allocatedView(benchmark::State& state) {
+    auto elements = makeElements();
+    double sink = 0;
+    Context ctx{&sink};
+
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        for (auto& e: elements) {
+            createFromElement(e.get())->draw(ctx);
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    counter.report(state);
+    state.SetItemsProcessed(state.iterations() * ELEMENT_COUNT);
+}
+
+void stackView(benchmark::State& state) {
+    auto elements = makeElements();
+    double sink = 0;
+    Context ctx{&sink};
+
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        for (auto& e: elements) {
+            drawElement(e.get(), ctx);
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    counter.report(state);
+    state.SetItemsProcessed(state.iterations() * ELEMENT_COUNT);
+}
+};  // namespace
+
+BENCHMARK(allocatedView)->Name("ElementDispatch/AllocatedView")->Unit(benchmark::kMicrosecond);
+BENCHMARK(stackView)->Name("ElementDispatch/StackView")->Unit(benchmark::kMicrosecond);
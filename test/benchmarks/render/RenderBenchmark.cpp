@@ -0,0 +1,178 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * Rendering throughput: full pages, dirty rectangles and thumbnails, at several zoom levels, with the number of
+ * allocations per render
+ *
+ * Usage: bench-render [benchmark options] [file.xopp...]
+ * The given files are benchmarked along with the synthetic workloads. Use --benchmark_format=json or
+ * --benchmark_out=<file> for machine readable results.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>  // for int64_t
+#include <cstdio>   // for fprintf
+#include <memory>   // for unique_ptr, make_unique
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include <benchmark/benchmark.h>
+#include <config-test.h>
+
+#include "control/PdfCache.h"             // for PdfCache
+#include "control/xojfile/LoadHandler.h"  // for LoadHandler
+#include "model/Document.h"               // for Document
+#include "model/XojPage.h"                // for XojPage
+#include "util/Range.h"                   // for Range
+#include "view/DocumentView.h"            // for DocumentView
+#include "view/Mask.h"                    // for Mask
+
+#include "AllocationCounter.h"  // for AllocationCounter
+#include "Workloads.h"          // for generate, handwriting, highlighter...
+#include "filesystem.h"         // for path
+
+namespace {
+/// Zoom levels in percent
+const std::vector<int64_t> ZOOMS = {50, 100, 200, 400};
+
+/// Width of the sidebar previews, in pixels
+constexpr double THUMBNAIL_WIDTH = 150;
+
+/// Size of the area rerendered by the dirty rectangle benchmark, about a word of handwriting
+constexpr double DIRTY_RECT_SIZE = 60;
+
+/// Same as in RenderJob::rerenderRange
+constexpr double RENDER_PADDING = 1;
+
+struct Source {
+    std::string name;
+    std::unique_ptr<bench::Workload> generated;
+    std::unique_ptr<LoadHandler> loader;
+    Document* doc = nullptr;
+    std::unique_ptr<PdfCache> pdfCache;
+};
+
+std::vector<std::unique_ptr<Source>> sources;
+
+void addGenerated(std::string name, const bench::WorkloadSpec& spec) {
+    auto src = std::make_unique<Source>();
+    src->name = std::move(name);
+    src->generated = bench::generate(spec);
+    src->doc = &src->generated->doc;
+    sources.push_back(std::move(src));
+}
+
+void addFile(const fs::path& file, std::string name = {}) {
+    auto src = std::make_unique<Source>();
+    src->name = name.empty() ? file.filename().u8string() : std::move(name);
+    src->loader = std::make_unique<LoadHandler>();
+    src->doc = src->loader->loadDocument(file);
+    if (!src->doc || src->doc->getPageCount() == 0) {
+        fprintf(stderr, "Could not load %s, skipping it: %s\n", file.u8string().c_str(),
+                src->loader->getLastError().c_str());
+        return;
+    }
+    if (src->doc->getPdfDocument().isLoaded()) {
+        src->pdfCache = std::make_unique<PdfCache>(src->doc->getPdfDocument(), nullptr);
+    }
+    sources.push_back(std::move(src));
+}
+
+/**
+ * Renders the area of the page into a buffer the way RenderJob does
+ */
+void render(Source* src, const PageRef& page, const Range& area, double zoom) {
+    xoj::view::Mask mask(1, area, zoom, CAIRO_CONTENT_COLOR_ALPHA);
+    DocumentView view;
+    view.setPdfCache(src->pdfCache.get());
+    view.drawPage(page, mask.get(), false);
+    benchmark::DoNotOptimize(mask.get());
+}
+
+void setCounters(benchmark::State& state, const Range& area, double zoom) {
+    state.SetItemsProcessed(state.iterations());
+    state.counters["pixels"] = benchmark::Counter(area.getWidth() * area.getHeight() * zoom * zoom *
+                                                          static_cast<double>(state.iterations()),
+                                                  benchmark::Counter::kIsRate);
+}
+
+void fullPage(benchmark::State& state, Source* src) {
+    PageRef page = src->doc->getPage(0);
+    Range area(0, 0, page->getWidth(), page->getHeight());
+    double zoom = static_cast<double>(state.range(0)) / 100.0;
+
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        render(src, page, area, zoom);
+    }
+    counter.report(state);
+    setCounters(state, area, zoom);
+}
+
+void dirtyRect(benchmark::State& state, Source* src) {
+    PageRef page = src->doc->getPage(0);
+    double x = page->getWidth() / 2;
+    double y = page->getHeight() / 2;
+    Range area(x, y, x + DIRTY_RECT_SIZE, y + DIRTY_RECT_SIZE);
+    area.addPadding(RENDER_PADDING);
+    double zoom = static_cast<double>(state.range(0)) / 100.0;
+
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        render(src, page, area, zoom);
+    }
+    counter.report(state);
+    setCounters(state, area, zoom);
+}
+
+void thumbnail(benchmark::State& state, Source* src) {
+    PageRef page = src->doc->getPage(0);
+    Range area(0, 0, page->getWidth(), page->getHeight());
+    double zoom = THUMBNAIL_WIDTH / page->getWidth();
+
+    bench::AllocationCounter counter;
+    for (auto _: state) {
+        render(src, page, area, zoom);
+    }
+    counter.report(state);
+    setCounters(state, area, zoom);
+}
+};  // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    addGenerated("handwriting", bench::handwriting());
+    addGenerated("highlighter", bench::highlighter());
+    addGenerated("images", bench::images());
+    addGenerated("text", bench::texts());
+    addFile(GET_TESTFILE("packaged_xopp/pdfBackground/old.xopp"), "pdf");
+    for (int i = 1; i < argc; i++) {
+        addFile(argv[i]);
+    }
+
+    for (auto& src: sources) {
+        Source* s = src.get();
+        benchmark::RegisterBenchmark(("FullPage/" + s->name).c_str(), fullPage, s)
+                ->ArgsProduct({ZOOMS})
+                ->ArgName("zoom")
+                ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("DirtyRect/" + s->name).c_str(), dirtyRect, s)
+                ->ArgsProduct({ZOOMS})
+                ->ArgName("zoom")
+                ->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark(("Thumbnail/" + s->name).c_str(), thumbnail, s)->Unit(benchmark::kMillisecond);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    sources.clear();
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+#include <zip.h>
+
+#include "control/xojfile/AudioAttachments.h"
+
+#include "filesystem.h"
+
+namespace {
+auto readFile(const fs::path& file) -> std::string {
+    std::ifstream in(file, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void writeArchive(const fs::path& archive, const std::string& entry, const std::string& content) {
+    int zipError = 0;
+    zip_t* zip = zip_open(archive.u8string().c_str(), ZIP_CREATE | ZIP_TRUNCATE, &zipError);
+    ASSERT_NE(nullptr, zip);
+    zip_source_t* source = zip_source_buffer(zip, content.data(), content.size(), 0);
+    ASSERT_GE(zip_file_add(zip, entry.c_str(), source, ZIP_FL_OVERWRITE), 0);
+    ASSERT_EQ(0, zip_close(zip));
+}
+}  // namespace
+
+TEST(ControlAudioAttachments, testExtractOnDemand) {
+    const fs::path dir = fs::path(g_get_tmp_dir());
+    const fs::path archive = dir / "xournalpp-audio-attachments-test.xopp";
+    const fs::path first = dir / "xournalpp-audio-attachments-test-1.tmp";
+    const fs::path second = dir / "xournalpp-audio-attachments-test-2.tmp";
+    const std::string content(200000, 'a');
+
+    writeArchive(archive, "audio/first.ogg", content);
+    std::ofstream(first).close();
+
+    AudioAttachments::add(first, archive, "audio/first.ogg");
+    AudioAttachments::add(second, archive, "audio/missing.ogg");
+    EXPECT_TRUE(AudioAttachments::isPending(first));
+    EXPECT_TRUE(readFile(first).empty());
+
+    EXPECT_TRUE(AudioAttachments::extract(first));
+    EXPECT_FALSE(AudioAttachments::isPending(first));
+    EXPECT_EQ(content, readFile(first));
+
+    // Files which are not attachments, or already extracted, are left alone
+    EXPECT_TRUE(AudioAttachments::extract(first));
+    EXPECT_TRUE(AudioAttachments::extract(dir / "not-an-attachment.ogg"));
+
+    EXPECT_FALSE(AudioAttachments::extract(second));
+    EXPECT_TRUE(AudioAttachments::isPending(second));
+
+    fs::remove(archive);
+    fs::remove(first);
+    fs::remove(second);
+}
+
+TEST(ControlAudioAttachments, testExtractAll) {
+    const fs::path dir = fs::path(g_get_tmp_dir());
+    const fs::path archive = dir / "xournalpp-audio-attachments-all-test.xopp";
+    const fs::path tempFile = dir / "xournalpp-audio-attachments-all-test.tmp";
+
+    writeArchive(archive, "audio.ogg", "audio");
+    AudioAttachments::add(tempFile, archive, "audio.ogg");
+
+    AudioAttachments::extractAll(dir / "other.xopp");
+    EXPECT_TRUE(AudioAttachments::isPending(tempFile));
+
+    // The archive is found whatever the form of its path
+    AudioAttachments::extractAll(dir / "." / archive.filename());
+    EXPECT_FALSE(AudioAttachments::isPending(tempFile));
+    EXPECT_EQ("audio", readFile(tempFile));
+
+    fs::remove(archive);
+    fs::remove(tempFile);
+}
+
+#ifndef _WIN32
+TEST(ControlAudioAttachments, testArchiveRenamed) {
+    const fs::path dir = fs::path(g_get_tmp_dir());
+    const fs::path archive = dir / "xournalpp-audio-attachments-renamed-test.xopp";
+    const fs::path renamed = dir / "xournalpp-audio-attachments-renamed-test-2.xopp";
+    const fs::path tempFile = dir / "xournalpp-audio-attachments-renamed-test.tmp";
+
+    writeArchive(archive, "audio.ogg", "audio");
+    AudioAttachments::add(tempFile, archive, "audio.ogg");
+
+    // The archive stays open while an attachment is pending
+    fs::rename(archive, renamed);
+    fs::remove(renamed);
+    EXPECT_TRUE(AudioAttachments::extract(tempFile));
+    EXPECT_EQ("audio", readFile(tempFile));
+
+    fs::remove(tempFile);
+}
+#endif
@@ -0,0 +1,192 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/xojfile/AutosaveJournal.h"
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+static void addStroke(const PageRef& page, double x) {
+    auto* stroke = new Stroke();
+    stroke->addPoint(Point(x, 10));
+    stroke->addPoint(Point(x, 60));
+    (*page->getLayers())[0]->addElement(stroke);
+}
+
+static size_t elementCount(Document* doc, size_t page) {
+    return (*doc->getPage(page)->getLayers())[0]->getElements().size();
+}
+
+TEST(AutosaveJournal, onlyChangedPagesAreJournaled) {
+    auto folder = Util::getTmpDirSubfolder("autosave-journal-test");
+    auto snapshot = folder / "doc.autosave.xopp";
+    fs::remove(snapshot);
+    AutosaveJournal::moveJournal(snapshot, {});
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 6; i++) {
+        pages.emplace_back(std::make_shared<XojPage>(100, 100));
+    }
+    doc.addPages(pages.begin(), pages.end());
+
+    AutosaveJournal journal;
+    EXPECT_TRUE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+    EXPECT_FALSE(fs::exists(AutosaveJournal::getJournalPath(snapshot)));
+
+    // A single changed page is appended to the journal
+    addStroke(pages[2], 10);
+    journal.undoRedoPageChanged(pages[2]);
+    EXPECT_FALSE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+    EXPECT_TRUE(fs::exists(AutosaveJournal::getJournalPath(snapshot) / "0.xopp"));
+
+    // A new page and a deleted page only change the manifest and the new page
+    doc.deletePage(0);
+    auto inserted = std::make_shared<XojPage>(100, 100);
+    addStroke(inserted, 20);
+    addStroke(inserted, 30);
+    doc.insertPage(inserted, 1);
+    EXPECT_FALSE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+
+    LoadHandler loader;
+    Document* restored = loader.loadDocument(snapshot);
+    ASSERT_NE(nullptr, restored);
+    ASSERT_EQ(6U, restored->getPageCount());
+    EXPECT_EQ(0U, elementCount(restored, 0));
+    EXPECT_EQ(2U, elementCount(restored, 1));
+    EXPECT_EQ(1U, elementCount(restored, 2));
+    EXPECT_EQ(0U, elementCount(restored, 3));
+
+    // Changing most pages writes a new snapshot and drops the journal
+    for (size_t i = 0; i < doc.getPageCount(); i++) {
+        journal.undoRedoPageChanged(doc.getPage(i));
+    }
+    EXPECT_TRUE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+    EXPECT_FALSE(fs::exists(AutosaveJournal::getJournalPath(snapshot)));
+}
+
+TEST(AutosaveJournal, changesWithoutPageWriteSnapshot) {
+    auto folder = Util::getTmpDirSubfolder("autosave-journal-test");
+    auto snapshot = folder / "pageless.autosave.xopp";
+    fs::remove(snapshot);
+    AutosaveJournal::moveJournal(snapshot, {});
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 4; i++) {
+        pages.emplace_back(std::make_shared<XojPage>(100, 100));
+    }
+    doc.addPages(pages.begin(), pages.end());
+
+    AutosaveJournal journal;
+    EXPECT_TRUE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+
+    // e.g. renaming a layer
+    (*pages[1]->getLayers())[0]->setName("renamed");
+    journal.undoRedoDocumentChanged();
+    EXPECT_TRUE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+
+    addStroke(pages[3], 10);
+    journal.undoRedoPageChanged(pages[3]);
+    EXPECT_FALSE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+}
+
+TEST(AutosaveJournal, brokenJournalFailsLoading) {
+    auto folder = Util::getTmpDirSubfolder("autosave-journal-test");
+    auto snapshot = folder / "broken.autosave.xopp";
+    fs::remove(snapshot);
+    AutosaveJournal::moveJournal(snapshot, {});
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 4; i++) {
+        pages.emplace_back(std::make_shared<XojPage>(100, 100));
+    }
+    doc.addPages(pages.begin(), pages.end());
+
+    AutosaveJournal journal;
+    EXPECT_TRUE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+    addStroke(pages[0], 10);
+    journal.undoRedoPageChanged(pages[0]);
+    EXPECT_FALSE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+
+    fs::remove(AutosaveJournal::getJournalPath(snapshot) / "0.xopp");
+
+    LoadHandler loader;
+    EXPECT_EQ(nullptr, loader.loadDocument(snapshot));
+    EXPECT_NE("", loader.getLastError());
+}
+
+TEST(AutosaveJournal, journalOfAnotherSnapshotIsIgnored) {
+    auto folder = Util::getTmpDirSubfolder("autosave-journal-test");
+    auto snapshot = folder / "replaced.autosave.xopp";
+    auto stale = fs::path{AutosaveJournal::getJournalPath(snapshot)} += ".stale";
+    fs::remove(snapshot);
+    fs::remove_all(stale);
+    AutosaveJournal::moveJournal(snapshot, {});
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 4; i++) {
+        pages.emplace_back(std::make_shared<XojPage>(100, 100));
+    }
+    doc.addPages(pages.begin(), pages.end());
+
+    AutosaveJournal journal;
+    EXPECT_TRUE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+    addStroke(pages[0], 10);
+    journal.undoRedoPageChanged(pages[0]);
+    EXPECT_FALSE(journal.prepare(&doc, snapshot));
+    EXPECT_EQ("", journal.write());
+
+    // The snapshot is replaced, e.g. by another instance, but the journal stays
+    Document other(&handler);
+    std::vector<PageRef> otherPages{std::make_shared<XojPage>(100, 100), std::make_shared<XojPage>(100, 100)};
+    other.addPages(otherPages.begin(), otherPages.end());
+    SaveHandler saver;
+    saver.prepareSave(&other);
+    saver.saveTo(snapshot);
+    ASSERT_EQ("", saver.getErrorMessage());
+
+    LoadHandler loader;
+    Document* restored = loader.loadDocument(snapshot);
+    ASSERT_NE(nullptr, restored) << loader.getLastError();
+    EXPECT_EQ(2U, restored->getPageCount());
+    EXPECT_FALSE(fs::exists(AutosaveJournal::getJournalPath(snapshot)));
+    EXPECT_TRUE(fs::exists(stale / "0.xopp"));
+}
@@ -359,6 +359,23 @@ TEST(ControlLoadHandler, testImageZipped) {
     EXPECT_TRUE(img);
 }
 
+TEST(ControlLoadHandler, testPdfAttachment) {
+    // The PDF is deflated in new.xopp and stored (thus mapped instead of read) in stored.xopp
+    LoadHandler compressedHandler;
+    Document* compressed = compressedHandler.loadDocument(GET_TESTFILE("packaged_xopp/pdfBackground/new.xopp"));
+    LoadHandler storedHandler;
+    Document* stored = storedHandler.loadDocument(GET_TESTFILE("packaged_xopp/pdfBackground/stored.xopp"));
+    ASSERT_TRUE(compressed);
+    ASSERT_TRUE(stored);
+
+    EXPECT_TRUE(stored->isAttachPdf());
+    EXPECT_GT(stored->getPdfPageCount(), 0U);
+    EXPECT_EQ(compressed->getPdfPageCount(), stored->getPdfPageCount());
+    auto page = stored->getPdfPage(0);
+    ASSERT_TRUE(page);
+    EXPECT_DOUBLE_EQ(compressed->getPdfPage(0)->getWidth(), page->getWidth());
+}
+
 namespace {
 void checkImageFormat(Image* img, const char* formatName) {
     GdkPixbufLoader* imgLoader = gdk_pixbuf_loader_new();
@@ -509,3 +526,32 @@ TEST(ControlLoadHandler, testStrokeWidthRecovery) {
 
     testPressureValues(8, {0.25, 0.30, 0.40, Point::NO_PRESSURE});
 }
+
+TEST(ControlLoadHandler, attachedBackgroundNamedAfterTarget) {
+    // SaveJob writes a temporary file which is renamed over the target: the attached background images must be named
+    // after the target, where the loader looks for them
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/imgBackground/old.xopp"));
+    ASSERT_TRUE(doc);
+    ASSERT_TRUE(doc->getPage(0)->getBackgroundType().isImagePage());
+    doc->getPage(0)->getBackgroundImage().setAttach(true);
+
+    auto dir = Util::getTmpDirSubfolder();
+    auto target = dir / "attachedBackground.xopp";
+    auto tmp = dir / ".attachedBackground.xopp.tmp";
+
+    SaveHandler saver;
+    saver.prepareSave(doc);
+    saver.saveTo(tmp, target, nullptr);
+    ASSERT_EQ("", saver.getErrorMessage());
+
+    EXPECT_TRUE(fs::exists(fs::path{target} += ".bg_1.png"));
+    EXPECT_FALSE(fs::exists(fs::path{tmp} += ".bg_1.png"));
+
+    fs::rename(tmp, target);
+    LoadHandler handler2;
+    Document* saved = handler2.loadDocument(target);
+    ASSERT_TRUE(saved) << handler2.getLastError();
+    ASSERT_TRUE(saved->getPage(0)->getBackgroundType().isImagePage());
+    EXPECT_NE(nullptr, saved->getPage(0)->getBackgroundImage().getPixbuf());
+}
@@ -0,0 +1,46 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/SearchIndex.h"
+#include "model/Layer.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+
+TEST(SearchIndex, normalizeMapsBytesToCharacters) {
+    std::vector<uint32_t> charOfByte;
+    EXPECT_EQ("héllo", SearchIndex::normalize("HÉllo", &charOfByte));
+
+    // "é" takes two bytes, both belonging to the second character
+    std::vector<uint32_t> expected = {0, 1, 1, 2, 3, 4};
+    EXPECT_EQ(expected, charOfByte);
+}
+
+TEST(SearchIndex, mayContainTypedText) {
+    auto page = std::make_shared<XojPage>(100, 100);
+    auto* text = new Text();
+    text->setText("Hello World");
+    (*page->getLayers())[0]->addElement(text);
+
+    SearchIndex index;
+    EXPECT_TRUE(index.mayContain(page, "world"));
+    EXPECT_TRUE(index.mayContain(page, "LO WO"));
+    EXPECT_FALSE(index.mayContain(page, "planet"));
+
+    // Not indexed PDF pages may always contain the text
+    page->setBackgroundPdfPageNr(0);
+    EXPECT_TRUE(index.mayContain(page, "planet"));
+}
@@ -0,0 +1,151 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/tools/StrokePredictor.h"
+
+TEST(ControlStrokePredictor, testNotEnoughEvents) {
+    StrokePredictor predictor(10);
+    EXPECT_EQ(utl::Point<double>(0, 0), predictor.predictDisplacement(10));
+    predictor.addEvent(0, 0, 100);
+    predictor.addEvent(1, 0, 104);
+    EXPECT_EQ(utl::Point<double>(0, 0), predictor.predictDisplacement(10));
+
+    // Events of the same ms count as one
+    predictor.addEvent(2, 0, 104);
+    EXPECT_EQ(utl::Point<double>(0, 0), predictor.predictDisplacement(10));
+}
+
+TEST(ControlStrokePredictor, testConstantVelocity) {
+    StrokePredictor predictor(10);
+    for (guint32 t = 0; t <= 20; t += 4) {
+        predictor.addEvent(0.5 * t, -0.25 * t, 1000 + t);
+    }
+    auto d = predictor.predictDisplacement(8);
+    EXPECT_DOUBLE_EQ(4.0, d.x);
+    EXPECT_DOUBLE_EQ(-2.0, d.y);
+
+    // The prediction does not go beyond the horizon
+    d = predictor.predictDisplacement(100);
+    EXPECT_DOUBLE_EQ(5.0, d.x);
+    EXPECT_DOUBLE_EQ(-2.5, d.y);
+}
+
+TEST(ControlStrokePredictor, testConstantAcceleration) {
+    StrokePredictor predictor(10);
+    auto position = [](double t) { return 0.01 * t * t + 0.5 * t; };
+    for (guint32 t = 0; t <= 24; t += 4) {
+        predictor.addEvent(position(t), 0, t);
+    }
+    auto d = predictor.predictDisplacement(10);
+    EXPECT_NEAR(position(34) - position(24), d.x, 1e-9);
+    EXPECT_NEAR(0.0, d.y, 1e-9);
+}
+
+TEST(ControlStrokePredictor, testOldEventsAreDropped) {
+    StrokePredictor predictor(10);
+    // Motion to the right, then a pause and a motion downwards
+    for (guint32 t = 0; t <= 20; t += 4) {
+        predictor.addEvent(t, 0, t);
+    }
+    for (guint32 t = 200; t <= 220; t += 4) {
+        predictor.addEvent(20, t - 200, t);
+    }
+    auto d = predictor.predictDisplacement(10);
+    EXPECT_NEAR(0.0, d.x, 1e-9);
+    EXPECT_NEAR(10.0, d.y, 1e-9);
+
+    // The timestamps went backwards: the motion is unknown again
+    predictor.addEvent(20, 24, 10);
+    EXPECT_EQ(utl::Point<double>(0, 0), predictor.predictDisplacement(10));
+
+    predictor.reset();
+    EXPECT_EQ(utl::Point<double>(0, 0), predictor.predictDisplacement(10));
+}
+
+namespace {
+/**
+ * Synthetic cursive handwriting at 100% zoom: a steady motion to the right with loops, at about 0.21 px/ms
+ * @param t Time in ms
+ */
+auto handwriting(double t, int stroke) -> utl::Point<double> {
+    constexpr double PI = 3.14159265358979323846;
+    double s = t / 1000.0;
+    double phase = stroke * 0.7;
+    return {120.0 * s + 6.0 * std::sin(2 * PI * 5.0 * s + phase), 8.0 * std::sin(2 * PI * 4.0 * s + 2 * phase)};
+}
+
+struct Lag {
+    double mean;
+    double p95;
+};
+
+auto lag(std::vector<double> distances) -> Lag {
+    std::sort(distances.begin(), distances.end());
+    double sum = 0;
+    for (double d: distances) {
+        sum += d;
+    }
+    return {sum / static_cast<double>(distances.size()), distances[distances.size() * 95 / 100]};
+}
+}  // namespace
+
+/**
+ * Distance between the pen and the drawn end of the stroke after a display latency, with and without the
+ * prediction. Prints the table, run with --gtest_filter=ControlStrokePredictor.testLagTable to see it.
+ */
+TEST(ControlStrokePredictor, testLagTable) {
+    const double rates[] = {240.0, 133.0};  // Events per second, of a tablet and of a mouse or touch screen
+    const double latencies[] = {8, 16, 24, 32};
+
+    for (double rate: rates) {
+        for (double latency: latencies) {
+            std::vector<double> off;
+            std::vector<double> on;
+            std::mt19937 rng(42);
+            std::normal_distribution<double> noise(0.0, 0.05);
+
+            for (int stroke = 0; stroke < 200; stroke++) {
+                StrokePredictor predictor(latency);
+                const double duration = 400.0;
+                for (double t = 0; t <= duration - latency; t += 1000.0 / rate) {
+                    auto timestamp = static_cast<guint32>(t);
+                    auto pos = handwriting(timestamp, stroke);
+                    predictor.addEvent(pos.x + noise(rng), pos.y + noise(rng), timestamp);
+                    if (t < 20) {
+                        // The start of the stroke, the motion is not known yet
+                        continue;
+                    }
+                    auto truth = handwriting(timestamp + latency, stroke);
+                    auto d = predictor.predictDisplacement(latency);
+                    off.push_back(std::hypot(truth.x - pos.x, truth.y - pos.y));
+                    on.push_back(std::hypot(truth.x - (pos.x + d.x), truth.y - (pos.y + d.y)));
+                }
+            }
+
+            Lag withoutPrediction = lag(off);
+            Lag withPrediction = lag(on);
+            printf("%3.0f Hz, latency %2.0f ms: without prediction mean %.2f px p95 %.2f px, with prediction mean "
+                   "%.2f px p95 %.2f px\n",
+                   rate, latency, withoutPrediction.mean, withoutPrediction.p95, withPrediction.mean,
+                   withPrediction.p95);
+            EXPECT_LT(withPrediction.mean, withoutPrediction.mean);
+            EXPECT_LT(withPrediction.p95, withoutPrediction.p95);
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "control/ThumbnailCache.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+static fs::path makeCacheFolder(const char* name) {
+    auto folder = Util::getTmpDirSubfolder("thumbnail-cache-test") / name;
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    return folder;
+}
+
+static cairo_surface_t* makeSurface(int width, int height) {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    cairo_set_source_rgb(cr, 0.2, 0.4, 0.6);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    return surface;
+}
+
+TEST(ThumbnailCache, keyDependsOnContent) {
+    XojPage page(200, 300);
+    auto key1 = ThumbnailCache::computeKey(page, {}, "test", 20, 30);
+    EXPECT_EQ(key1, ThumbnailCache::computeKey(page, {}, "test", 20, 30));
+    EXPECT_NE(key1, ThumbnailCache::computeKey(page, {}, "test", 40, 60));
+    EXPECT_NE(key1, ThumbnailCache::computeKey(page, {}, "other", 20, 30));
+
+    auto* stroke = new Stroke();
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(50, 60));
+    (*page.getLayers())[0]->addElement(stroke);
+
+    auto key2 = ThumbnailCache::computeKey(page, {}, "test", 20, 30);
+    EXPECT_NE(key1, key2);
+
+    stroke->move(1, 0);
+    EXPECT_NE(key2, ThumbnailCache::computeKey(page, {}, "test", 20, 30));
+}
+
+TEST(ThumbnailCache, keyDependsOnPdfContent) {
+    XojPage page(200, 300);
+    page.setBackgroundPdfPageNr(0);
+
+    // Attached PDFs all have the same name, only their content tells them apart
+    auto key1 = ThumbnailCache::computeKey(page, "fingerprint-1", "test", 20, 30);
+    EXPECT_NE(key1, ThumbnailCache::computeKey(page, "fingerprint-2", "test", 20, 30));
+
+    // The key can be hashed without the document lock
+    auto source = ThumbnailCache::collectKeySource(page, "fingerprint-1", "test", 20, 30);
+    EXPECT_EQ(key1, ThumbnailCache::computeKey(source));
+
+    page.setBackgroundPdfPageNr(1);
+    EXPECT_NE(key1, ThumbnailCache::computeKey(page, "fingerprint-1", "test", 20, 30));
+}
+
+TEST(ThumbnailCache, storeAndLookup) {
+    ThumbnailCache cache(makeCacheFolder("storeAndLookup"), 1024 * 1024);
+    EXPECT_FALSE(cache.lookup("abc", 20, 30));
+
+    cairo_surface_t* surface = makeSurface(20, 30);
+    cache.store("abc", surface);
+    cairo_surface_destroy(surface);
+
+    auto cached = cache.lookup("abc", 20, 30);
+    ASSERT_TRUE(cached);
+    EXPECT_EQ(20, cairo_image_surface_get_width(cached.get()));
+    EXPECT_EQ(30, cairo_image_surface_get_height(cached.get()));
+
+    // An entry of another size is not returned
+    EXPECT_FALSE(cache.lookup("abc", 40, 30));
+}
+
+TEST(ThumbnailCache, disabled) {
+    ThumbnailCache cache(makeCacheFolder("disabled"), 0);
+    EXPECT_FALSE(cache.isEnabled());
+
+    cairo_surface_t* surface = makeSurface(20, 30);
+    cache.store("abc", surface);
+    cairo_surface_destroy(surface);
+
+    EXPECT_FALSE(cache.lookup("abc", 20, 30));
+}
+
+TEST(ThumbnailCache, eviction) {
+    auto folder = makeCacheFolder("eviction");
+    ThumbnailCache cache(folder, 1024 * 1024);
+
+    cairo_surface_t* surface = makeSurface(64, 64);
+    for (int i = 0; i < 10; i++) {
+        cache.store("entry" + std::to_string(i), surface);
+    }
+    cairo_surface_destroy(surface);
+
+    size_t totalSize = 0;
+    for (auto const& f: fs::directory_iterator(folder)) {
+        totalSize += static_cast<size_t>(f.file_size());
+    }
+
+    // Shrinking the limit evicts entries until the cache fits again
+    cache.setMaxSize(totalSize / 2);
+
+    size_t newSize = 0;
+    for (auto const& f: fs::directory_iterator(folder)) {
+        newSize += static_cast<size_t>(f.file_size());
+    }
+    EXPECT_LE(newSize, totalSize / 2);
+    EXPECT_GT(newSize, 0U);
+}
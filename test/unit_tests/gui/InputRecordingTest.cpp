@@ -0,0 +1,58 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "gui/inputdevices/InputRecording.h"
+
+TEST(InputRecordingTest, testFormatParseRoundtrip) {
+    RecordedEvent event;
+    event.time = 1234567;
+    event.type = MOTION_EVENT;
+    event.deviceClass = INPUT_DEVICE_PEN;
+    event.x = 123.456789012345;
+    event.y = 0.1;
+    event.absoluteX = 1e5 / 3;
+    event.absoluteY = -2.5;
+    event.pressure = 0.73;
+    event.button = 1;
+    event.state = 256;
+    event.sequence = 3;
+    event.timestamp = 4000000000U;
+    event.deviceName = "Wacom Intuos Pro M Pen stylus";
+
+    RecordedEvent parsed;
+    ASSERT_TRUE(InputRecording::parse(InputRecording::format(event), parsed));
+    EXPECT_EQ(event.time, parsed.time);
+    EXPECT_EQ(event.type, parsed.type);
+    EXPECT_EQ(event.deviceClass, parsed.deviceClass);
+    EXPECT_EQ(event.x, parsed.x);
+    EXPECT_EQ(event.y, parsed.y);
+    EXPECT_EQ(event.absoluteX, parsed.absoluteX);
+    EXPECT_EQ(event.absoluteY, parsed.absoluteY);
+    EXPECT_EQ(event.pressure, parsed.pressure);
+    EXPECT_EQ(event.button, parsed.button);
+    EXPECT_EQ(event.state, parsed.state);
+    EXPECT_EQ(event.sequence, parsed.sequence);
+    EXPECT_EQ(event.timestamp, parsed.timestamp);
+    EXPECT_EQ(event.deviceName, parsed.deviceName);
+}
+
+TEST(InputRecordingTest, testParseInvalid) {
+    RecordedEvent event;
+    EXPECT_FALSE(InputRecording::parse("", event));
+    EXPECT_FALSE(InputRecording::parse("12 5 1 1.0 2.0", event));
+    EXPECT_FALSE(InputRecording::parse("12 99 1 1 2 3 4 -1 0 0 0 0 mouse", event));
+    EXPECT_FALSE(InputRecording::parse("12 5 42 1 2 3 4 -1 0 0 0 0 mouse", event));
+}
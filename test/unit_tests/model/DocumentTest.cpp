@@ -0,0 +1,121 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/XojPage.h"
+#include "util/Util.h"
+
+static PageRef makePage(size_t pdfPage = npos) {
+    auto page = std::make_shared<XojPage>(100, 100);
+    if (pdfPage != npos) {
+        page->setBackgroundPdfPageNr(pdfPage);
+    }
+    return page;
+}
+
+TEST(Document, indexOfAfterInsertAndDelete) {
+    DocumentHandler handler;
+    Document doc(&handler);
+
+    std::vector<PageRef> pages;
+    for (size_t i = 0; i < 10; i++) {
+        pages.emplace_back(makePage());
+    }
+    doc.addPages(pages.begin(), pages.end());
+
+    for (size_t i = 0; i < pages.size(); i++) {
+        EXPECT_EQ(i, doc.indexOf(pages[i]));
+    }
+
+    auto inserted = makePage();
+    doc.insertPage(inserted, 3);
+    EXPECT_EQ(2U, doc.indexOf(pages[2]));
+    EXPECT_EQ(3U, doc.indexOf(inserted));
+    EXPECT_EQ(4U, doc.indexOf(pages[3]));
+    EXPECT_EQ(10U, doc.indexOf(pages[9]));
+
+    doc.deletePage(0);
+    EXPECT_EQ(npos, doc.indexOf(pages[0]));
+    EXPECT_EQ(0U, doc.indexOf(pages[1]));
+    EXPECT_EQ(2U, doc.indexOf(inserted));
+    EXPECT_EQ(9U, doc.indexOf(pages[9]));
+
+    auto appended = makePage();
+    doc.addPage(appended);
+    EXPECT_EQ(10U, doc.indexOf(appended));
+
+    EXPECT_EQ(npos, doc.indexOf(makePage()));
+}
+
+TEST(Document, indexOfFromSeveralThreads) {
+    DocumentHandler handler;
+    Document doc(&handler);
+
+    std::vector<PageRef> pages;
+    for (size_t i = 0; i < 1000; i++) {
+        pages.emplace_back(makePage());
+    }
+    doc.addPages(pages.begin(), pages.end());
+    doc.insertPage(makePage(), 0);
+
+    // The readers all find the positions out of date and recompute them
+    const Document& constDoc = doc;
+    std::vector<std::thread> readers;
+    std::vector<size_t> found(4, 0);
+    for (size_t r = 0; r < found.size(); r++) {
+        readers.emplace_back([&, r] {
+            for (size_t i = 0; i < pages.size(); i++) {
+                found[r] += constDoc.indexOf(pages[i]) == i + 1;
+            }
+        });
+    }
+    for (auto& t: readers) {
+        t.join();
+    }
+    for (size_t n: found) {
+        EXPECT_EQ(pages.size(), n);
+    }
+}
+
+TEST(Document, findPdfPageAfterInsertAndDelete) {
+    DocumentHandler handler;
+    Document doc(&handler);
+
+    std::vector<PageRef> pages = {makePage(0), makePage(), makePage(1), makePage(2)};
+    doc.addPages(pages.begin(), pages.end());
+
+    EXPECT_EQ(0U, doc.findPdfPage(0));
+    EXPECT_EQ(2U, doc.findPdfPage(1));
+    EXPECT_EQ(3U, doc.findPdfPage(2));
+    EXPECT_EQ(npos, doc.findPdfPage(3));
+
+    doc.insertPage(makePage(), 0);
+    EXPECT_EQ(1U, doc.findPdfPage(0));
+    EXPECT_EQ(3U, doc.findPdfPage(1));
+
+    // A copy of a pdf page before the original becomes the first match
+    doc.insertPage(makePage(2), 1);
+    EXPECT_EQ(1U, doc.findPdfPage(2));
+
+    // Deleting it falls back to the remaining page with this background
+    doc.deletePage(1);
+    EXPECT_EQ(4U, doc.findPdfPage(2));
+
+    doc.deletePage(doc.indexOf(pages[2]));
+    EXPECT_EQ(npos, doc.findPdfPage(1));
+}
@@ -0,0 +1,83 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <pango/pango.h>
+
+#include "model/Text.h"
+#include "pdf/base/XojPdfPage.h"
+
+namespace {
+/**
+ * The size of the text, measured on a new layout as the TextEditor does
+ */
+void expectSizeOfNewLayout(const Text& text) {
+    auto layout = text.createPangoLayout();
+    pango_layout_set_text(layout.get(), text.getText().c_str(), static_cast<int>(text.getText().length()));
+    int w = 0;
+    int h = 0;
+    pango_layout_get_size(layout.get(), &w, &h);
+    EXPECT_DOUBLE_EQ(static_cast<double>(w) / PANGO_SCALE, text.getElementWidth());
+    EXPECT_DOUBLE_EQ(static_cast<double>(h) / PANGO_SCALE, text.getElementHeight());
+}
+}  // namespace
+
+TEST(Text, cachedLayoutFollowsText) {
+    Text text;
+    text.setText("a");
+    expectSizeOfNewLayout(text);
+    double width = text.getElementWidth();
+
+    text.setText("aaaa");
+    expectSizeOfNewLayout(text);
+    EXPECT_GT(text.getElementWidth(), width);
+
+    text.setText("aaaa\naaaa");
+    expectSizeOfNewLayout(text);
+}
+
+TEST(Text, cachedLayoutFollowsFont) {
+    Text text;
+    text.setText("abc");
+    double width = text.getElementWidth();
+
+    text.scale(0, 0, 2, 2, 0, false);
+    expectSizeOfNewLayout(text);
+    EXPECT_GT(text.getElementWidth(), width);
+}
+
+TEST(Text, cachedLayoutPerThread) {
+    Text text;
+    text.setText("abab");
+
+    auto inOtherThread = [&text] {
+        std::vector<XojPdfRectangle> result;
+        std::thread([&] { result = text.findText("b"); }).join();
+        return result;
+    };
+
+    auto local = text.findText("b");
+    auto other = inOtherThread();
+    ASSERT_EQ(2U, local.size());
+    ASSERT_EQ(local.size(), other.size());
+    for (size_t i = 0; i < local.size(); i++) {
+        EXPECT_DOUBLE_EQ(local[i].x1, other[i].x1);
+        EXPECT_DOUBLE_EQ(local[i].x2, other[i].x2);
+    }
+
+    // Other threads see the new text as well
+    text.setText("bbb");
+    EXPECT_EQ(3U, text.findText("b").size());
+    EXPECT_EQ(3U, inOtherThread().size());
+}
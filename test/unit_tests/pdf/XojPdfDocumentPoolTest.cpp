@@ -0,0 +1,86 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "pdf/base/XojPdfDocument.h"
+#include "pdf/base/XojPdfDocumentPool.h"
+
+namespace {
+const char* const PDF_FILE = GET_TESTFILE("packaged_xopp/pdfBackground/old.xopp.bg.pdf");
+}
+
+TEST(PdfDocumentPool, testInstancesFromFile) {
+    XojPdfDocument doc;
+    ASSERT_TRUE(doc.load(fs::u8path(PDF_FILE), "", nullptr));
+
+    XojPdfDocumentPool pool(doc, 2);
+    EXPECT_EQ(0U, pool.getOpenCount());
+    {
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        EXPECT_EQ(2U, pool.getOpenCount());
+
+        EXPECT_NE(&*first, &*second);
+        // The loaded document is never handed out
+        XojPdfDocument instance(*first);
+        EXPECT_FALSE(doc == instance);
+        EXPECT_TRUE(first->isLoaded());
+        ASSERT_TRUE(second->isLoaded());
+        EXPECT_EQ(doc.getPageCount(), second->getPageCount());
+    }
+    // Released instances are reused
+    {
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        EXPECT_EQ(2U, pool.getOpenCount());
+    }
+
+    pool.setSize(1);
+    EXPECT_EQ(1U, pool.getOpenCount());
+}
+
+TEST(PdfDocumentPool, testInstancesFromData) {
+    XojPdfDocument doc;
+    {
+        std::ifstream in(PDF_FILE, std::ios::binary);
+        std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        ASSERT_TRUE(doc.load(bytes.data(), bytes.size(), "", nullptr));
+        // The data is freed: the document must have kept its own copy
+    }
+
+    XojPdfDocumentPool pool(doc, 2);
+    auto first = pool.acquire();
+    auto second = pool.acquire();
+    ASSERT_TRUE(second->isLoaded());
+    ASSERT_EQ(doc.getPageCount(), second->getPageCount());
+    auto page = second->getPage(0);
+    ASSERT_TRUE(page);
+    EXPECT_GT(page->getWidth(), 0.0);
+}
+
+TEST(PdfDocumentPool, testNotLoaded) {
+    XojPdfDocument doc;
+    XojPdfDocumentPool pool(doc, 2);
+    {
+        auto lease = pool.acquire();
+        EXPECT_FALSE(lease->isLoaded());
+        EXPECT_EQ(nullptr, lease->getPage(0));
+    }
+    // Instances which could not be opened are not kept, the next acquire tries again
+    EXPECT_EQ(0U, pool.getOpenCount());
+    EXPECT_EQ(2U, pool.getSize());
+}
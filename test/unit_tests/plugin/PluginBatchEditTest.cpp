@@ -0,0 +1,168 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "plugin/PluginBatchEdit.h"
+#include "undo/UndoRedoHandler.h"
+
+namespace {
+/**
+ * Gives access to the layers, as LayerController does
+ */
+class TestPage: public XojPage {
+public:
+    TestPage(): XojPage(100, 100) {}
+
+    using XojPage::addLayer;
+    using XojPage::removeLayer;
+};
+
+/**
+ * Counts the undo actions added
+ */
+class UndoCounter: public UndoRedoListener {
+public:
+    UndoCounter() { undo.addUndoRedoListener(this); }
+
+    void undoRedoChanged() override { actions++; }
+    void undoRedoPageChanged(PageRef) override {}
+
+    UndoRedoHandler undo{nullptr};
+    int actions = 0;
+};
+
+auto insertStroke(Layer* layer) -> Element* {
+    auto* stroke = new Stroke();
+    layer->addElement(stroke);
+    return stroke;
+}
+}  // namespace
+
+TEST(PluginBatchEdit, testNestedScopes) {
+    UndoCounter counter;
+    auto page = std::make_shared<TestPage>();
+    Layer* layer = page->getSelectedLayer();
+
+    PluginBatchEdit batch;
+    EXPECT_FALSE(batch.isOpen());
+    batch.begin();
+    batch.begin();
+    batch.addInsert(page, layer, {insertStroke(layer)});
+    batch.end(&counter.undo);
+    EXPECT_TRUE(batch.isOpen());
+    EXPECT_EQ(0, counter.actions);
+
+    // Both insertions become a single undo action
+    batch.addInsert(page, layer, {insertStroke(layer)});
+    batch.end(&counter.undo);
+    EXPECT_FALSE(batch.isOpen());
+    EXPECT_EQ(1, counter.actions);
+}
+
+TEST(PluginBatchEdit, testLayerRemovedDuringBatch) {
+    UndoCounter counter;
+    auto page = std::make_shared<TestPage>();
+    auto* removed = new Layer();
+    page->addLayer(removed);
+
+    PluginBatchEdit batch;
+    batch.begin();
+    batch.addInsert(page, removed, {insertStroke(removed)});
+    page->removeLayer(removed);
+    // Owned by the undo action of the deletion in the application
+    std::unique_ptr<Layer> owner(removed);
+
+    batch.end(&counter.undo);
+    EXPECT_EQ(0, counter.actions);
+}
+
+TEST(PluginBatchEdit, testLayerDeletedDuringBatch) {
+    UndoCounter counter;
+    auto page = std::make_shared<TestPage>();
+    auto* deleted = new Layer();
+    page->addLayer(deleted);
+
+    PluginBatchEdit batch;
+    batch.begin();
+    batch.addInsert(page, deleted, {insertStroke(deleted)});
+    page->removeLayer(deleted);
+    delete deleted;
+
+    // A new layer may get the address of the deleted one, but does not contain its elements
+    page->addLayer(new Layer());
+    batch.end(&counter.undo);
+    EXPECT_EQ(0, counter.actions);
+}
+
+TEST(PluginBatchEdit, testElementRemovedDuringBatch) {
+    UndoCounter counter;
+    auto page = std::make_shared<TestPage>();
+    Layer* layer = page->getSelectedLayer();
+
+    PluginBatchEdit batch;
+    batch.begin();
+    Element* kept = insertStroke(layer);
+    Element* removed = insertStroke(layer);
+    batch.addInsert(page, layer, {kept, removed});
+    layer->removeElement(removed, true);
+    batch.end(&counter.undo);
+    EXPECT_EQ(1, counter.actions);
+
+    // Nothing left to undo
+    batch.begin();
+    removed = insertStroke(layer);
+    batch.addInsert(page, layer, {removed});
+    layer->removeElement(removed, true);
+    batch.end(&counter.undo);
+    EXPECT_EQ(1, counter.actions);
+}
+
+TEST(PluginBatchEdit, testFailedScopeRollsBack) {
+    UndoCounter counter;
+    auto page = std::make_shared<TestPage>();
+    Layer* layer = page->getSelectedLayer();
+
+    PluginBatchEdit batch;
+    batch.begin();
+    batch.addInsert(page, layer, {insertStroke(layer)});
+    batch.end(&counter.undo, true);
+    EXPECT_FALSE(batch.isOpen());
+    EXPECT_EQ(0, counter.actions);
+    EXPECT_TRUE(layer->getElements().empty());
+}
+
+TEST(PluginBatchEdit, testFailedNestedScopeKeepsOuterInserts) {
+    UndoCounter counter;
+    auto page = std::make_shared<TestPage>();
+    Layer* layer = page->getSelectedLayer();
+
+    PluginBatchEdit batch;
+    batch.begin();
+    Element* kept = insertStroke(layer);
+    batch.addInsert(page, layer, {kept});
+
+    // e.g. app.batchEdit called in pcall by the plugin
+    batch.begin();
+    batch.addInsert(page, layer, {insertStroke(layer)});
+    batch.end(&counter.undo, true);
+    ASSERT_EQ(1U, layer->getElements().size());
+    EXPECT_EQ(kept, layer->getElements()[0]);
+
+    batch.end(&counter.undo);
+    EXPECT_EQ(1, counter.actions);
+    EXPECT_EQ(1U, layer->getElements().size());
+}
@@ -0,0 +1,72 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "undo/UndoAction.h"
+#include "undo/UndoRedoHandler.h"
+
+namespace {
+class TestAction: public UndoAction {
+public:
+    TestAction(): UndoAction("TestAction") {}
+
+    bool undo(Control*) override { return true; }
+    bool redo(Control*) override { return true; }
+    std::string getText() override { return "Test"; }
+};
+}  // namespace
+
+TEST(UndoRedoHandler, testDocumentSavedDuringEdit) {
+    UndoRedoHandler handler(nullptr);
+    EXPECT_FALSE(handler.isChanged());
+
+    handler.addUndoAction(std::make_unique<TestAction>());
+    EXPECT_TRUE(handler.isChanged());
+
+    // A background save takes its snapshot, then the document is edited before the file is written
+    UndoRedoHandler::StateId snapshot = handler.getCurrentState();
+    handler.addUndoAction(std::make_unique<TestAction>());
+    handler.documentSaved(snapshot);
+    EXPECT_TRUE(handler.isChanged());
+
+    handler.documentSaved(handler.getCurrentState());
+    EXPECT_FALSE(handler.isChanged());
+}
+
+TEST(UndoRedoHandler, testDocumentSavedEmpty) {
+    UndoRedoHandler handler(nullptr);
+    UndoRedoHandler::StateId snapshot = handler.getCurrentState();
+    EXPECT_EQ(0U, snapshot);
+
+    handler.addUndoAction(std::make_unique<TestAction>());
+    handler.documentSaved(snapshot);
+    EXPECT_TRUE(handler.isChanged());
+
+    handler.clearContents();
+    EXPECT_FALSE(handler.isChanged());
+}
+
+TEST(UndoRedoHandler, testDocumentSavedDiscardedState) {
+    UndoRedoHandler handler(nullptr);
+    handler.addUndoAction(std::make_unique<TestAction>());
+    UndoRedoHandler::StateId snapshot = handler.getCurrentState();
+
+    // The saved action is freed, and the new one may be allocated at the same address: its state is still different
+    handler.clearContents();
+    handler.addUndoAction(std::make_unique<TestAction>());
+    EXPECT_NE(snapshot, handler.getCurrentState());
+    handler.documentSaved(snapshot);
+    EXPECT_TRUE(handler.isChanged());
+}
@@ -1,5 +1,6 @@
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <random>
 #include <string>
 #include <tuple>
@@ -398,3 +399,62 @@ TEST(UtilObjectIOStream, testReadStroke) {
         FAIL();
     }
 }
+
+TEST(UtilObjectIOStream, testReadTaggedFormat) {
+    // Data of older versions, which tag every value with two characters
+    Stroke stroke;
+    stroke.addPoint(Point(-1312., 8));
+    stroke.addPoint(Point(42.1, -42.1));
+    stroke.setWidth(1337.);
+    stroke.setAudioFilename("assets/bar.mp3");
+
+    ObjectOutputStream outStream(new BinObjectEncoding, ObjectStreamFormat::TAGGED);
+    stroke.serialize(outStream);
+    outStream.writeSizeT(10000000000);
+    auto gstr = outStream.getStr();
+    std::string str(gstr->str, gstr->len);
+    g_string_free(gstr, true);
+    EXPECT_EQ(0, str.rfind("_s", 0));
+    EXPECT_EQ(XML_VERSION_STR, str.substr(2 + sizeof(size_t), std::strlen(XML_VERSION_STR)));
+
+    ObjectInputStream stream;
+    ASSERT_TRUE(stream.read(str.data(), str.size()));
+    Stroke in_stroke;
+    in_stroke.readSerialized(stream);
+    assertStrokeEquality(stroke, in_stroke);
+    EXPECT_EQ(10000000000, stream.readSizeT());
+}
+
+TEST(UtilObjectIOStream, testCompactFormat) {
+    Stroke stroke;
+    for (int i = 0; i < 1000; i++) {
+        stroke.addPoint(Point(i, -i, 0.5));
+    }
+
+    auto serialize = [&stroke](ObjectStreamFormat format) {
+        ObjectOutputStream outStream(new BinObjectEncoding, format);
+        stroke.serialize(outStream);
+        auto gstr = outStream.getStr();
+        std::string str(gstr->str, gstr->len);
+        g_string_free(gstr, true);
+        return str;
+    };
+    std::string compact = serialize(ObjectStreamFormat::COMPACT);
+    std::string tagged = serialize(ObjectStreamFormat::TAGGED);
+    EXPECT_EQ(0, compact.find(COMPACT_VERSION_STR));
+    EXPECT_LT(compact.size(), tagged.size());
+
+    ObjectInputStream stream;
+    ASSERT_TRUE(stream.read(compact.data(), compact.size()));
+    Stroke in_stroke;
+    in_stroke.readSerialized(stream);
+    assertStrokeEquality(stroke, in_stroke);
+
+    // Truncated data must be rejected, not read past its end
+    for (size_t len: {compact.size() - 1, compact.size() / 2, size_t(12)}) {
+        ObjectInputStream truncated;
+        ASSERT_TRUE(truncated.read(compact.data(), len));
+        Stroke s;
+        EXPECT_THROW(s.readSerialized(truncated), InputStreamException);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "util/GzUtil.h"
+#include "util/OutputStream.h"
+
+#include "filesystem.h"
+
+namespace {
+auto readGz(const fs::path& file) -> std::string {
+    gzFile fp = GzUtil::openPath(file, "r");
+    std::string data;
+    char buffer[4096];
+    int n = 0;
+    while ((n = gzread(fp, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    EXPECT_EQ(0, n);
+    gzclose(fp);
+    return data;
+}
+
+auto generateXml(size_t size) -> std::string {
+    std::mt19937 gen(42);
+    std::string data;
+    while (data.size() < size) {
+        data += "<stroke tool=\"pen\" width=\"" + std::to_string(gen() % 100) + "\">" + std::to_string(gen()) +
+                "</stroke>\n";
+    }
+    data.resize(size);
+    return data;
+}
+}  // namespace
+
+TEST(UtilOutputStream, testParallelGzip) {
+    auto file = fs::path(g_get_tmp_dir()) / "xournalpp-output-stream-test.gz";
+    const std::string data = generateXml(1000000);
+
+    for (unsigned int threads: {1U, 4U}) {
+        for (int level: {0, 1, 6}) {
+            // Empty, a single block, exactly one block and the blocks of a larger document
+            for (size_t size: {size_t(0), size_t(100), size_t(128 * 1024), data.size()}) {
+                {
+                    GzOutputStream out(file, level, threads);
+                    ASSERT_TRUE(out.getLastError().empty());
+                    for (size_t pos = 0; pos < size; pos += 1000) {
+                        out.write(data.data() + pos, static_cast<unsigned int>(std::min<size_t>(1000, size - pos)));
+                    }
+                    out.close();
+                    EXPECT_TRUE(out.getLastError().empty());
+                }
+                EXPECT_EQ(data.substr(0, size), readGz(file)) << threads << " threads, level " << level;
+            }
+        }
+    }
+
+    fs::remove(file);
+}
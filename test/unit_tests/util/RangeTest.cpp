@@ -1,8 +1,12 @@
+#include <algorithm>
 #include <array>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "util/Range.h"
+#include "util/Rectangle.h"
 
 namespace {
 struct TestData {
@@ -60,3 +64,54 @@ TEST(UtilRange, testIntersect) {
     // disjoint ranges
     EXPECT_TRUE(Range(0.0, -1.0, 1.0, 2.0).intersect(Range(1.5, 3.0, 2.0, 4.0)).empty());
 }
+
+TEST(UtilRange, testCoalesce) {
+    EXPECT_TRUE(Range::coalesce({}).empty());
+    EXPECT_TRUE(Range::coalesce({Range()}).empty());
+
+    // disjoint ranges are kept
+    auto disjoint = Range::coalesce({Range(0.0, 0.0, 1.0, 1.0), Range(2.0, 0.0, 3.0, 1.0)});
+    ASSERT_EQ(disjoint.size(), 2U);
+    EXPECT_TRUE(equal(disjoint[0], Range(0.0, 0.0, 1.0, 1.0)));
+    EXPECT_TRUE(equal(disjoint[1], Range(2.0, 0.0, 3.0, 1.0)));
+
+    // subranges are absorbed
+    auto sub = Range::coalesce({Range(0.5, 0.5, 0.6, 0.6), Range(0.0, 0.0, 1.0, 1.0), Range(0.1, 0.1, 0.2, 0.2)});
+    ASSERT_EQ(sub.size(), 1U);
+    EXPECT_TRUE(equal(sub[0], Range(0.0, 0.0, 1.0, 1.0)));
+
+    // the third range bridges the first two, which did not overlap before
+    auto bridged = Range::coalesce({Range(0.0, 0.0, 1.0, 1.0), Range(2.0, 0.0, 3.0, 1.0), Range(0.5, 0.5, 2.5, 0.6),
+                                    Range(5.0, 5.0, 6.0, 6.0)});
+    ASSERT_EQ(bridged.size(), 2U);
+    EXPECT_TRUE(equal(bridged[0], Range(0.0, 0.0, 3.0, 1.0)));
+    EXPECT_TRUE(equal(bridged[1], Range(5.0, 5.0, 6.0, 6.0)));
+}
+
+TEST(UtilRange, testCoalesceMany) {
+    // Many small rectangles along a stroke, with a few rectangles far apart
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> jitter(0.0, 3.0);
+    std::vector<Range> ranges;
+    for (int i = 0; i < 5000; i++) {
+        double x = i * 0.5 + jitter(rng);
+        double y = 100.0 + jitter(rng);
+        ranges.emplace_back(x, y, x + 2.0, y + 2.0);
+        if (i % 500 == 0) {
+            ranges.emplace_back(x, 1000.0 + i, x + 1.0, 1001.0 + i);
+        }
+    }
+
+    auto result = Range::coalesce(ranges);
+    EXPECT_EQ(10, std::count_if(result.begin(), result.end(), [](const Range& r) { return r.minY >= 1000.0; }));
+    for (size_t i = 0; i < result.size(); i++) {
+        for (size_t j = i + 1; j < result.size(); j++) {
+            EXPECT_FALSE(result[i].intersect(result[j]).isValid());
+        }
+    }
+    for (const Range& rg: ranges) {
+        EXPECT_TRUE(std::any_of(result.begin(), result.end(), [&](const Range& r) {
+            return r.contains(xoj::util::Rectangle<double>(rg.minX, rg.minY, rg.getWidth(), rg.getHeight()));
+        }));
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "util/Trace.h"
+
+#include "filesystem.h"
+
+namespace trace = xoj::util::trace;
+
+namespace {
+auto readFile(const fs::path& file) -> std::string {
+    std::ifstream in(file);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+}  // namespace
+
+TEST(UtilTrace, testDisabled) {
+    EXPECT_FALSE(trace::isEnabled());
+    { XOJ_TRACE_SCOPE("disabled", "test"); }
+    EXPECT_TRUE(trace::stop());
+}
+
+TEST(UtilTrace, testChromeTrace) {
+    auto file = fs::path(g_get_tmp_dir()) / "xournalpp-trace-test.json";
+
+    trace::start(file);
+    EXPECT_TRUE(trace::isEnabled());
+    { XOJ_TRACE_SCOPE("outer", "test"); }
+    std::thread([] {
+        trace::setThreadName("Worker \"1\"");
+        trace::setThreadName("ignored");
+        XOJ_TRACE_SCOPE("inner", "test");
+    }).join();
+    EXPECT_TRUE(trace::stop());
+    EXPECT_FALSE(trace::isEnabled());
+
+    auto json = readFile(file);
+    EXPECT_EQ(0, json.rfind(R"({"displayTimeUnit":"ms","traceEvents":[)", 0));
+    EXPECT_NE(std::string::npos, json.find(R"("name":"thread_name")"));
+    EXPECT_NE(std::string::npos, json.find(R"("args":{"name":"Worker \"1\""})"));
+    EXPECT_EQ(std::string::npos, json.find("ignored"));
+    EXPECT_NE(std::string::npos, json.find(R"("name":"outer","cat":"test"})"));
+    EXPECT_NE(std::string::npos, json.find(R"("name":"inner","cat":"test"})"));
+    EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+
+    fs::remove(file);
+}
+
+TEST(UtilTrace, testFlushWhileRecording) {
+    auto file = fs::path(g_get_tmp_dir()) / "xournalpp-trace-flush-test.json";
+
+    trace::start(file);
+    for (size_t i = 0; i < trace::FLUSH_EVENTS; i++) {
+        trace::record("flushed", "test", 0, 1);
+    }
+    trace::record("buffered", "test", 0, 1);
+
+    auto json = readFile(file);
+    EXPECT_NE(std::string::npos, json.find(R"("name":"flushed","cat":"test"})"));
+    EXPECT_EQ(std::string::npos, json.find("buffered"));
+
+    EXPECT_TRUE(trace::stop());
+    json = readFile(file);
+    EXPECT_NE(std::string::npos, json.find(R"("name":"buffered","cat":"test"})"));
+    EXPECT_EQ(std::string::npos, json.find("}{"));
+    EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+
+    fs::remove(file);
+}
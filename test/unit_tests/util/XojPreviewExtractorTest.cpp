@@ -12,11 +12,14 @@
 #include <cstdlib>
 #include <ctime>
 
+#include <glib.h>
 #include <gtest/gtest.h>
 
+#include "util/OutputStream.h"
 #include "util/XojPreviewExtractor.h"
 
 #include "config-test.h"
+#include "filesystem.h"
 
 
 using namespace std;
@@ -104,3 +107,30 @@ TEST(UtilXojPreviewExtractor, testInvalidFile) {
 
     EXPECT_EQ(PREVIEW_RESULT_ERROR_READING_PREVIEW, result);
 }
+
+TEST(UtilXojPreviewExtractor, testGzipHeaderPreview) {
+    auto file = fs::path(g_get_tmp_dir()) / "xournalpp-preview-test.xopp";
+    const string png = "\x89PNG header preview";
+    // The preview in the XML is not read if the header contains one
+    const string xml = "<?xml version=\"1.0\"?>\n<xournal><preview>invalid</preview><page>";
+
+    for (unsigned int threads: {1U, 4U}) {
+        {
+            GzOutputStream out(file, Z_DEFAULT_COMPRESSION, threads, XojPreviewExtractor::makeGzipExtraField(png));
+            out.write(xml.c_str(), static_cast<unsigned int>(xml.size()));
+            out.close();
+        }
+
+        XojPreviewExtractor extractor;
+        EXPECT_EQ(PREVIEW_RESULT_IMAGE_READ, extractor.readFile(file));
+
+        gsize dataLen = 0;
+        unsigned char* imageData = extractor.getData(dataLen);
+        EXPECT_EQ(png, string((char*)imageData, (size_t)dataLen));
+    }
+
+    // Too large for the extra field, only the preview in the XML is saved
+    EXPECT_TRUE(XojPreviewExtractor::makeGzipExtraField(string(70000, 'x')).empty());
+
+    fs::remove(file);
+}
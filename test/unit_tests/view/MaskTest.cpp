@@ -0,0 +1,67 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "util/Range.h"
+#include "util/raii/CairoWrappers.h"
+#include "view/Mask.h"
+
+using xoj::view::Mask;
+
+namespace {
+auto alphaAt(cairo_surface_t* surf, int x, int y) -> uint8_t {
+    cairo_surface_flush(surf);
+    const unsigned char* data = cairo_image_surface_get_data(surf);
+    const int stride = cairo_image_surface_get_stride(surf);
+    return reinterpret_cast<const uint32_t*>(data + y * stride)[x] >> 24;
+}
+}  // namespace
+
+TEST(ViewMask, testIsCompatible) {
+    xoj::util::CairoSurfaceSPtr target(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 10, 10), xoj::util::adopt);
+    Mask mask(target.get(), Range(0, 0, 100, 50), 2.0);
+
+    EXPECT_TRUE(mask.isCompatible(target.get(), Range(0, 0, 100, 50), 2.0));
+    EXPECT_TRUE(mask.isCompatible(target.get(), Range(10, 10, 90, 40), 2.0));
+    EXPECT_FALSE(mask.isCompatible(target.get(), Range(10, 10, 110, 40), 2.0));
+    EXPECT_FALSE(mask.isCompatible(target.get(), Range(-1, 10, 90, 40), 2.0));
+    EXPECT_FALSE(mask.isCompatible(target.get(), Range(10, 10, 90, 40), 1.0));
+    EXPECT_FALSE(mask.isCompatible(target.get(), Range(10, 10, 90, 40), 2.0, CAIRO_CONTENT_COLOR_ALPHA));
+    EXPECT_FALSE(mask.isCompatible(target.get(), Range(), 2.0));
+
+    mask.reset();
+    EXPECT_FALSE(mask.isCompatible(target.get(), Range(10, 10, 90, 40), 2.0));
+}
+
+TEST(ViewMask, testBlitArea) {
+    xoj::util::CairoSurfaceSPtr target(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 100, 100), xoj::util::adopt);
+    Mask mask(target.get(), Range(0, 0, 100, 100), 1.0);
+    cairo_set_source_rgba(mask.get(), 1, 1, 1, 1);
+    cairo_paint(mask.get());
+
+    xoj::util::CairoSPtr cr(cairo_create(target.get()), xoj::util::adopt);
+    cairo_set_source_rgba(cr.get(), 0, 0, 0, 1);
+    mask.blitTo(cr.get(), Range(10.5, 20, 30, 40));
+
+    EXPECT_EQ(255, alphaAt(target.get(), 10, 20));
+    EXPECT_EQ(255, alphaAt(target.get(), 29, 39));
+    EXPECT_EQ(0, alphaAt(target.get(), 9, 20));
+    EXPECT_EQ(0, alphaAt(target.get(), 30, 20));
+    EXPECT_EQ(0, alphaAt(target.get(), 10, 40));
+
+    // Nothing is blitted for an empty area
+    mask.blitTo(cr.get(), Range());
+    EXPECT_EQ(0, alphaAt(target.get(), 50, 50));
+}